@@ -0,0 +1,100 @@
+// -*- coding: utf-8 -*-
+#ifndef _P4GPU_P4GPUSIMD_H_
+#define _P4GPU_P4GPUSIMD_H_
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+#include "arcane/utils/ArcaneGlobal.h"
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+using namespace Arcane;
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+// std::experimental::simd n'est pas utilisable avec nvcc/hipcc
+#if !defined(__CUDACC__) && !defined(__HIPCC__) && defined(__has_include)
+#if __has_include(<experimental/simd>)
+#define P4GPU_HAS_STD_SIMD
+#endif
+#endif
+
+#ifdef P4GPU_HAS_STD_SIMD
+#include <experimental/simd>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief Paquet de Real traités simultanément par les instructions SIMD
+ *
+ * std::experimental::native_simd<Real> si disponible (largeur des registres
+ * de la cible : 8 Real en AVX-512), sinon repli scalaire sur un tableau de
+ * taille fixe que le compilateur peut vectoriser.
+ * Seules les opérations utiles aux noyaux du code sont fournies :
+ * chargement/rangement contigus, +, -, * et produit par un scalaire.
+ */
+#ifdef P4GPU_HAS_STD_SIMD
+
+using SimdReal = std::experimental::native_simd<Real>;
+
+inline SimdReal simdLoad(const Real* ptr) {
+  return SimdReal(ptr, std::experimental::element_aligned);
+}
+
+inline void simdStore(const SimdReal& v, Real* ptr) {
+  v.copy_to(ptr, std::experimental::element_aligned);
+}
+
+#else
+
+class SimdReal {
+ public:
+  static constexpr Integer N = 4;
+
+  SimdReal() = default;
+  SimdReal(Real v) {
+    for(Integer i=0 ; i<N ; ++i) m_v[i] = v;
+  }
+
+  static constexpr std::size_t size() { return N; }
+
+  Real operator[](Integer i) const { return m_v[i]; }
+  Real& operator[](Integer i) { return m_v[i]; }
+
+  friend SimdReal operator+(const SimdReal& a, const SimdReal& b) {
+    SimdReal r;
+    for(Integer i=0 ; i<N ; ++i) r.m_v[i] = a.m_v[i]+b.m_v[i];
+    return r;
+  }
+  friend SimdReal operator-(const SimdReal& a, const SimdReal& b) {
+    SimdReal r;
+    for(Integer i=0 ; i<N ; ++i) r.m_v[i] = a.m_v[i]-b.m_v[i];
+    return r;
+  }
+  friend SimdReal operator*(const SimdReal& a, const SimdReal& b) {
+    SimdReal r;
+    for(Integer i=0 ; i<N ; ++i) r.m_v[i] = a.m_v[i]*b.m_v[i];
+    return r;
+  }
+
+ protected:
+  Real m_v[N];
+};
+
+inline SimdReal simdLoad(const Real* ptr) {
+  SimdReal r;
+  for(Integer i=0 ; i<SimdReal::N ; ++i) r[i] = ptr[i];
+  return r;
+}
+
+inline void simdStore(const SimdReal& v, Real* ptr) {
+  for(Integer i=0 ; i<SimdReal::N ; ++i) ptr[i] = v[i];
+}
+
+#endif
+
+//! Nombre de Real d'un SimdReal
+constexpr Integer simdRealSize() { return Integer(SimdReal::size()); }
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+#endif
@@ -51,6 +51,9 @@ Pattern4GPUModule::
   }
 
   delete m_buf_addr_mng;
+  for(auto block_node_gather : m_block_node_gather) {
+    delete block_node_gather;
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -67,6 +70,20 @@ accBuild()
   PROF_ACC_END;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Repartitionnement hétérogène (heterog-partition = cost_model), à appeler  */
+/* avant GeomEnv.InitGeomEnv pour que les environnements soient construits   */
+/* sur le maillage repartitionné                                             */
+/*---------------------------------------------------------------------------*/
+
+void Pattern4GPUModule::
+heterogPartition()
+{
+  PROF_ACC_BEGIN(__FUNCTION__);
+  m_acc_env->heterogPartition(mesh());
+  PROF_ACC_END;
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -213,6 +230,11 @@ initTensor()
       };
     }
   }
+
+  // UpdateTensor travaillera ensuite sur les 6 composantes symétriques
+  if (options()->getTensorStorage() == TS_sym) {
+    _packTensorSym();
+  }
   PROF_ACC_END;
 }
 
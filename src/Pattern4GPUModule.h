@@ -43,6 +43,7 @@ class Pattern4GPUModule
   void accBuild() override; // AccBuild
 
   //! points d'entrée "init"
+  void heterogPartition() override; // HeterogPartition
   void initP4GPU() override; // InitP4GPU
   void initTensor() override; // InitTensor
   void initNodeVector() override; // InitNodeVector
@@ -83,15 +84,19 @@ class Pattern4GPUModule
   void partialAndMean() override; // PartialAndMean
   void partialAndMean4() override; // PartialAndMean4
 
+  void updateEnvComposition() override; // UpdateEnvComposition
+
  public:
   // Implémentations des points d'entrées, devrait être private mais 
   // impossible car toute méthode déportée sur GPU doit être publique !
   void _computeCqsAndVector_Vori();
   void _computeCqsAndVector_Vmt();
   void _computeCqsAndVector_Vmt_v2();
+  void _computeCqsAndVector_Vmt_simd();
   void _computeCqsAndVector_Varcgpu_v1();
   void _computeCqsAndVector_Varcgpu_v2();  // Arcane GPU optimisé par GG
   void _computeCqsAndVector_Varcgpu_v5();  // Arcane GPU optimisé par GG
+  void _computeCqsAndVector_Varcgpu_fused();  // sans tableau intermédiaire des CQS
   void _computeCqsAndVector_Vkokkos();
   void _dumpNumArrayCqs();
 
@@ -114,6 +119,16 @@ class Pattern4GPUModule
 
   void _updateTensor3D_arcgpu_v3b();
 
+  // Pour le stockage symétrique du tenseur
+  void _packTensorSym();
+  void _unpackTensorSym();
+  void _updateTensorSym_mt();
+  void _updateTensorSym_arcgpu();
+
+  // Pour UpdateVectorFromTensor par bloc
+  void _updateBlockNodeGather();
+  void _checkUpdateVectorFromTensorOri(ConstArrayView<Real3> prev_node_vector);
+
  private:
 
   void _updateVariable(const MaterialVariableCellReal& volume, MaterialVariableCellReal& f);
@@ -131,6 +146,9 @@ class Pattern4GPUModule
   // Ecriture m_menv_var1 dans m_menv_var1_visu pour visualisation
   void _dumpVisuMEnvVar();
 
+  // Synchronisation des variables initialisées par InitMEnvVar
+  void _syncMEnvVar(bool with_node_vector);
+
  private:
 
   IMeshMaterialMng* m_mesh_material_mng;
@@ -157,6 +175,9 @@ class Pattern4GPUModule
   // Encapsulation pour Kokkos
   KokkosWrapper* m_kokkos_wrapper;
 
+  // Pour UpdateVectorFromTensor, table noeud->(maille, coin) de chaque bloc
+  UniqueArray<NodeGatherEngine*> m_block_node_gather;
+
   // TEST, pour amortir cout des allocs pour GPU
   BufAddrMng* m_buf_addr_mng=nullptr;
 };
@@ -2,6 +2,7 @@
 
 #include <arcane/materials/ComponentPartItemVectorView.h>
 #include <arcane/materials/MeshMaterialVariableSynchronizerList.h>
+#include <arcane/materials/MeshMaterialModifier.h>
 #include <arcane/AcceleratorRuntimeInitialisationInfo.h>
 
 using namespace Arcane;
@@ -35,6 +36,56 @@ _dumpVisuMEnvVar() {
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/* Synchronisation des variables multi-env et globales de InitMEnvVar        */
+/* list    : une seule liste, un seul échange                                */
+/* per_var : un synchronize par variable, comme des appels successifs        */
+/* batch   : mêmes appels successifs mais différés, un seul échange au flush */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_syncMEnvVar(bool with_node_vector) {
+  VarSyncMng* vsync = m_acc_env->vsyncMng();
+  auto ref_queue = m_acc_env->refQueueAsync();
+
+  if (options()->getInitMenvVarSync() == IMVS_list) 
+  {
+    MeshVariableSynchronizerList mvsl(vsync);
+    mvsl.add(m_menv_var1);
+    mvsl.add(m_menv_iv1);
+    mvsl.add(m_menv_var2);
+    mvsl.add(m_tensor);
+    if (with_node_vector) {
+      mvsl.add(m_node_vector); // grandeur globale
+    }
+    mvsl.add(m_menv_var3);
+    vsync->synchronize(mvsl, ref_queue);
+  }
+  else
+  {
+    bool is_batch = (options()->getInitMenvVarSync() == IMVS_batch);
+    // Synchro (ou mise en attente) d'une seule variable
+    auto sync_var = [&](auto var) {
+      MeshVariableSynchronizerList mvsl(vsync);
+      mvsl.add(var);
+      if (is_batch) {
+        vsync->enqueueSynchronize(mvsl);
+      } else {
+        vsync->synchronize(mvsl, ref_queue);
+      }
+    };
+    sync_var(m_menv_var1);
+    sync_var(m_menv_iv1);
+    sync_var(m_menv_var2);
+    sync_var(m_tensor);
+    if (with_node_vector) {
+      sync_var(m_node_vector); // grandeur globale
+    }
+    sync_var(m_menv_var3);
+    // partialAndMean lit les mailles fantômes : le lot part ici
+    vsync->flush(ref_queue);
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 /* Initialisation des variables multi-envrionnement                          */
 /*---------------------------------------------------------------------------*/
@@ -83,15 +134,7 @@ initMEnvVar() {
       m_acc_env->vsyncMng()->multiMatSynchronize(m_menv_var2, ref_queue);
       m_acc_env->vsyncMng()->multiMatSynchronize(m_menv_var3, ref_queue);
 #else
-      MeshVariableSynchronizerList mvsl(m_acc_env->vsyncMng());
-      mvsl.add(m_menv_var1);
-      mvsl.add(m_menv_iv1);
-      mvsl.add(m_menv_var2);
-      mvsl.add(m_tensor);
-      mvsl.add(m_node_vector); // grandeur globale
-      mvsl.add(m_menv_var3);
-      auto ref_queue = m_acc_env->refQueueAsync();
-      m_acc_env->vsyncMng()->synchronize(mvsl, ref_queue);
+      _syncMEnvVar(/*with_node_vector=*/true);
 #endif
     }
   }
@@ -121,11 +164,13 @@ initMEnvVar() {
 
     // Les calculs des mailles mixtes par environnement sont indépendants
     auto menv_queue = m_acc_env->multiEnvQueue();
-    ENUMERATE_ENV(ienv,m_mesh_material_mng){
-      IMeshEnvironment* env = *ienv;
+    // Les tranches d'environnements les plus coûteuses sont lancées en premier, sur les queues les moins chargées
+    MultiEnvQueueSchedule menv_sched(menv_queue, m_mesh_material_mng);
+    for(Integer i=0 ; i<menv_sched.nbLaunch() ; ++i) {
+      IMeshEnvironment* env = menv_sched.env(i);
       Integer env_id = env->id();
 
-      auto command = makeCommand(menv_queue->queue(env->id()));
+      auto command = makeCommand(menv_sched.queue(i));
 
       auto in_menv_var2_g = ax::viewIn(command, m_menv_var2.globalVariable());
       auto in_menv_var3_g = ax::viewIn(command, m_menv_var3.globalVariable());
@@ -138,8 +183,8 @@ initMEnvVar() {
       Span<Real>          out_menv_var3 (envView(m_menv_var3, env));
       Span<Integer>       out_menv_iv1  (envView(m_menv_iv1 , env));
 
-      // Pour les mailles impures (mixtes), liste des indices valides
-      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      // Pour les mailles impures (mixtes) de la tranche, liste des indices valides
+      Span<const Int32> in_imp_idx(menv_sched.impureValueIndexes(i));
       Integer nb_imp = in_imp_idx.size();
 
       command << RUNCOMMAND_LOOP1(iter, nb_imp) {
@@ -155,14 +200,7 @@ initMEnvVar() {
     }
     menv_queue->waitAllQueues();
 
-    MeshVariableSynchronizerList mvsl(m_acc_env->vsyncMng());
-    mvsl.add(m_menv_var1);
-    mvsl.add(m_menv_iv1);
-    mvsl.add(m_menv_var2);
-    mvsl.add(m_tensor);
-    mvsl.add(m_menv_var3);
-    auto ref_queue = m_acc_env->refQueueAsync();
-    m_acc_env->vsyncMng()->synchronize(mvsl, ref_queue);
+    _syncMEnvVar(/*with_node_vector=*/false);
   }
 
   // Sortie des variables multi-environnement pour la visu
@@ -214,18 +252,20 @@ partialImpureOnly() {
   {
     // Les calculs des mailles mixtes par environnement sont indépendants
     auto menv_queue = m_acc_env->multiEnvQueue();
-    ENUMERATE_ENV(ienv,m_mesh_material_mng){
-      IMeshEnvironment* env = *ienv;
+    // Les tranches d'environnements les plus coûteuses sont lancées en premier, sur les queues les moins chargées
+    MultiEnvQueueSchedule menv_sched(menv_queue, m_mesh_material_mng);
+    for(Integer i=0 ; i<menv_sched.nbLaunch() ; ++i) {
+      IMeshEnvironment* env = menv_sched.env(i);
 
-      auto command = makeCommand(menv_queue->queue(env->id()));
+      auto command = makeCommand(menv_sched.queue(i));
 
       auto in_menv_var1_g = ax::viewIn(command, m_menv_var1.globalVariable());
       Span<const Real>    in_frac_vol   (envView(m_frac_vol , env));
       Span<const Integer> in_global_cell(envView(m_global_cell, env));
       Span<Real>          out_menv_var1 (envView(m_menv_var1, env));
 
-      // Pour les mailles impures (mixtes), liste des indices valides
-      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      // Pour les mailles impures (mixtes) de la tranche, liste des indices valides
+      Span<const Int32> in_imp_idx(menv_sched.impureValueIndexes(i));
       Integer nb_imp = in_imp_idx.size();
 
       command << RUNCOMMAND_LOOP1(iter, nb_imp) {
@@ -244,6 +284,87 @@ partialImpureOnly() {
   PROF_ACC_END;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Change la composition en environnements d'une partie des mailles puis     */
+/* met à jour de façon incrémentale les données multi-env pour accélérateur  */
+/*                                                                           */
+/* A chaque cycle, une maille sur env-change-period (selon son uniqueId, la  */
+/* sélection est donc la même pour les mailles fantômes) se voit ajouter le  */
+/* 1er environnement, ou le retirer si elle en a d'autres                    */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+updateEnvComposition() {
+  PROF_ACC_BEGIN(__FUNCTION__);
+
+  Integer period = std::max(options()->getEnvChangePeriod(), 1);
+  Int64 cycle = m_global_iteration();
+  IMeshEnvironment* env0 = m_mesh_material_mng->environments()[0];
+  // Hypothèse : un SEUL matériau par environnement
+  IMeshMaterial* mat0 = env0->materials()[0];
+
+  Int32UniqueArray added_lids, removed_lids;
+  {
+    CellToAllEnvCellConverter& allenvcell_converter=*m_allenvcell_converter;
+    ENUMERATE_CELL(icell, allCells()) {
+      if ((icell->uniqueId().asInt64()+cycle)%period != 0) {
+        continue;
+      }
+      AllEnvCell all_env_cell = allenvcell_converter[*icell];
+      bool has_env0 = false;
+      ENUMERATE_CELL_ENVCELL(ienvcell, all_env_cell) {
+        has_env0 = has_env0 || ((*ienvcell).environmentId()==env0->id());
+      }
+      if (!has_env0) {
+        added_lids.add(icell.localId());
+      } else if (all_env_cell.nbEnvironment()>1) {
+        removed_lids.add(icell.localId());
+      }
+    }
+  }
+
+  MeshMaterialModifier modifier(m_mesh_material_mng);
+  if (!added_lids.empty()) {
+    modifier.addCells(mat0, added_lids);
+  }
+  if (!removed_lids.empty()) {
+    modifier.removeCells(mat0, removed_lids);
+  }
+  modifier.endUpdate();
+
+  // Le convertisseur dépend de la composition des environnements
+  delete m_allenvcell_converter;
+  m_allenvcell_converter=new CellToAllEnvCellConverter(m_mesh_material_mng);
+
+  // Valeurs partielles des mailles modifiées cohérentes avec les grandeurs globales
+  Int32UniqueArray changed_lids(added_lids);
+  changed_lids.addRange(removed_lids);
+  CellToAllEnvCellConverter& allenvcell_converter=*m_allenvcell_converter;
+  ENUMERATE_CELL(icell, mesh()->cellFamily()->view(changed_lids)) {
+    Cell cell = * icell;
+    AllEnvCell all_env_cell = allenvcell_converter[cell];
+    if (all_env_cell.nbEnvironment() !=1) { // uniquement mailles mixtes
+      Real frac = 1./all_env_cell.nbEnvironment();
+      ENUMERATE_CELL_ENVCELL(ienvcell,all_env_cell) {
+        EnvCell ev = *ienvcell;
+        m_frac_vol[ev] = frac;
+        m_menv_var1[ev] = 0.;
+        m_menv_var2[ev] = frac * m_menv_var2[cell];
+        m_menv_var3[ev] = frac * m_menv_var3[cell];
+      }
+    } else {
+      m_frac_vol[cell] = 1.;
+    }
+  }
+
+  // Seules les mailles changed_lids sont à reprendre dans le stockage multi-env
+  m_acc_env->updateMultiEnv(m_mesh_material_mng, changed_lids);
+
+  debug() << "updateEnvComposition : " << added_lids.size() << " mailles ajoutees a " << env0->name()
+    << ", " << removed_lids.size() << " retirees";
+
+  PROF_ACC_END;
+}
+
 /*---------------------------------------------------------------------------*/
 /*                               PATTERN 2                                   */
 /*---------------------------------------------------------------------------*/
@@ -367,14 +488,16 @@ partialOnly() {
     // On traite en concurrence les mailles mixtes des environnements, 
     // chaque environnement étant calculé en parallèle
     auto menv_queue = m_acc_env->multiEnvQueue();
-    ENUMERATE_ENV(ienv, m_mesh_material_mng) {
-      IMeshEnvironment* env = *ienv;
+    // Les tranches d'environnements les plus coûteuses sont lancées en premier, sur les queues les moins chargées
+    MultiEnvQueueSchedule menv_sched(menv_queue, m_mesh_material_mng);
+    for(Integer i=0 ; i<menv_sched.nbLaunch() ; ++i) {
+      IMeshEnvironment* env = menv_sched.env(i);
 
       // Mailles mixtes
-      auto command = makeCommand(menv_queue->queue(env->id()));
+      auto command = makeCommand(menv_sched.queue(i));
 
-      // Pour les mailles impures (mixtes), liste des indices valides
-      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      // Pour les mailles impures (mixtes) de la tranche, liste des indices valides
+      Span<const Int32> in_imp_idx(menv_sched.impureValueIndexes(i));
       Integer nb_imp = in_imp_idx.size();
 
       // suffixe _i = _impure
@@ -644,6 +767,8 @@ partialAndMean() {
         options()->getPmeanVar1SyncVersion());
 #else
     MeshVariableSynchronizerList mvsl(m_acc_env->vsyncMng());
+    // Seules les ownCells sont calculées : pmean-var1-ghost-depth couches suffisent au benchmark
+    mvsl.setGhostDepth(options()->getPmeanVar1GhostDepth());
     mvsl.add(m_menv_var1);
 //    mvsl.add(m_menv_var2);
 //    mvsl.add(m_menv_var3);
@@ -1,6 +1,13 @@
 #ifndef PATTERN_4_GPU_OPTIONS_H
 #define PATTERN_4_GPU_OPTIONS_H
 
+/*! \brief Définit le stockage du tenseur
+ */
+enum eTensorStorage {
+  TS_full = 0, //! Real3x3 complet
+  TS_sym //! 6 composantes : diagonale (xx,yy,zz) et hors diagonale (xy,xz,yz)
+};
+
 /*! \brief Définit les implémentations de InitTensor
  */
 enum eInitTensorVersion {
@@ -53,7 +60,8 @@ enum eInitCellArr12Version {
  */
 enum eUpdateVectorFromTensorVersion {
   UVTV_ori = 0, //! Version CPU d'origine
-  UVTV_mt //! Implémentation CPU multi-thread
+  UVTV_mt, //! Implémentation CPU multi-thread, gather par bloc (mêmes résultats que ori)
+  UVTV_arcgpu //! Implémentation API GPU Arcane, gather par bloc
 };
 
 /*! \brief Définit les implémentations de UpdateTensor
@@ -65,7 +73,9 @@ enum eUpdateTensorVersion {
   UVV_arcgpu_v1, //! Implémentation API GPU Arcane version 1
   UVV_arcgpu_v2a, //! Implémentation API GPU Arcane correspondant à ori_v2 avec tableau intermédiaire
   UVV_arcgpu_v2b, //! Implémentation API GPU Arcane correspondant à ori_v2 sans tableau intermédiaire
-  UVV_arcgpu_v3b  //! Implémentation API GPU Arcane correspondant à ori_v3 sans tableau intermédiaire
+  UVV_arcgpu_v3b,  //! Implémentation API GPU Arcane correspondant à ori_v3 sans tableau intermédiaire
+  UVV_sym_mt,  //! Implémentation CPU multi-thread correspondant à ori_v3 sur le stockage symétrique
+  UVV_sym_arcgpu  //! Implémentation API GPU Arcane correspondant à ori_v3 sur le stockage symétrique
 };
 
 /*! \brief Définit les implémentations de ComputeCqsAndVector
@@ -74,9 +84,11 @@ enum eComputeCqsVectorVersion {
   CCVV_ori = 0, //! Version CPU d'origine
   CCVV_mt, //! Implémentation CPU Arcane multi-thread
   CCVV_mt_v2, //! Implémentation CPU Arcane multi-thread version 2
+  CCVV_mt_simd, //! Implémentation CPU Arcane multi-thread, CQs calculées en SIMD par paquets de mailles
   CCVV_arcgpu_v1, //! Implémentation API GPU Arcane version 1
   CCVV_arcgpu_v2, //! Implémentation API GPU Arcane version 2 (avec NumArray pour CQS)
   CCVV_arcgpu_v5, //! Implémentation API GPU Arcane version 5 (GG)
+  CCVV_arcgpu_fused, //! Implémentation API GPU Arcane, CQS recalculées par noeud sans tableau intermédiaire
   CCVV_kokkos //! Implémentation Kokkos
 };
 
@@ -87,6 +99,14 @@ enum eInitMEnvVar {
   IMVV_arcgpu_v1 //! Implémentation API GPU Arcane version 1
 };
 
+/*! \brief Définit la manière de synchroniser les variables de InitMEnvVar
+ */
+enum eInitMEnvVarSync {
+  IMVS_list = 0, //! Un seul synchronize sur la liste de toutes les variables
+  IMVS_per_var,  //! Un synchronize par variable (un échange par variable)
+  IMVS_batch     //! Une synchro différée par variable puis un seul échange au flush
+};
+
 /*! \brief Définit les implémentations de PartialImpureOnly
  */
 enum ePartialImpureOnlyVersion {
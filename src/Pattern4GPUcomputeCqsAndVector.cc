@@ -1,7 +1,13 @@
 #include "Pattern4GPUModule.h"
 
+#include <arcane/ISubDomain.h>
+#include <arcane/ITimeLoopMng.h>
+#include <arcane/ITimeLoop.h>
+#include <arcane/TimeLoopEntryPointInfo.h>
+
 #define P4GPU_PROFILING // Pour activer le profiling
 #include "P4GPUTimer.h"
+#include "P4GPUSimd.h"
 
 #include "Pattern4GPU4Kokkos.h"
 
@@ -91,22 +97,17 @@ _computeCqsAndVector_Vmt() {
     }
   });
 
-  auto node_index_in_cells = m_acc_env->nodeIndexInCells();
-  const Integer max_node_cell = m_acc_env->maxNodeCell();
+  auto node_gather = m_acc_env->nodeGather();
 
   // Puis, on applique les CQs sur les noeuds
   arcaneParallelForeach(allNodes(), options, [&](NodeVectorView nodes) {
     ENUMERATE_NODE (node_i, nodes) {
-      Int32 first_pos = node_i.localId() * max_node_cell;
-      Real3 node_vec = Real3::zero();
-      ENUMERATE_CELL(cell_i, node_i->cells()) {
-        if (m_is_active_cell[cell_i]) { // la maille ne contribue que si elle est active
-          Int16 node_index = node_index_in_cells[first_pos + cell_i.index()];
-          node_vec += (m_cell_arr1[cell_i]+m_cell_arr2[cell_i])
-            * m_cell_cqs[cell_i][node_index];
-        }
-      }
-      m_node_vector[node_i] = node_vec;
+      m_node_vector[node_i] = node_gather.gather(NodeLocalId(node_i.localId()), Real3::zero(),
+          [&](CellLocalId cid, Int16 node_index) {
+            // la maille ne contribue que si elle est active
+            return (m_is_active_cell[cid] ?
+                (m_cell_arr1[cid]+m_cell_arr2[cid]) * m_cell_cqs[cid][node_index] : Real3::zero());
+          });
     }
   });
 
@@ -173,6 +174,107 @@ _computeCqsAndVector_Vmt_v2() {
   PROF_ACC_END;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Implémentation CPU multi-thread avec calcul SIMD des CQs                  */
+/* Les coordonnées d'un paquet de simdRealSize() mailles sont rassemblées    */
+/* en SoA, les 8 CQs sont calculées pour tout le paquet puis dispersées      */
+/* dans m_cell_cqs                                                           */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_computeCqsAndVector_Vmt_simd() {
+
+  PROF_ACC_BEGIN(__FUNCTION__);
+  debug() << "Dans _computeCqsAndVector_Vmt_simd";
+
+  ParallelLoopOptions options;
+
+  // On calcule les CQs sur les mailles
+  options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
+  arcaneParallelForeach(allCells(), options, [&](CellVectorView cells) {
+    constexpr Integer W = simdRealSize();
+    // Pour le noeud n de la CQS n : -0.25*vecMul(p[i0]-p[i1], p[i2]-p[i3])
+    constexpr Integer ipos[8][4] = {
+      {4, 3, 1, 3},
+      {0, 2, 5, 2},
+      {1, 3, 6, 3},
+      {7, 2, 0, 2},
+      {5, 7, 0, 7},
+      {1, 6, 4, 6},
+      {5, 2, 7, 2},
+      {6, 3, 4, 3}
+    };
+    const SimdReal mk025(-0.25);
+
+    // Coordonnées du paquet en SoA : [noeud][maille du paquet]
+    alignas(64) Real px[8][W], py[8][W], pz[8][W];
+    alignas(64) Real cx[W], cy[W], cz[W];
+    Int32 batch_lids[W];
+    Integer nb_in_batch = 0;
+
+    auto compute_batch = [&]() {
+      // Les voies inutilisées recopient la dernière maille (résultat ignoré)
+      for(Integer l=nb_in_batch ; l<W ; ++l) {
+        for(Integer n=0 ; n<8 ; ++n) {
+          px[n][l] = px[n][nb_in_batch-1];
+          py[n][l] = py[n][nb_in_batch-1];
+          pz[n][l] = pz[n][nb_in_batch-1];
+        }
+      }
+      SimdReal x[8], y[8], z[8];
+      for(Integer n=0 ; n<8 ; ++n) {
+        x[n] = simdLoad(px[n]);
+        y[n] = simdLoad(py[n]);
+        z[n] = simdLoad(pz[n]);
+      }
+      for(Integer n=0 ; n<8 ; ++n) {
+        const Integer i0 = ipos[n][0], i1 = ipos[n][1], i2 = ipos[n][2], i3 = ipos[n][3];
+        SimdReal ax = x[i0]-x[i1], ay = y[i0]-y[i1], az = z[i0]-z[i1];
+        SimdReal bx = x[i2]-x[i3], by = y[i2]-y[i3], bz = z[i2]-z[i3];
+        simdStore(mk025*(ay*bz-az*by), cx);
+        simdStore(mk025*(az*bx-ax*bz), cy);
+        simdStore(mk025*(ax*by-ay*bx), cz);
+        for(Integer l=0 ; l<nb_in_batch ; ++l) {
+          m_cell_cqs[CellLocalId(batch_lids[l])][n] = Real3(cx[l], cy[l], cz[l]);
+        }
+      }
+      nb_in_batch = 0;
+    };
+
+    ENUMERATE_CELL (cell_i, cells) {
+      Integer l = nb_in_batch;
+      batch_lids[l] = cell_i.localId();
+      for (Integer ii = 0; ii < 8; ++ii) {
+        const Real3 pos = m_node_coord_bis[cell_i->node(ii)];
+        px[ii][l] = pos.x;
+        py[ii][l] = pos.y;
+        pz[ii][l] = pos.z;
+      }
+      if (++nb_in_batch == W) {
+        compute_batch();
+      }
+    }
+    if (nb_in_batch > 0) {
+      compute_batch();
+    }
+  });
+
+  auto node_gather = m_acc_env->nodeGather();
+
+  // Puis, on applique les CQs sur les noeuds
+  arcaneParallelForeach(allNodes(), options, [&](NodeVectorView nodes) {
+    ENUMERATE_NODE (node_i, nodes) {
+      m_node_vector[node_i] = node_gather.gather(NodeLocalId(node_i.localId()), Real3::zero(),
+          [&](CellLocalId cid, Int16 node_index) {
+            // la maille ne contribue que si elle est active
+            return (m_is_active_cell[cid] ?
+                (m_cell_arr1[cid]+m_cell_arr2[cid]) * m_cell_cqs[cid][node_index] : Real3::zero());
+          });
+    }
+  });
+
+  PROF_ACC_END;
+}
+
 /*---------------------------------------------------------------------------*/
 /* Implémentation API GPU Arcane version 1                                   */
 /*---------------------------------------------------------------------------*/
@@ -227,8 +329,15 @@ _computeCqsAndVector_Varcgpu_v1() {
     };
   };
 
+  // Le vecteur aux noeuds propres ne lit que les cqs des mailles de la 1ere
+  // couche fantôme : les couches au-delà de ccav-ghost-depth ne sont pas
+  // synchronisées (leurs cqs ne sont alors pas à jour)
+  MeshVariableSynchronizerList mvsl_coord(m_acc_env->vsyncMng());
+  mvsl_coord.setGhostDepth(options()->getCcavGhostDepth());
+  mvsl_coord.add(m_node_coord_bis, options()->getCcavCoordBufCompression());
+
   m_acc_env->vsyncMng()->syncAndCompute(
-      m_node_coord_bis, // --------------------> variable à synchroniser avant les calculs
+      mvsl_coord,       // --------------------> variable à synchroniser avant les calculs
       allCells(),       // --------------------> groupe d'items sur lequel on itère
       async_calc_cqs,   // --------------------> définition du calcul sur un CellGroup
       options()->getCcavCqsSyncVersion() // ---> choix de l'overlapping entre calcul et comms
@@ -238,6 +347,10 @@ _computeCqsAndVector_Varcgpu_v1() {
 
   P4GPU_DECLARE_TIMER(subDomain(), NodeVectorUpdate); P4GPU_START_TIMER(NodeVectorUpdate);
 
+  MeshVariableSynchronizerList mvsl_vector(m_acc_env->vsyncMng());
+  mvsl_vector.setGhostDepth(options()->getCcavGhostDepth());
+  mvsl_vector.add(m_node_vector, options()->getCcavVectorBufCompression());
+
   // On fait le calcul sur les noeuds "own" m_node_vector 
   // et on synchronise les noeuds fantômes de m_node_vector
   m_acc_env->vsyncMng()->computeAndSync(
@@ -261,27 +374,18 @@ _computeCqsAndVector_Varcgpu_v1() {
 
         auto out_node_vector = ax::viewOut(command, m_node_vector);
 
-        auto node_index_in_cells = m_acc_env->nodeIndexInCells();
-        const Integer max_node_cell = m_acc_env->maxNodeCell();
-
-        auto nc_cty = m_acc_env->connectivityView().nodeCell();
+        auto node_gather = m_acc_env->nodeGather();
 
         command << RUNCOMMAND_ENUMERATE(Node,nid,node_group) {
-          Int32 first_pos = nid.localId() * max_node_cell;
-          Integer index = 0;
-          Real3 node_vec = Real3::zero();
-          for( CellLocalId cid : nc_cty.cells(nid) ){
-            if (in_is_active_cell[cid]) { // la maille ne contribue que si elle est active
-              Int16 node_index = node_index_in_cells[first_pos + index];
-              node_vec += (in_cell_arr1[cid]+in_cell_arr2[cid]) 
-                * in_cell_cqs[cid][node_index];
-            }
-            ++index;
-          }
-          out_node_vector[nid] = node_vec;
+          out_node_vector[nid] = node_gather.gather(nid, Real3::zero(),
+              [&](CellLocalId cid, Int16 node_index) {
+                // la maille ne contribue que si elle est active
+                return (in_is_active_cell[cid] ?
+                    (in_cell_arr1[cid]+in_cell_arr2[cid]) * in_cell_cqs[cid][node_index] : Real3::zero());
+              });
         }; // non bloquant
       }, // -------------------------------------> fin définition traitement
-      m_node_vector, // -------------------------> variable à synchroniser
+      mvsl_vector, // ---------------------------> variable à synchroniser
       options()->getCcavVectorSyncVersion() // --> choix de l'overlapping entre calcul et comms
         ); 
 
@@ -350,8 +454,15 @@ _computeCqsAndVector_Varcgpu_v2()
     };
   };
 
+  // Le vecteur aux noeuds propres ne lit que les cqs des mailles de la 1ere
+  // couche fantôme : les couches au-delà de ccav-ghost-depth ne sont pas
+  // synchronisées (leurs cqs ne sont alors pas à jour)
+  MeshVariableSynchronizerList mvsl_coord(m_acc_env->vsyncMng());
+  mvsl_coord.setGhostDepth(options()->getCcavGhostDepth());
+  mvsl_coord.add(m_node_coord_bis, options()->getCcavCoordBufCompression());
+
   m_acc_env->vsyncMng()->syncAndCompute(
-      m_node_coord_bis, // --------------------> variable à synchroniser avant les calculs
+      mvsl_coord,       // --------------------> variable à synchroniser avant les calculs
       allCells(),       // --------------------> groupe d'items sur lequel on itère
       async_calc_cqs,   // --------------------> définition du calcul sur un CellGroup
       options()->getCcavCqsSyncVersion() // ---> choix de l'overlapping entre calcul et comms
@@ -381,33 +492,28 @@ _computeCqsAndVector_Varcgpu_v2()
 
     auto out_node_vector = ax::viewOut(command, m_node_vector);
 
-    auto node_index_in_cells = m_acc_env->nodeIndexInCells();
-    const Integer max_node_cell = m_acc_env->maxNodeCell();
-
-    auto nc_cty = m_acc_env->connectivityView().nodeCell();
+    auto node_gather = m_acc_env->nodeGather();
 
     command << RUNCOMMAND_ENUMERATE(Node,nid,node_group) {
-      Int32 first_pos = nid.localId() * max_node_cell;
-      Integer index = 0;
-      Real3 node_vec = Real3::zero();
-      for( CellLocalId cid : nc_cty.cells(nid) ){
-        Int32 cid_as_int = cid.localId();
-        if (in_is_active_cell[cid]) { // la maille ne contribue que si elle est active
-          Int16 node_index = node_index_in_cells[first_pos + index];
-          node_vec += (in_cell_arr1[cid]+in_cell_arr2[cid]) * in_cell_cqs(node_index,cid_as_int);
-        }
-        ++index;
-      }
-      out_node_vector[nid] = node_vec;
+      out_node_vector[nid] = node_gather.gather(nid, Real3::zero(),
+          [&](CellLocalId cid, Int16 node_index) {
+            // la maille ne contribue que si elle est active
+            return (in_is_active_cell[cid] ?
+                (in_cell_arr1[cid]+in_cell_arr2[cid]) * in_cell_cqs(node_index,cid.localId()) : Real3::zero());
+          });
     };  // non bloquant
   };
 
+  MeshVariableSynchronizerList mvsl_vector(m_acc_env->vsyncMng());
+  mvsl_vector.setGhostDepth(options()->getCcavGhostDepth());
+  mvsl_vector.add(m_node_vector, options()->getCcavVectorBufCompression());
+
   // On fait le calcul sur les noeuds "own" m_node_vector 
   // et on synchronise les noeuds fantômes de m_node_vector
   m_acc_env->vsyncMng()->computeAndSync(
       ownNodes(),
       async_node_vector_update, 
-      m_node_vector, options()->getCcavVectorSyncVersion());
+      mvsl_vector, options()->getCcavVectorSyncVersion());
 
   P4GPU_STOP_TIMER(NodeVectorUpdate);
   PROF_ACC_END;
@@ -498,6 +604,67 @@ _computeCqsAndVector_Varcgpu_v5()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/* Implémentation API GPU Arcane fusionnée : chaque noeud recalcule la CQS   */
+/* de chacune de ses mailles actives qui le concerne, aucune CQS n'est       */
+/* écrite en mémoire (m_cell_cqs et m_numarray_cqs ne sont pas mis à jour)   */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_computeCqsAndVector_Varcgpu_fused()
+{
+  PROF_ACC_BEGIN(__FUNCTION__);
+  debug() << "Dans _computeCqsAndVector_Varcgpu_fused";
+
+  auto queue = m_acc_env->newQueue();
+  const Integer nb_node = allNodes().size();
+  {
+    auto command = makeCommand(queue);
+
+    auto in_node_coord_bis = viewIn(command, m_node_coord_bis);
+    auto in_cell_arr1 = viewIn(command, m_cell_arr1);
+    auto in_cell_arr2 = viewIn(command, m_cell_arr2);
+    auto in_is_active_cell = viewIn(command, m_is_active_cell);
+
+    auto out_node_vector = ax::viewOut(command, m_node_vector);
+
+    auto node_gather = m_acc_env->nodeGather();
+
+    auto cnc = m_acc_env->connectivityView().cellNode();
+
+    command << RUNCOMMAND_LOOP1(iter,nb_node){
+      // CQS k d'une maille : -0.25*cross(p[i0]-p[i1], p[i2]-p[i3]) avec ipos[k]={i0,i1,i2,i3}
+      constexpr Int32 ipos[8][4] = {
+        {4, 3, 1, 3},
+        {0, 2, 5, 2},
+        {1, 3, 6, 3},
+        {7, 2, 0, 2},
+        {5, 7, 0, 7},
+        {1, 6, 4, 6},
+        {5, 2, 7, 2},
+        {6, 3, 4, 3}
+      };
+      constexpr Real k025 = 0.25;
+
+      auto [node_i] = iter();
+      NodeLocalId nid{(Int32)node_i};
+      out_node_vector[nid] = node_gather.gather(nid, Real3::zero(),
+          [&](CellLocalId cid, Int16 k) {
+            if (!in_is_active_cell[cid]) { // la maille ne contribue que si elle est active
+              return Real3::zero();
+            }
+            auto nodes = cnc.nodes(cid);
+            Real3 p0 = in_node_coord_bis[nodes[ipos[k][0]]];
+            Real3 p1 = in_node_coord_bis[nodes[ipos[k][1]]];
+            Real3 p2 = in_node_coord_bis[nodes[ipos[k][2]]];
+            Real3 p3 = in_node_coord_bis[nodes[ipos[k][3]]];
+            Real3 cqs = -k025 * Arcane::math::cross(p0 - p1, p2 - p3);
+            return (in_cell_arr1[cid]+in_cell_arr2[cid]) * cqs;
+          });
+    };
+  }
+  PROF_ACC_END;
+}
+
 /*---------------------------------------------------------------------------*/
 /* Implémentation Kokkos                                                     */
 /*---------------------------------------------------------------------------*/
@@ -515,6 +682,22 @@ _computeCqsAndVector_Vkokkos() {
   // m_kokkos_wrapper->syncHostData(allCells(), allNodes(), m_node_vector, m_node_coord_bis, m_cell_cqs, m_cell_arr1, m_cell_arr2);
 }
 
+/*---------------------------------------------------------------------------*/
+/* Retourne vrai si ep_name est un point d'entrée compute-loop de la boucle  */
+/* en temps courante                                                         */
+/*---------------------------------------------------------------------------*/
+static bool
+_isInComputeLoop(ISubDomain* sd, const String& ep_name) {
+  ITimeLoop* time_loop = sd->timeLoopMng()->usedTimeLoop();
+  List<TimeLoopEntryPointInfo> ep_infos = time_loop->entryPoints(ITimeLoop::WComputeLoop);
+  for( List<TimeLoopEntryPointInfo>::Enumerator i(ep_infos); ++i; ) {
+    if ((*i).name()==ep_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -523,13 +706,21 @@ computeCqsAndVector() {
 
   PROF_ACC_BEGIN(__FUNCTION__);
 
+  // arcgpu_fused ne calcule pas m_cell_cqs, UpdateVectorFromTensor lirait des CQS périmées
+  if (options()->getComputeCqsVectorVersion() == CCVV_arcgpu_fused &&
+      _isInComputeLoop(subDomain(), "Pattern4GPU.UpdateVectorFromTensor")) {
+    fatal() << "compute-cqs-vector-version arcgpu_fused n'écrit pas CellCQS, incompatible avec UpdateVectorFromTensor dans la même boucle en temps";
+  }
+
   switch (options()->getComputeCqsVectorVersion()) {
     case CCVV_ori: _computeCqsAndVector_Vori(); break;
     case CCVV_mt: _computeCqsAndVector_Vmt(); break;
     case CCVV_mt_v2: _computeCqsAndVector_Vmt_v2(); break;
+    case CCVV_mt_simd: _computeCqsAndVector_Vmt_simd(); break;
     case CCVV_arcgpu_v1: _computeCqsAndVector_Varcgpu_v1(); break;
     case CCVV_arcgpu_v2: _computeCqsAndVector_Varcgpu_v2(); break;
     case CCVV_arcgpu_v5: _computeCqsAndVector_Varcgpu_v5(); break;
+    case CCVV_arcgpu_fused: _computeCqsAndVector_Varcgpu_fused(); break;
     case CCVV_kokkos: _computeCqsAndVector_Vkokkos(); break;
     default: break;
   };
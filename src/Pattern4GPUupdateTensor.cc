@@ -533,6 +533,199 @@ _updateTensor3D_arcgpu_v3b()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/* Stockage symétrique : diag = (xx,yy,zz), offdiag = (xy,xz,yz)             */
+/*---------------------------------------------------------------------------*/
+ARCCORE_HOST_DEVICE inline Real3x3 tensorFromSym(const Real3& diag, const Real3& offdiag) {
+  return Real3x3(Real3(diag.x,    offdiag.x, offdiag.y),
+                 Real3(offdiag.x, diag.y,    offdiag.z),
+                 Real3(offdiag.y, offdiag.z, diag.z));
+}
+
+ARCCORE_HOST_DEVICE inline Real3 tensorSymDiag(const Real3x3& tens) {
+  return Real3(tens.x.x, tens.y.y, tens.z.z);
+}
+
+ARCCORE_HOST_DEVICE inline Real3 tensorSymOffDiag(const Real3x3& tens) {
+  return Real3(tens.x.y, tens.x.z, tens.y.z);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Division par le volume d'une valeur symétrique et mise à jour de zz       */
+/* (mêmes opérations que ori_v3 composante par composante)                   */
+/*---------------------------------------------------------------------------*/
+ARCCORE_HOST_DEVICE inline void divideTensorSym(Real vol, Real3& diag, Real3& offdiag) {
+  diag.x /= vol;
+  offdiag.x /= vol;
+  offdiag.y /= vol;
+
+  diag.y /= vol;
+  offdiag.z /= vol;
+
+  diag.z = -diag.x - diag.y;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Conversion Tensor -> stockage symétrique (valeurs partielles et globales) */
+/* Frontière d'entrée : appelée une fois après InitTensor                    */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_packTensorSym()
+{
+  PROF_ACC_BEGIN(__FUNCTION__);
+  auto queue = m_acc_env->newQueue();
+  {
+    auto command = makeCommand(queue);
+
+    auto in_tensor_g      = ax::viewIn (command, m_tensor.globalVariable());
+    auto out_diag_g       = ax::viewOut(command, m_tensor_sym_diag.globalVariable());
+    auto out_offdiag_g    = ax::viewOut(command, m_tensor_sym_offdiag.globalVariable());
+
+    MultiEnvVar<Real3x3> menv_tensor(m_tensor, m_mesh_material_mng);
+    auto in_tensor(menv_tensor.span());
+
+    MultiEnvVar<Real3> menv_diag(m_tensor_sym_diag, m_mesh_material_mng);
+    auto out_diag(menv_diag.span());
+
+    MultiEnvVar<Real3> menv_offdiag(m_tensor_sym_offdiag, m_mesh_material_mng);
+    auto out_offdiag(menv_offdiag.span());
+
+    // Pour décrire l'accés multi-env sur GPU
+    auto in_menv_cell(m_acc_env->multiEnvCellStorage()->viewIn(command));
+
+    command << RUNCOMMAND_ENUMERATE(Cell, cid, allCells()) {
+      // Valeurs globales (ce sont aussi les valeurs partielles des mailles pures)
+      Real3x3 tens_glob = in_tensor_g[cid];
+      out_diag_g[cid] = tensorSymDiag(tens_glob);
+      out_offdiag_g[cid] = tensorSymOffDiag(tens_glob);
+
+      if (in_menv_cell.nbEnv(cid)>1) {
+        for(Integer ienv=0 ; ienv<in_menv_cell.nbEnv(cid) ; ++ienv) {
+          auto evi = in_menv_cell.envCell(cid,ienv);
+          Real3x3 tens = in_tensor[evi];
+          out_diag.setValue(evi, tensorSymDiag(tens));
+          out_offdiag.setValue(evi, tensorSymOffDiag(tens));
+        }
+      }
+    };
+  }
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Conversion stockage symétrique -> Tensor, valeurs globales uniquement     */
+/* (seules lues par UpdateVectorFromTensor) : frontière de sortie            */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_unpackTensorSym()
+{
+  PROF_ACC_BEGIN(__FUNCTION__);
+  auto queue = m_acc_env->newQueue();
+  {
+    auto command = makeCommand(queue);
+
+    auto in_diag_g     = ax::viewIn (command, m_tensor_sym_diag.globalVariable());
+    auto in_offdiag_g  = ax::viewIn (command, m_tensor_sym_offdiag.globalVariable());
+    auto out_tensor_g  = ax::viewOut(command, m_tensor.globalVariable());
+
+    command << RUNCOMMAND_ENUMERATE(Cell, cid, allCells()) {
+      out_tensor_g[cid] = tensorFromSym(in_diag_g[cid], in_offdiag_g[cid]);
+    };
+  }
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Implem updateTensor pour sym_mt : ori_v3 en une passe multi-thread sur    */
+/* les mailles, directement sur le stockage symétrique                       */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_updateTensorSym_mt()
+{
+  ParallelLoopOptions options;
+  options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
+
+  arcaneParallelForeach(allCells(), options, [&](CellVectorView cells) {
+    CellToAllEnvCellConverter allenvcell_converter(m_mesh_material_mng);
+    ENUMERATE_CELL (cell_i, cells) {
+      AllEnvCell allenvcell = allenvcell_converter[*cell_i];
+
+      Real3 sum_diag = Real3::zero();
+      Real3 sum_offdiag = Real3::zero();
+      ENUMERATE_CELL_ENVCELL (envcell_i, allenvcell) {
+        Real3& diag = m_tensor_sym_diag[envcell_i];
+        Real3& offdiag = m_tensor_sym_offdiag[envcell_i];
+
+        sum_diag += diag;
+        sum_offdiag += offdiag;
+
+        divideTensorSym(m_volume[envcell_i], diag, offdiag);
+      }
+
+      // Valeurs moyennes uniquement sur les mailles mixtes
+      if (allenvcell.nbEnvironment() > 1) {
+        divideTensorSym(m_volume[cell_i], sum_diag, sum_offdiag);
+        m_tensor_sym_diag[cell_i] = sum_diag;
+        m_tensor_sym_offdiag[cell_i] = sum_offdiag;
+      }
+    }
+  });
+}
+
+/*---------------------------------------------------------------------------*/
+/* Implem updateTensor pour sym_arcgpu : arcgpu_v3b sur le stockage          */
+/* symétrique (48 octets par valeur au lieu de 72)                           */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_updateTensorSym_arcgpu()
+{
+  auto queue = m_acc_env->newQueue();
+  {
+    auto command = makeCommand(queue);
+
+    auto in_volume_g    = ax::viewIn (command, m_volume.globalVariable());
+    auto out_diag_g     = ax::viewOut(command, m_tensor_sym_diag.globalVariable());
+    auto out_offdiag_g  = ax::viewOut(command, m_tensor_sym_offdiag.globalVariable());
+
+    MultiEnvVar<Real> menv_volume(m_volume, m_mesh_material_mng);
+    auto in_volume(menv_volume.span());
+
+    MultiEnvVar<Real3> menv_diag(m_tensor_sym_diag, m_mesh_material_mng);
+    auto inout_diag(menv_diag.span());
+
+    MultiEnvVar<Real3> menv_offdiag(m_tensor_sym_offdiag, m_mesh_material_mng);
+    auto inout_offdiag(menv_offdiag.span());
+
+    // Pour décrire l'accés multi-env sur GPU
+    auto in_menv_cell(m_acc_env->multiEnvCellStorage()->viewIn(command));
+
+    command << RUNCOMMAND_ENUMERATE(Cell, cid, allCells()) {
+
+      Real3 sum_diag = Real3::zero();
+      Real3 sum_offdiag = Real3::zero();
+      for(Integer ienv=0 ; ienv<in_menv_cell.nbEnv(cid) ; ++ienv) {
+        auto evi = in_menv_cell.envCell(cid,ienv);
+
+        // références sur les valeurs partielles
+        Real3& diag = inout_diag.ref(evi);
+        Real3& offdiag = inout_offdiag.ref(evi);
+
+        sum_diag += diag;
+        sum_offdiag += offdiag;
+
+        divideTensorSym(in_volume[evi], diag, offdiag);
+      }
+
+      // Valeurs moyennes uniquement sur les mailles mixtes
+      if (in_menv_cell.nbEnv(cid)>1) {
+        divideTensorSym(in_volume_g[cid], sum_diag, sum_offdiag);
+        out_diag_g[cid] = sum_diag;
+        out_offdiag_g[cid] = sum_offdiag;
+      }
+    };
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -542,6 +735,14 @@ updateTensor()
   PROF_ACC_BEGIN(__FUNCTION__);
   debug() << "Dans updateTensor";
 
+  // Le stockage symétrique n'est mis à jour que par les versions sym_*
+  bool is_sym_version = (options()->getUpdateTensorVersion() == UVV_sym_mt ||
+      options()->getUpdateTensorVersion() == UVV_sym_arcgpu);
+  if (is_sym_version != (options()->getTensorStorage() == TS_sym))
+  {
+    fatal() << "update-tensor-version sym_* et tensor-storage = sym vont ensemble";
+  }
+
   if (options()->getUpdateTensorVersion() == UVV_ori)
   {
     // Remplir les variables composantes
@@ -787,6 +988,24 @@ updateTensor()
       fatal() << "UVV_arcgpu_v3b non implemente pour dim != 2";
     }
   }
+  else if (is_sym_version)
+  {
+    // Même résultats numériques que ori_v3, sans repasser par Tensor
+    if (defaultMesh()->dimension() != 3)
+    {
+      fatal() << "UVV_sym_* non implemente pour dim != 3";
+    }
+
+    if (options()->getUpdateTensorVersion() == UVV_sym_mt)
+    {
+      _updateTensorSym_mt();
+    }
+    else
+    {
+      m_acc_env->checkMultiEnvGlobalCellId(m_mesh_material_mng);
+      _updateTensorSym_arcgpu();
+    }
+  }
   
   PROF_ACC_END;
 }
@@ -14,6 +14,19 @@ updateVectorFromTensor() {
   PROF_ACC_BEGIN(__FUNCTION__);
   debug() << "Dans updateVectorFromTensor";
 
+  // Tensor n'est pas mis à jour par UpdateTensor en stockage symétrique
+  if (options()->getTensorStorage() == TS_sym) {
+    _unpackTensorSym();
+  }
+
+  // Valeurs avant maj pour comparaison avec la version ori
+  bool check_ori = (options()->getUvftCheckOri() &&
+      options()->getUpdateVectorFromTensorVersion() != UVTV_ori);
+  UniqueArray<Real3> prev_node_vector;
+  if (check_ori) {
+    prev_node_vector.copy(m_node_vector.asArray());
+  }
+
   if (options()->getUpdateVectorFromTensorVersion() == UVTV_ori)
   {
     Integer nb_blocks = m_mesh_material_mng->blocks().size();
@@ -36,38 +49,128 @@ updateVectorFromTensor() {
   }
   else if (options()->getUpdateVectorFromTensorVersion() == UVTV_mt)
   {
+    // Chaque bloc est traité par un gather sur ses seuls noeuds, à partir de
+    // ses seules mailles, dans le même ordre que le scatter de ori
+    _updateBlockNodeGather();
+
+    VariableCellReal3x3& tensor = m_tensor.globalVariable();
+
+    ParallelLoopOptions options;
+    options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
+
     Integer nb_blocks = m_mesh_material_mng->blocks().size();
 
     for (Integer i = 0; i < nb_blocks; i++) {
-      // on récupère le groupe de mailles associé au bloc
-      IMeshBlock* b = (m_mesh_material_mng->blocks())[i];
-      CellGroup cell_group = b->cells();
+      auto node_gather = m_block_node_gather[i]->view();
+      auto block_nodes = m_block_node_gather[i]->nodes();
 
-      auto node_index_in_cells = m_acc_env->nodeIndexInCells();
-      const Integer max_node_cell = m_acc_env->maxNodeCell();
-
-      ParallelLoopOptions options;
-      options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
-
-      NodeGroup node_group = allNodes(); // TODO : passer aux noeuds du blocks
-      arcaneParallelForeach(node_group, options, [&](NodeVectorView nodes) {
-      ENUMERATE_NODE (node_i, nodes) {
-        Int32 first_pos = node_i.localId() * max_node_cell;
-        ENUMERATE_CELL(cell_i, node_i->cells()) {
-          if (true) { // TODO : vrai ssi cell_i est dans cell_group
-            Int16 node_index = node_index_in_cells[first_pos + cell_i.index()];
-            const Real3x3& cell_tensor = m_tensor[cell_i];
-            m_node_vector[node_i] -= math::prodTensVec(cell_tensor,
-              m_cell_cqs[cell_i][node_index]);
-          }
+      arcaneParallelFor(0, Integer(block_nodes.size()), options, [&](Integer begin, Integer size) {
+        for (Integer inode = begin; inode < begin+size; ++inode) {
+          NodeLocalId nid(block_nodes[inode]);
+          m_node_vector[nid] = node_gather.gather(nid, m_node_vector[nid],
+              [&](CellLocalId cid, Int16 node_index) {
+                return math::prodTensVec(tensor[cid], m_cell_cqs[cid][node_index]);
+              }, GatherSub());
         }
-      }
       });
     }  // end iblock loop
   }
+  else if (options()->getUpdateVectorFromTensorVersion() == UVTV_arcgpu)
+  {
+    _updateBlockNodeGather();
+
+    // Une seule queue : les blocs sont traités les uns après les autres
+    auto queue = m_acc_env->newQueue();
+
+    Integer nb_blocks = m_mesh_material_mng->blocks().size();
+
+    for (Integer i = 0; i < nb_blocks; i++) {
+      auto command = makeCommand(queue);
+
+      auto in_tensor = ax::viewIn(command, m_tensor.globalVariable());
+      auto in_cell_cqs = ax::viewIn(command, m_cell_cqs);
+      auto inout_node_vector = ax::viewInOut(command, m_node_vector);
+
+      auto node_gather = m_block_node_gather[i]->view();
+      auto block_nodes = m_block_node_gather[i]->nodes();
+
+      command << RUNCOMMAND_LOOP1(iter, Integer(block_nodes.size())) {
+        auto [inode] = iter();
+        NodeLocalId nid(block_nodes[inode]);
+        inout_node_vector[nid] = node_gather.gather(nid, Real3(inout_node_vector[nid]),
+            [&](CellLocalId cid, Int16 node_index) {
+              return math::prodTensVec(in_tensor[cid], in_cell_cqs[cid][node_index]);
+            }, GatherSub());
+      };
+    }  // end iblock loop
+  }
+
+  if (check_ori) {
+    _checkUpdateVectorFromTensorOri(prev_node_vector);
+  }
   PROF_ACC_END;
 }
 
 /*---------------------------------------------------------------------------*/
+/* Rejoue la version ori à partir de prev_node_vector et vérifie que         */
+/* m_node_vector lui est identique bit à bit                                 */
 /*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_checkUpdateVectorFromTensorOri(ConstArrayView<Real3> prev_node_vector) {
+  PROF_ACC_BEGIN(__FUNCTION__);
+  UniqueArray<Real3> ref_node_vector(prev_node_vector);
+
+  Integer nb_blocks = m_mesh_material_mng->blocks().size();
+  for (Integer i = 0; i < nb_blocks; i++) {
+    IMeshBlock* b = (m_mesh_material_mng->blocks())[i];
+    ENUMERATE_CELL (cell_i, b->cells()) {
+      ENUMERATE_NODE (node_i, cell_i->nodes()) {
+        ref_node_vector[node_i.localId()] -= math::prodTensVec(m_tensor[cell_i],
+            m_cell_cqs[cell_i][node_i.index()]);
+      }
+    }
+  }
+
+  Integer nb_diff = 0;
+  ENUMERATE_NODE (node_i, allNodes()) {
+    const Real3& ref = ref_node_vector[node_i.localId()];
+    const Real3& val = m_node_vector[node_i];
+    if (ref.x != val.x || ref.y != val.y || ref.z != val.z) {
+      ++nb_diff;
+    }
+  }
+  if (nb_diff) {
+    fatal() << "update-vector-from-tensor-version : " << nb_diff << " noeud(s) differe(nt) de la version ori (" << nb_blocks << " bloc(s))";
+  }
+  PROF_ACC_END;
+}
 
+/*---------------------------------------------------------------------------*/
+/* (Re)construit si nécessaire la table noeud->(maille, coin) de chaque bloc */
+/* restreinte aux mailles du bloc et dans l'ordre de ces mailles             */
+/*---------------------------------------------------------------------------*/
+void Pattern4GPUModule::
+_updateBlockNodeGather() {
+  PROF_ACC_BEGIN(__FUNCTION__);
+  // Les mailles des blocs ne changent qu'avec le maillage
+  Int64 mesh_timestamp = mesh()->timestamp();
+  ConstArrayView<IMeshBlock*> blocks = m_mesh_material_mng->blocks();
+
+  for (Integer i = m_block_node_gather.size(); i < blocks.size(); i++) {
+    m_block_node_gather.add(new NodeGatherEngine());
+  }
+
+  for (Integer i = 0; i < blocks.size(); i++) {
+    NodeGatherEngine* block_node_gather = m_block_node_gather[i];
+    if (block_node_gather->isUpToDate(mesh_timestamp, /*sort_cells=*/false)) {
+      continue;
+    }
+    block_node_gather->buildFromCells(m_acc_env->connectivityView(), allNodes().size(),
+        blocks[i]->cells().view(), mesh_timestamp);
+    block_node_gather->setReadMostly(m_acc_env->accMemAdv());
+  }
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -15,6 +15,22 @@ enum eDeviceAffinity {
 enum eHeterogPartition {
   HP_none = 0,      //! Répartition homogène (tout Host ou bien tout Device)
   HP_heterog1,      //! 1ere version de répartition hétérogène
+  HP_cost_model,    //! Comme HP_heterog1, avec un repartitionnement proportionnel au débit mesuré de chaque sous-domaine
+};
+
+/*! \brief Placement NUMA des threads et de la mémoire hôte du processus
+ */
+enum eNumaPlacement {
+  NP_none = 0,      //! Aucun placement (celui du lanceur MPI est conservé)
+  NP_auto,          //! Domaine le plus proche du device, sinon domaine courant (choisi par le lanceur MPI)
+  NP_round_robin    //! Domaine node_rank%nb_domaines, même avec un device
+};
+
+/*! \brief Disposition du stockage des environnements par maille
+ */
+enum eMultiEnvCellLayout {
+  MEL_dense = 0,    //! Tableaux de max_nb_env entrées par maille
+  MEL_csr           //! Paires (env, indice) des seules mailles mixtes, mailles pures en accès direct
 };
 
 #endif
@@ -1,14 +1,22 @@
 #include "AccEnvDefaultService.h"
+#include "accenv/NumaTopology.h"
 
 #include "arcane/materials/CellToAllEnvCellConverter.h"
 #include "arcane/materials/IMeshEnvironment.h"
 #include "arcane/materials/ComponentPartItemVectorView.h"
 
 #include <arcane/AcceleratorRuntimeInitialisationInfo.h>
+#include <arcane/IItemFamily.h>
+#include <arcane/IMeshModifier.h>
+#include <arcane/IMeshUtilities.h>
+#include <arcane/IPrimaryMesh.h>
+#include <arcane/ISubDomain.h>
 #include <arcane/IParallelMng.h>
 #include <arcane/ParallelMngUtils.h>
 #include <arcane/IParallelTopology.h>
 
+#include <algorithm>
+
 #if defined(ACCENV_HWLOC) && defined(ARCANE_COMPILING_CUDA)
 #warning "HWLOC présent pour placement GPUs"
 // Code issu de https://www.open-mpi.org/faq/?category=runcuda
@@ -76,7 +84,20 @@ AccEnvDefaultService::AccEnvDefaultService(const ServiceBuildInfo & sbi) :
 AccEnvDefaultService::~AccEnvDefaultService() {
   delete m_acc_mem_adv;
   delete m_menv_cell;
+  if (m_menv_queue && m_menv_queue->nbSchedule()>0) {
+    // Charges des queues multi-environnement affectées par coût estimé
+    info() << "Multi-env queues : " << m_menv_queue->nbSchedule() << " ordonnancements, equilibre = "
+      << m_menv_queue->balanceRatio();
+    for(Integer iq=0 ; iq<m_menv_queue->nbQueue() ; ++iq) {
+      info() << "  queue " << iq << " : charge cumulee = " << m_menv_queue->totalLoads()[iq]
+        << ", nb lancements = " << m_menv_queue->nbLaunches()[iq];
+    }
+  }
   delete m_menv_queue;
+  if (m_vsync_mng) {
+    m_vsync_mng->printBufCompressionStats(traceMng());
+    m_vsync_mng->dumpSyncStats(traceMng());
+  }
   delete m_vsync_mng;
 }
 
@@ -92,7 +113,8 @@ initAcc()
   {
     initializeRunner(m_runner,traceMng(),app->acceleratorRuntimeInitialisationInfo());
   }
-  else if (options()->getHeterogPartition() == HP_heterog1)
+  else if (options()->getHeterogPartition() == HP_heterog1 ||
+      options()->getHeterogPartition() == HP_cost_model)
   {
     Integer rank = mesh()->parallelMng()->commRank();
     bool is_host_only = (rank > 0);
@@ -113,6 +135,10 @@ initAcc()
     }
   }
 
+  if (options()->getHeterogPartition() == HP_cost_model) {
+    _computeHeterogWeights();
+  }
+
   bool is_acc_av = AcceleratorUtils::isAvailable(m_runner);
   if (is_acc_av && options()->getDeviceAffinity() == DA_world_rank) 
   {
@@ -221,6 +247,200 @@ initAcc()
   }
 #endif // ACCENV_HWLOC
 #endif // ARCANE_COMPILING_CUDA
+
+  if (options()->getNumaPlacement() != NP_none) {
+    _placeOnNuma(is_acc_av);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Placement du thread principal (et donc des threads qu'il crée ensuite)   */
+/* et de la mémoire du processus sur un domaine NUMA                         */
+/*                                                                           */
+/* Les pages déjà touchées (variables du maillage allouées par Arcane avant  */
+/* initAcc) sont migrées sur le domaine, les suivantes y sont allouées       */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+_placeOnNuma(bool is_acc_av) {
+  IParallelMng* pm = mesh()->parallelMng();
+  // Attention, opérations collectives : appelées par tous les rangs
+  Ref<IParallelTopology> pt = ParallelMngUtils::createTopologyRef(pm);
+  Ref<IParallelMng> pm_node = pm->createSubParallelMngRef(pt->machineRanks());
+  Integer node_rank = pm_node->commRank();
+
+  NumaTopology numa_topo;
+  if (!numa_topo.isAvailable()) {
+    pinfo() << "Processus " << pm->commRank() << " : topologie NUMA inconnue, pas de placement";
+    return;
+  }
+
+  // round_robin : les rangs d'un noeud sont répartis sur les domaines
+  // auto : au plus près du device, sinon on reste sur le domaine choisi par le
+  // lanceur MPI (là où la mémoire a déjà été touchée)
+  Integer inode = -1;
+  String pci_bus_id;
+  if (options()->getNumaPlacement() == NP_round_robin) {
+    inode = node_rank % numa_topo.nbNode();
+  } else {
+    if (is_acc_av) {
+      pci_bus_id = AcceleratorUtils::devicePciBusId();
+      inode = numa_topo.pciDeviceNode(pci_bus_id);
+    }
+    if (inode<0) {
+      inode = numa_topo.currentNode();
+    }
+  }
+  if (inode<0) {
+    pinfo() << "Processus " << pm->commRank() << " : domaine NUMA inconnu, pas de placement";
+    return;
+  }
+
+  bool is_bound = numa_topo.bindCurrentThread(inode);
+  Int64 nb_unmoved = (is_bound ? numa_topo.migrateCurrentProcess(inode) : -1);
+  pinfo() << "Processus " << pm->commRank() << " (node_rank=" << node_rank << ")"
+    << " : domaine NUMA " << inode << "/" << numa_topo.nbNode()
+    << (is_acc_av ? String(" (device " + pci_bus_id + ")") : String(""))
+    << " via " << numa_topo.discoveryMethod()
+    << (is_bound ? "" : " : ECHEC du placement")
+    << (nb_unmoved>0 ? String(" (" + String::fromNumber(nb_unmoved) + " pages non migrées)") : String(""))
+    << (is_bound && nb_unmoved<0 ? " : ECHEC de la migration" : "");
+}
+
+/*---------------------------------------------------------------------------*/
+/* Débit (en mailles/s) d'un noyau représentatif de type CQS exécuté par     */
+/* m_runner sur nb_item mailles fictives                                     */
+/*---------------------------------------------------------------------------*/
+Real AccEnvDefaultService::
+_calibrateThroughput(Integer nb_item) {
+  PROF_ACC_BEGIN(__FUNCTION__);
+  // La maille i a pour noeuds les coordonnées [i,i+8[
+  UniqueArray<Real3> coords(platform::getAcceleratorHostMemoryAllocator(), nb_item+8);
+  UniqueArray<Real> cqs_norm(platform::getAcceleratorHostMemoryAllocator(), nb_item);
+  for(Integer i=0 ; i<coords.size() ; ++i) {
+    coords[i] = Real3(0.1*i, 0.2*(i%7), 0.3*(i%5));
+  }
+
+  auto queue = makeQueue(m_runner);
+  auto cqs_kernel = [&]() {
+    auto command = makeCommand(queue);
+
+    Span<const Real3> in_coords(coords.constSpan());
+    Span<Real> out_cqs_norm(cqs_norm.span());
+
+    command << RUNCOMMAND_LOOP1(iter, nb_item) {
+      auto [i] = iter();
+      // Mêmes opérations que le calcul des 8 CQS d'une maille hexaédrique
+      Real3 x[8];
+      for(Integer n=0 ; n<8 ; ++n) {
+        x[n] = in_coords[i+n];
+      }
+      Real sum=0.;
+      for(Integer n=0 ; n<8 ; ++n) {
+        Real3 cqs = -0.25*math::vecMul(x[(n+1)%8]-x[(n+3)%8], x[(n+4)%8]-x[(n+2)%8]);
+        sum += math::abs(cqs.x)+math::abs(cqs.y)+math::abs(cqs.z);
+      }
+      out_cqs_norm[i] = sum;
+    };
+    queue.barrier();
+  };
+
+  // Un premier appel pour écarter le coût d'initialisation du runtime
+  cqs_kernel();
+
+  const Integer nb_rep = 5;
+  Real t_beg = platform::getRealTime();
+  for(Integer irep=0 ; irep<nb_rep ; ++irep) {
+    cqs_kernel();
+  }
+  Real elapsed = platform::getRealTime()-t_beg;
+  PROF_ACC_END;
+  return (elapsed>0. ? Real(nb_rep)*nb_item/elapsed : 0.);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Poids de répartition des sous-domaines proportionnels à leur débit        */
+/* mesuré (opération collective)                                             */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+_computeHeterogWeights() {
+  IParallelMng* pm = mesh()->parallelMng();
+  Integer nb_item = std::max(options()->getHeterogCalibrationSize(), 1);
+
+  // Opération collective : tous les rangs calibrent puis échangent leur débit
+  Real throughput = _calibrateThroughput(nb_item);
+  UniqueArray<Real> send_thr(1, throughput);
+  m_heterog_throughputs.resize(pm->commSize());
+  pm->allGather(send_thr, m_heterog_throughputs);
+
+  Real sum_thr = 0.;
+  for(Real thr : m_heterog_throughputs) {
+    sum_thr += thr;
+  }
+  Integer nb_rank = m_heterog_throughputs.size();
+  m_heterog_weights.resize(nb_rank);
+  for(Integer irank=0 ; irank<nb_rank ; ++irank) {
+    m_heterog_weights[irank] = (sum_thr>0. ? m_heterog_throughputs[irank]/sum_thr : 1./nb_rank);
+  }
+
+  Integer rank = pm->commRank();
+  pinfo() << "Processus " << rank << " : debit calibre = " << throughput 
+    << " mailles/s, poids de partition = " << m_heterog_weights[rank];
+}
+
+/*---------------------------------------------------------------------------*/
+/* Repartitionnement du maillage : le rang r reçoit la tranche de uniqueId   */
+/* de mailles dont la taille est proportionnelle à son débit calibré.        */
+/* Avec le générateur cartésien, les tranches sont des plans de mailles.     */
+/* Doit être appelé avant la création des environnements et des données     */
+/* dépendant du maillage (connectivités, synchros)                           */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+heterogPartition(IMesh* mesh)
+{
+  if (options()->getHeterogPartition() != HP_cost_model) {
+    return;
+  }
+  IParallelMng* pm = mesh->parallelMng();
+  Integer nb_rank = m_heterog_weights.size();
+  if (nb_rank<=1 || !pm->isParallel()) {
+    return;
+  }
+  PROF_ACC_BEGIN(__FUNCTION__);
+
+  // Numérotation supposée dense : [0, nb_uid[
+  Int64 max_uid = -1;
+  ENUMERATE_CELL(icell, mesh->ownCells()) {
+    max_uid = std::max(max_uid, icell->uniqueId().asInt64());
+  }
+  Int64 nb_uid = pm->reduce(Parallel::ReduceMax, max_uid)+1;
+
+  // uid_end[r] : fin (exclue) de la tranche de uniqueId du rang r
+  UniqueArray<Int64> uid_end(nb_rank);
+  Real cumul_weight = 0.;
+  for(Integer irank=0 ; irank<nb_rank ; ++irank) {
+    cumul_weight += m_heterog_weights[irank];
+    uid_end[irank] = (irank==nb_rank-1 ? nb_uid : Int64(cumul_weight*nb_uid));
+  }
+
+  IPrimaryMesh* pmesh = mesh->toPrimaryMesh();
+  VariableItemInt32& cells_new_owner = pmesh->itemsNewOwner(IK_Cell);
+  ENUMERATE_CELL(icell, mesh->ownCells()) {
+    Int64 uid = icell->uniqueId().asInt64();
+    Integer new_owner = std::upper_bound(uid_end.begin(), uid_end.end(), uid) - uid_end.begin();
+    cells_new_owner[icell] = std::min(new_owner, nb_rank-1);
+  }
+  cells_new_owner.synchronize();
+  mesh->utilities()->changeOwnersFromCells();
+  mesh->modifier()->setDynamic(true);
+  pmesh->exchangeItems();
+
+  Integer rank = pm->commRank();
+  Integer nb_own_cell = mesh->ownCells().size();
+  Int64 nb_tot_cell = pm->reduce(Parallel::ReduceSum, Int64(nb_own_cell));
+  pinfo() << "Processus " << rank << " : " << nb_own_cell << " mailles propres apres repartitionnement"
+    << " (part = " << (nb_tot_cell>0 ? Real(nb_own_cell)/nb_tot_cell : 0.)
+    << ", visee = " << m_heterog_weights[rank] << ")";
+  PROF_ACC_END;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -232,35 +452,98 @@ refQueueAsync(eQueuePriority qp) {
 }
 
 /*---------------------------------------------------------------------------*/
+/* Index du noeud node dans chacune des mailles auxquelles il est connecté   */
+/* (-1 au-delà du nb de mailles du noeud), exécutable sur hôte et device     */
 /*---------------------------------------------------------------------------*/
+template<typename NodeCellViewType, typename CellNodeViewType>
+ARCCORE_HOST_DEVICE inline void
+_fillNodeIndexInCells(NodeLocalId node, Int32 max_node_cell,
+    const NodeCellViewType& node_cell_cty, const CellNodeViewType& cell_node_cty,
+    Span<Int16> node_index_in_cells) {
+  Int32 index = 0; 
+  Int32 first_pos = node.localId() * max_node_cell;
+  for( CellLocalId cell : node_cell_cty.cells(node) ){
+    Int16 node_index_in_cell = 0; 
+    for( NodeLocalId cell_node : cell_node_cty.nodes(cell) ){
+      if (cell_node==node)
+        break;
+      ++node_index_in_cell;
+    }    
+    node_index_in_cells[first_pos + index] = node_index_in_cell;
+    ++index;
+  }    
+  for( ; index<max_node_cell ; ++index) {
+    node_index_in_cells[first_pos + index] = -1;
+  }
+}
+
 void AccEnvDefaultService::
 _computeNodeIndexInCells() {
-  debug() << "_computeNodeIndexInCells";
   // Un noeud est connecté au maximum à max_node_cell mailles
   // Calcul pour chaque noeud son index dans chacune des
   // mailles à laquelle il est connecté.
   NodeGroup nodes = allNodes();
   Integer nb_node = nodes.size();
   const Integer max_node_cell = this->maxNodeCell();
+
+  // Rien à refaire si le maillage n'a pas changé depuis le dernier calcul
+  Int64 mesh_timestamp = mesh()->timestamp();
+  if (mesh_timestamp==m_node_index_timestamp && 
+      m_node_index_in_cells.size()==max_node_cell*nb_node) {
+    debug() << "_computeNodeIndexInCells : maillage inchange, table conservee";
+    return;
+  }
+  PROF_ACC_BEGIN(__FUNCTION__);
+  debug() << "_computeNodeIndexInCells";
+
   m_node_index_in_cells.resize(max_node_cell*nb_node);
-  m_node_index_in_cells.fill(-1);
   auto node_cell_cty = this->connectivityView().nodeCell();
   auto cell_node_cty = this->connectivityView().cellNode();
-  ENUMERATE_NODE(inode,nodes){
-    NodeLocalId node = *inode;
-    Int32 index = 0; 
-    Int32 first_pos = node.localId() * max_node_cell;
-    for( CellLocalId cell : node_cell_cty.cells(node) ){
-      Int16 node_index_in_cell = 0; 
-      for( NodeLocalId cell_node : cell_node_cty.nodes(cell) ){
-        if (cell_node==node)
-          break;
-        ++node_index_in_cell;
-      }    
-      m_node_index_in_cells[first_pos + index] = node_index_in_cell;
-      ++index;
-    }    
+
+  // Chaque noeud remplit ses max_node_cell valeurs : pas de conflit d'écriture
+  if (AcceleratorUtils::isAvailable(m_runner)) {
+    auto queue = makeQueue(m_runner);
+    auto command = makeCommand(queue);
+
+    Span<Int16> out_node_index_in_cells(m_node_index_in_cells.span());
+
+    command << RUNCOMMAND_ENUMERATE(Node, nid, nodes) {
+      _fillNodeIndexInCells(nid, max_node_cell, node_cell_cty, cell_node_cty, out_node_index_in_cells);
+    };
+  } else {
+    ParallelLoopOptions options;
+    options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
+
+    Span<Int16> out_node_index_in_cells(m_node_index_in_cells.span());
+
+    arcaneParallelForeach(nodes, options, [&](NodeVectorView sub_nodes) {
+      ENUMERATE_NODE(inode, sub_nodes) {
+        _fillNodeIndexInCells(NodeLocalId(inode.localId()), max_node_cell, 
+            node_cell_cty, cell_node_cty, out_node_index_in_cells);
+      }
+    });
+  }
+  m_node_index_timestamp = mesh_timestamp;
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Table CSR noeud->(maille, coin) utilisée par les gathers aux noeuds       */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+_computeNodeGather() {
+  bool sort_cells = options()->getNodeGatherSort();
+  // Rien à refaire si le maillage n'a pas changé depuis le dernier calcul
+  if (m_node_gather.isUpToDate(mesh()->timestamp(), sort_cells)) {
+    debug() << "_computeNodeGather : maillage inchange, table conservee";
+    return;
   }
+  PROF_ACC_BEGIN(__FUNCTION__);
+  debug() << "_computeNodeGather";
+
+  m_node_gather.build(m_connectivity_view, allNodes(), mesh()->timestamp(), sort_cells);
+
+  PROF_ACC_END;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -277,10 +560,12 @@ initMesh(IMesh* mesh)
   m_connectivity_view.setMesh(mesh);
   // Permet la lecture des cqs quand on boucle sur les noeuds
   _computeNodeIndexInCells();
+  _computeNodeGather();
 
   // "Conseils" utilisation de la mémoire unifiée
 
   m_acc_mem_adv->setReadMostly(m_node_index_in_cells.view());
+  m_node_gather.setReadMostly(m_acc_mem_adv);
   
   // CellLocalId
   m_acc_mem_adv->setReadMostly(allCells().view().localIds());
@@ -296,6 +581,15 @@ initMesh(IMesh* mesh)
 
   m_vsync_mng = new VarSyncMng(mesh, m_runner, m_acc_mem_adv);
   m_vsync_mng->setDefaultVarSyncVersion(options()->getVarSyncVersion());
+  m_vsync_mng->setAutoTuneNbTrials(options()->getVarSyncAutotuneNbTrials());
+  if (options()->getSimNetLatency()>0 || options()->getSimNetBandwidth()>0) {
+    // Latence en µs et débit en Go/s dans le jeu de données
+    m_vsync_mng->setSimulatedNetwork(options()->getSimNetLatency()*1.e-6, 
+        options()->getSimNetBandwidth()*1.e9);
+  }
+  m_vsync_mng->setSyncBufShrinkPolicy(options()->getSyncBufShrinkAfter());
+  m_vsync_mng->setNeighProgressThreads(options()->getNeighProgressThreads());
+  m_vsync_mng->enableSyncStats(options()->getSyncStats(), options()->getSyncStatsFile());
 }
 
 /*---------------------------------------------------------------------------*/
@@ -307,11 +601,24 @@ computeMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) {
   PROF_ACC_BEGIN(__FUNCTION__);
   debug() << "computeMultiEnvGlobalCellId";
 
+  _computeGlobalCellIdAndEnvId(mesh_material_mng, allCells().view());
+
+  m_menv_cell->buildStorage(m_runner, m_global_cell);
+
+  checkMultiEnvGlobalCellId(mesh_material_mng);
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Calcul de m_global_cell et m_env_id sur les mailles cells uniquement      */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+_computeGlobalCellIdAndEnvId(IMeshMaterialMng* mesh_material_mng, CellVectorView cells_to_compute) {
   ParallelLoopOptions options;
   options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
 
   // Calcul des cell_id globaux 
-  arcaneParallelForeach(allCells(), options, [&](CellVectorView cells) {
+  arcaneParallelForeach(cells_to_compute, options, [&](CellVectorView cells) {
     CellToAllEnvCellConverter all_env_cell_converter(mesh_material_mng);
     ENUMERATE_CELL(icell, cells)
     {
@@ -338,11 +645,6 @@ computeMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) {
       }
     }
   });
-
-  m_menv_cell->buildStorage(m_runner, m_global_cell);
-
-  checkMultiEnvGlobalCellId(mesh_material_mng);
-  PROF_ACC_END;
 }
 
 void AccEnvDefaultService::
@@ -383,6 +685,43 @@ updateMultiEnv(IMeshMaterialMng* mesh_material_mng) {
   // disposition des environnements a changé sur le maillage
   computeMultiEnvGlobalCellId(mesh_material_mng);
 
+  _endUpdateMultiEnv(mesh_material_mng);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Mise à jour limitée aux mailles dont la composition en environnements a   */
+/* changé, reconstruction complète au-delà d'une proportion de mailles       */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+updateMultiEnv(IMeshMaterialMng* mesh_material_mng, Int32ConstArrayView changed_cell_lids) {
+  Integer nb_cell = allCells().size();
+  Real change_ratio = (nb_cell>0 ? Real(changed_cell_lids.size())/Real(nb_cell) : 1.);
+  if (change_ratio > options()->getMenvIncrementalMaxRatio()) {
+    debug() << "updateMultiEnv : " << changed_cell_lids.size() << " mailles modifiees, reconstruction complete";
+    updateMultiEnv(mesh_material_mng);
+    return;
+  }
+  PROF_ACC_BEGIN(__FUNCTION__);
+  debug() << "updateMultiEnv : " << changed_cell_lids.size() << " mailles modifiees, mise a jour incrementale";
+
+  // Seules les mailles modifiées voient m_global_cell et m_env_id changer
+  _computeGlobalCellIdAndEnvId(mesh_material_mng, CellVectorView(mesh()->cellFamily()->view(changed_cell_lids)));
+
+  m_menv_cell->updateStorage(m_runner, m_global_cell, changed_cell_lids);
+
+  checkMultiEnvGlobalCellId(mesh_material_mng);
+  // En mode debug, comparaison avec la reconstruction complète
+  m_menv_cell->checkSameAsBuild(m_runner, m_global_cell);
+
+  _endUpdateMultiEnv(mesh_material_mng);
+  PROF_ACC_END;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Partie commune aux mises à jour complète et incrémentale                  */
+/*---------------------------------------------------------------------------*/
+void AccEnvDefaultService::
+_endUpdateMultiEnv(IMeshMaterialMng* mesh_material_mng) {
   // "Conseils" utilisation de la mémoire unifiée
   ENUMERATE_ENV(ienv,mesh_material_mng){
     IMeshEnvironment* env = *ienv;
@@ -406,7 +745,7 @@ initMultiEnv(IMeshMaterialMng* mesh_material_mng) {
 
   m_menv_queue = new MultiAsyncRunQueue(m_runner, mesh_material_mng->environments().size());
 
-  m_menv_cell = new MultiEnvCellStorage(mesh_material_mng, m_acc_mem_adv);
+  m_menv_cell = new MultiEnvCellStorage(mesh_material_mng, m_acc_mem_adv, options()->getMenvCellLayout());
 
   updateMultiEnv(mesh_material_mng);
 }
@@ -30,18 +30,23 @@ class AccEnvDefaultService : public ArcaneAccEnvDefaultObject
   UnstructuredMeshConnectivityView& connectivityView() override { return m_connectivity_view; }
   const UnstructuredMeshConnectivityView& connectivityView() const override { return m_connectivity_view; }
   
+  void heterogPartition(IMesh* mesh) override;
+
   void initMesh(IMesh* mesh) override;
 
   Span<const Int16> nodeIndexInCells() const override { return m_node_index_in_cells.constSpan(); }
 
   Integer maxNodeCell() const override { return 8; }
 
+  NodeGatherView nodeGather() const override { return m_node_gather.view(); }
+
   void initMultiEnv(IMeshMaterialMng* mesh_material_mng) override;
   MultiAsyncRunQueue* multiEnvQueue() override { return m_menv_queue; }
 
   void computeMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) override;
   void checkMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) override;
   void updateMultiEnv(IMeshMaterialMng* mesh_material_mng) override;
+  void updateMultiEnv(IMeshMaterialMng* mesh_material_mng, Int32ConstArrayView changed_cell_lids) override;
 
   MultiEnvCellStorage* multiEnvCellStorage() override { return m_menv_cell; }
 
@@ -50,6 +55,15 @@ class AccEnvDefaultService : public ArcaneAccEnvDefaultObject
  protected:
 
   void _computeNodeIndexInCells();
+  void _computeNodeGather();
+
+  void _placeOnNuma(bool is_acc_av);
+
+  Real _calibrateThroughput(Integer nb_item);
+  void _computeHeterogWeights();
+
+  void _computeGlobalCellIdAndEnvId(IMeshMaterialMng* mesh_material_mng, CellVectorView cells_to_compute);
+  void _endUpdateMultiEnv(IMeshMaterialMng* mesh_material_mng);
 
  protected:
   ax::Runner m_runner;
@@ -57,6 +71,9 @@ class AccEnvDefaultService : public ArcaneAccEnvDefaultObject
   UnstructuredMeshConnectivityView m_connectivity_view;
 
   UniqueArray<Int16> m_node_index_in_cells;
+  Int64 m_node_index_timestamp=-1;  //!< mesh()->timestamp() lors du calcul de m_node_index_in_cells
+
+  NodeGatherEngine m_node_gather;  //!< table CSR noeud->(maille, coin) partagée par les gathers aux noeuds
 
   //! Description/accès aux mailles multi-env
   MultiEnvCellStorage* m_menv_cell=nullptr;
@@ -64,6 +81,10 @@ class AccEnvDefaultService : public ArcaneAccEnvDefaultObject
   // Les queues asynchrones d'exéution
   MultiAsyncRunQueue* m_menv_queue=nullptr; //!< les queues pour traiter les environnements de façon asynchrone
 
+  // Répartition hétérogène guidée par le débit mesuré (HP_cost_model)
+  UniqueArray<Real> m_heterog_throughputs; //!< débit calibré (mailles/s) de chaque rang
+  UniqueArray<Real> m_heterog_weights; //!< part du maillage visée par chaque rang (somme = 1)
+
   //! Pour "synchroniser" les items fantômes
   VarSyncMng* m_vsync_mng=nullptr;
 };
@@ -11,6 +11,8 @@
 #include "arcane/accelerator/core/RunQueueBuildInfo.h"
 #include <arcane/accelerator/core/Memory.h>
 
+#include <algorithm>
+
 /*---------------------------------------------------------------------------*/
 /* Pour les accélérateurs                                                    */
 /*---------------------------------------------------------------------------*/
@@ -124,6 +126,21 @@ class AcceleratorUtils {
 #endif
   }
 
+  //! Identifiant PCI ("dddd:bb:dd.f") du device courant, vide sans accélérateur
+  static String devicePciBusId() {
+    char bus_id[32] = "";
+#if defined(ARCANE_COMPILING_CUDA)
+    int device=0;
+    cudaGetDevice(&device);
+    cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device);
+#elif defined(ARCANE_COMPILING_HIP)
+    int device=0;
+    auto err = hipGetDevice(&device);
+    err = hipDeviceGetPCIBusId(bus_id, sizeof(bus_id), device);
+#endif
+    return String(bus_id);
+  }
+
   static void setDevice([[maybe_unused]] Integer device) {
 #if defined(ARCANE_COMPILING_CUDA)
     cudaSetDevice(device);
@@ -197,9 +214,90 @@ class MultiAsyncRunQueue {
     return m_nb_queue;
   }
 
+  /*!
+   * \brief Affecte des lancements aux queues selon leur coût estimé
+   *
+   * costs[i] = coût du i-ième lancement (ex : nb d'items x poids par item).
+   * Ordonnancement LPT (Longest Processing Time first) : par coût
+   * décroissant, chaque lancement va sur la queue la moins chargée.
+   * En retour, queue_ids[i] est l'indice de la queue pour queue(queue_ids[i])
+   * et launch_order les indices des lancements par coût décroissant
+   * (lancer les plus gros d'abord raccourcit le chemin critique).
+   */
+  void scheduleByCost(ConstArrayView<Real> costs, ArrayView<Integer> queue_ids,
+      ArrayView<Integer> launch_order) {
+    Integer nb_launch = costs.size();
+    ARCANE_ASSERT(queue_ids.size()==nb_launch && launch_order.size()==nb_launch,
+        ("queue_ids et launch_order doivent avoir la taille de costs"));
+
+    for(Integer i=0 ; i<nb_launch ; ++i) {
+      launch_order[i] = i;
+    }
+    // Tri stable : à coût égal, l'ordre d'origine est conservé
+    std::stable_sort(launch_order.begin(), launch_order.end(),
+        [&costs](Integer a, Integer b) { return costs[a] > costs[b]; });
+
+    m_cur_loads.resize(m_nb_queue);
+    m_cur_loads.fill(0.);
+    for(Integer i : launch_order) {
+      Integer iq_min = 0;
+      for(Integer iq=1 ; iq<m_nb_queue ; ++iq) {
+        if (m_cur_loads[iq] < m_cur_loads[iq_min]) {
+          iq_min = iq;
+        }
+      }
+      queue_ids[i] = iq_min;
+      m_cur_loads[iq_min] += costs[i];
+    }
+
+    // Statistiques cumulées
+    m_total_loads.resize(m_nb_queue, 0.);
+    m_nb_launches.resize(m_nb_queue, 0);
+    Real max_load = 0., sum_load = 0.;
+    for(Integer iq=0 ; iq<m_nb_queue ; ++iq) {
+      m_total_loads[iq] += m_cur_loads[iq];
+      max_load = std::max(max_load, m_cur_loads[iq]);
+      sum_load += m_cur_loads[iq];
+    }
+    for(Integer i=0 ; i<nb_launch ; ++i) {
+      m_nb_launches[queue_ids[i]]++;
+    }
+    m_sum_critical_load += max_load;
+    m_sum_load += sum_load;
+    m_nb_schedule++;
+  }
+
+  //! Charges des queues (somme des coûts) lors du dernier scheduleByCost
+  ConstArrayView<Real> lastLoads() const { return m_cur_loads; }
+
+  //! Charges cumulées de chaque queue sur tous les scheduleByCost
+  ConstArrayView<Real> totalLoads() const { return m_total_loads; }
+
+  //! Nombre de lancements cumulés affectés à chaque queue
+  ConstArrayView<Integer> nbLaunches() const { return m_nb_launches; }
+
+  //! Nombre d'appels à scheduleByCost
+  Integer nbSchedule() const { return m_nb_schedule; }
+
+  /*!
+   * \brief Rapport charge totale / (nbQueue() x charge critique) cumulées
+   * 1 : charges parfaitement équilibrées, 1/nbQueue() : tout sur une queue
+   */
+  Real balanceRatio() const {
+    return (m_sum_critical_load>0. ? m_sum_load/(m_nb_queue*m_sum_critical_load) : 1.);
+  }
+
  protected:
   UniqueArray< Ref<ax::RunQueue> > m_queues; //!< toutes les RunQueue
   Integer m_nb_queue=0; //!< m_queues.size()
+
+  // Statistiques de charge de scheduleByCost
+  UniqueArray<Real> m_cur_loads; //!< charge par queue du dernier ordonnancement
+  UniqueArray<Real> m_total_loads; //!< charge cumulée par queue
+  UniqueArray<Integer> m_nb_launches; //!< nb de lancements cumulés par queue
+  Real m_sum_critical_load=0.; //!< somme des charges de la queue la plus chargée
+  Real m_sum_load=0.; //!< somme des charges de toutes les queues
+  Integer m_nb_schedule=0; //!< nb d'appels à scheduleByCost
 };
 
 /*---------------------------------------------------------------------------*/
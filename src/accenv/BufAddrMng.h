@@ -5,6 +5,7 @@
 
 #include <arcane/accelerator/core/RunQueueEvent.h>
 #include <arcane/utils/IMemoryRessourceMng.h>
+#include <arcane/utils/NumArray.h>
 #include <arcane/materials/IMeshMaterialMng.h>
 
 using namespace Arcane;
@@ -14,39 +15,59 @@ using namespace Arcane::Materials;
 /*---------------------------------------------------------------------------*/
 /*!
  * \brief Manager of buffers of Int64
+ *
+ * The buffers (slots of nbAddr() Int64) live in blocks of NumArray allocated
+ * once on the Host (pinned) and Device memory ressources : growing adds a
+ * block, the views already given are never moved. The slots given between
+ * two asyncCpyHToD() form a batch, recycled once the copy of the batch is
+ * done (event). Only when too many batches are still pending, the oldest
+ * one is waited for instead of growing.
  */
 class BufAddrMng {
+ protected:
+  //! Slots [m_first_slot, m_first_slot+m_nb_slot[ on Host and Device
+  struct Block {
+    NumArray<Int64,1>* m_buf_h=nullptr;
+    NumArray<Int64,1>* m_buf_d=nullptr;
+    Integer m_first_slot=0;
+    Integer m_nb_slot=0;
+  };
+
+  //! Slots whose copy onto the Device is in progress
+  struct PendingBatch {
+    UniqueArray<Integer> m_slots;
+    Ref<ax::RunQueueEvent> m_evt;
+  };
+
  public:
   BufAddrMng(ax::Runner& runner, IMeshMaterialMng* mm) :
+    m_runner (&runner),
     m_mesh_mat_mng (mm)
   {
     bool is_acc_avl = AcceleratorUtils::isAvailable(runner);
-    eMemoryRessource mem_h = (is_acc_avl ? eMemoryRessource::HostPinned : eMemoryRessource::Host);
-    eMemoryRessource mem_d = (is_acc_avl ? eMemoryRessource::Device : eMemoryRessource::Host);
-
-    IMemoryAllocator* alloc_h = platform::getDataMemoryRessourceMng()->getAllocator(mem_h);
-    IMemoryAllocator* alloc_d = platform::getDataMemoryRessourceMng()->getAllocator(mem_d);
+    m_mem_h = (is_acc_avl ? eMemoryRessource::HostPinned : eMemoryRessource::Host);
+    m_mem_d = (is_acc_avl ? eMemoryRessource::Device : eMemoryRessource::Host);
 
     m_nb_addr_per_buf = mm->environments().size()+1;
-    Integer sz = 10*m_nb_addr_per_buf; 
-
-    m_buf_addr_h = new UniqueArray<Int64>(alloc_h, sz);
-    m_buf_addr_d = new UniqueArray<Int64>(alloc_d, sz);
-
-    reset();
-
-    // Event created once
-    m_end_cpy_evt = ax::makeEventRef(runner);
+    _addBlock(16);
   }
 
   virtual ~BufAddrMng() {
-    delete m_buf_addr_h;
-    delete m_buf_addr_d;
+    // Les copies en cours lisent les blocs
+    for(auto& batch : m_pending) {
+      batch.m_evt->wait();
+    }
+    for(auto& block : m_blocks) {
+      delete block.m_buf_h;
+      delete block.m_buf_d;
+    }
   }
 
+  //! The views given so far won't be copied (their slots are recycled)
   void reset() {
-    m_cur_h=0;
-    m_cur_d=0;
+    _freeSlots(m_cur_slots_h);
+    m_cur_slots_h.clear();
+    m_nb_cur_d=0;
   }
 
   IMeshMaterialMng* materialMng() {
@@ -58,63 +79,163 @@ class BufAddrMng {
     return m_nb_addr_per_buf;
   }
 
+  //! Number of slots allocated (on Host and on Device)
+  Integer nbSlot() const {
+    return m_nb_slot;
+  }
+
   //! View for nbAddr() Int64 in HOST memory
   ArrayView<Int64> nextHostView() {
-    return _nextView(m_buf_addr_h, m_cur_h);
+    Integer slot = _acquireSlot();
+    m_cur_slots_h.add(slot);
+    return _slotView(slot, /*on_device=*/false);
   }
 
   //! View for nbAddr() Int64 in DEVICE memory
+  // Same slot as the nextHostView() of same rank since the last copy
   ArrayView<Int64> nextDeviceView() {
-    return _nextView(m_buf_addr_d, m_cur_d);
+    if (m_nb_cur_d >= m_cur_slots_h.size()) {
+      throw FatalErrorException(A_FUNCINFO,
+          String::format("nextDeviceView() without nextHostView() : m_nb_cur_d={0}", m_nb_cur_d));
+    }
+    return _slotView(m_cur_slots_h[m_nb_cur_d++], /*on_device=*/true);
   }
 
   //! Asynchronous copy for all current buffers from Host to Device
   // Return an event which will occur after the copy
   Ref<ax::RunQueueEvent> asyncCpyHToD(RunQueue& queue) {
-    if (m_cur_h != m_cur_d) {
+    if (m_cur_slots_h.size() != m_nb_cur_d) {
       throw FatalErrorException(A_FUNCINFO,
           String::format(
             "Different buffer cursors between host m_cur_h={0} and device m_cur_d={1}",
-            m_cur_h, m_cur_d));
+            m_cur_slots_h.size(), m_nb_cur_d));
     }
-    Integer sz = m_cur_h*m_nb_addr_per_buf;
 
-    // Asynchronous copy from Host to Device
-    queue.copyMemory(ax::MemoryCopyArgs(
-          m_buf_addr_d->subView(0, sz).data(), 
-          m_buf_addr_h->subView(0, sz).data(), 
-          sz*sizeof(Int64)).addAsync());
+    // Asynchronous copy from Host to Device, one copy per range of consecutive slots
+    Integer nb_cur = m_cur_slots_h.size();
+    for(Integer beg=0 ; beg<nb_cur ; ) {
+      Integer end = beg+1;
+      while (end<nb_cur && m_cur_slots_h[end]==m_cur_slots_h[end-1]+1 &&
+          _blockOf(m_cur_slots_h[end])==_blockOf(m_cur_slots_h[beg])) {
+        ++end;
+      }
+      Int64 sz = Int64(end-beg)*m_nb_addr_per_buf;
+      queue.copyMemory(ax::MemoryCopyArgs(
+            _slotView(m_cur_slots_h[beg], /*on_device=*/true).data(),
+            _slotView(m_cur_slots_h[beg], /*on_device=*/false).data(),
+            sz*sizeof(Int64)).addAsync());
+      beg = end;
+    }
 
-    queue.recordEvent(m_end_cpy_evt);
+    // The slots of this batch will be recycled once the copy is done
+    PendingBatch batch;
+    batch.m_slots = m_cur_slots_h;
+    batch.m_evt = _acquireEvent();
+    queue.recordEvent(batch.m_evt);
+    Ref<ax::RunQueueEvent> end_cpy_evt = batch.m_evt;
+    m_pending.add(batch);
 
-    reset(); // prepare the next stage
+    m_cur_slots_h.clear(); // prepare the next stage
+    m_nb_cur_d=0;
 
-    return m_end_cpy_evt;
+    return end_cpy_evt;
   }
 
  protected:
 
-  ArrayView<Int64> _nextView(UniqueArray<Int64>* buf_addr, Integer& cur) {
-    if (cur == (buf_addr->size()/m_nb_addr_per_buf)) {
-      Integer sz = buf_addr->size() + 10*m_nb_addr_per_buf;
-      // FIXME : resize plante si eMemoryRessource::Device, utiliser un
-      // NumArray à la place ?
-      buf_addr->resize(sz);
+  //! A free slot, recycled from the oldest batches if possible, otherwise in a new block
+  Integer _acquireSlot() {
+    if (m_free_slots.empty() && !m_pending.empty()) {
+      // Trop de lots en vol : on attend le plus ancien plutôt que de grossir
+      if (m_pending.size() > m_max_pending) {
+        _recycleOldestBatch();
+      }
     }
+    if (m_free_slots.empty()) {
+      // On double le nb de slots, sans déplacer les vues déjà données
+      _addBlock(m_nb_slot);
+    }
+    Integer slot = m_free_slots.back();
+    m_free_slots.popBack();
+    return slot;
+  }
+
+  //! Wait for the copy of the oldest batch and recycle its slots and its event
+  void _recycleOldestBatch() {
+    PendingBatch& batch = m_pending[0];
+    batch.m_evt->wait();
+    _freeSlots(batch.m_slots);
+    m_free_events.add(batch.m_evt);
+    m_pending.remove(0);
+  }
+
+  //! The lowest slots are given first (consecutive slots, fewer copies)
+  void _freeSlots(ConstArrayView<Integer> slots) {
+    for(Integer i=slots.size()-1 ; i>=0 ; --i) {
+      m_free_slots.add(slots[i]);
+    }
+  }
+
+  Ref<ax::RunQueueEvent> _acquireEvent() {
+    if (m_free_events.empty()) {
+      // Event created once, then recycled with its batch
+      return ax::makeEventRef(*m_runner);
+    }
+    Ref<ax::RunQueueEvent> evt = m_free_events.back();
+    m_free_events.popBack();
+    return evt;
+  }
+
+  void _addBlock(Integer nb_slot) {
+    Block block;
+    block.m_first_slot = m_nb_slot;
+    block.m_nb_slot = nb_slot;
+    block.m_buf_h = new NumArray<Int64,1>(m_mem_h);
+    block.m_buf_h->resize(Int64(nb_slot)*m_nb_addr_per_buf);
+    block.m_buf_d = new NumArray<Int64,1>(m_mem_d);
+    block.m_buf_d->resize(Int64(nb_slot)*m_nb_addr_per_buf);
+    m_blocks.add(block);
+    m_nb_slot += nb_slot;
+
+    // Les slots les plus bas sont donnés en premier
+    for(Integer slot=m_nb_slot-1 ; slot>=block.m_first_slot ; --slot) {
+      m_free_slots.add(slot);
+    }
+  }
+
+  Integer _blockOf(Integer slot) const {
+    Integer ib = m_blocks.size()-1;
+    while (m_blocks[ib].m_first_slot > slot) {
+      --ib;
+    }
+    return ib;
+  }
+
+  ArrayView<Int64> _slotView(Integer slot, bool on_device) {
+    const Block& block = m_blocks[_blockOf(slot)];
+    NumArray<Int64,1>* buf = (on_device ? block.m_buf_d : block.m_buf_h);
     Integer n = m_nb_addr_per_buf;
-    ArrayView<Int64> view = buf_addr->subView(cur*n, n);
-    cur++;
-    return view;
+    Int64* ptr = buf->to1DSpan().data() + Int64(slot-block.m_first_slot)*n;
+    return ArrayView<Int64>(n, ptr);
   }
 
  protected:
+  ax::Runner* m_runner=nullptr;
   IMeshMaterialMng* m_mesh_mat_mng=nullptr;
-  Ref<ax::RunQueueEvent> m_end_cpy_evt;  //! Event occurs after copy
-  UniqueArray<Int64>* m_buf_addr_h=nullptr;
-  UniqueArray<Int64>* m_buf_addr_d=nullptr;
+  eMemoryRessource m_mem_h;
+  eMemoryRessource m_mem_d;
   Integer m_nb_addr_per_buf=0;
-  Integer m_cur_h=0;
-  Integer m_cur_d=0;
+
+  UniqueArray<Block> m_blocks;  //! Never moved once allocated
+  Integer m_nb_slot=0;  //! Total number of slots of m_blocks
+
+  UniqueArray<Integer> m_free_slots;  //! Slots which can be given
+  UniqueArray<Integer> m_cur_slots_h;  //! Slots given by nextHostView() since the last copy
+  Integer m_nb_cur_d=0;  //! Number of nextDeviceView() since the last copy
+
+  UniqueArray<PendingBatch> m_pending;  //! Batches being copied, oldest first
+  UniqueArray<Ref<ax::RunQueueEvent>> m_free_events;
+  Integer m_max_pending=4;  //! Beyond, the oldest batch is waited for instead of growing
 };
 
 #endif
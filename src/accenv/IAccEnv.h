@@ -4,6 +4,7 @@
 #include <arcane/ItemTypes.h>
 #include "accenv/AcceleratorUtils.h"
 #include "accenv/MultiEnvUtils.h"
+#include "accenv/NodeGather.h"
 #include "msgpass/VarSyncMng.h"
 #include "arcane/UnstructuredMeshConnectivity.h"
 #include "arcane/materials/IMeshMaterialMng.h"
@@ -28,18 +29,26 @@ class IAccEnv {
   virtual UnstructuredMeshConnectivityView& connectivityView() = 0;
   virtual const UnstructuredMeshConnectivityView& connectivityView() const = 0;
 
+  //! Repartitionne le maillage selon les débits calibrés (HP_cost_model), avant toute donnée dépendant du maillage
+  virtual void heterogPartition(IMesh* mesh) = 0;
+
   virtual void initMesh(IMesh* mesh) = 0;
 
   virtual Span<const Int16> nodeIndexInCells() const = 0;
 
   virtual Integer maxNodeCell() const = 0;
 
+  // Table CSR noeud->(maille, index du noeud dans la maille)
+  virtual NodeGatherView nodeGather() const = 0;
+
   virtual void initMultiEnv(IMeshMaterialMng* mesh_material_mng) = 0;
   virtual MultiAsyncRunQueue* multiEnvQueue() = 0;
 
   virtual void computeMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) = 0;
   virtual void checkMultiEnvGlobalCellId(IMeshMaterialMng* mesh_material_mng) = 0;
   virtual void updateMultiEnv(IMeshMaterialMng* mesh_material_mng) = 0;
+  // Seules les mailles changed_cell_lids ont changé de composition en environnements
+  virtual void updateMultiEnv(IMeshMaterialMng* mesh_material_mng, Int32ConstArrayView changed_cell_lids) = 0;
 
   virtual MultiEnvCellStorage* multiEnvCellStorage() = 0;
 
@@ -2,6 +2,7 @@
 #define ACC_ENV_MULTI_ENV_UTILS_H
 
 #include "accenv/AcceleratorUtils.h"
+#include "accenv/AccEnvDefaultOptions.h"
 #include "accenv/BufAddrMng.h"
 
 #include "arcane/MeshVariableScalarRef.h"
@@ -10,11 +11,15 @@
 #include <arcane/IMesh.h>
 #include <arcane/VariableBuildInfo.h>
 #include <arcane/utils/IMemoryRessourceMng.h>
+#include <arcane/utils/FatalErrorException.h>
 
 #include <arcane/materials/ComponentPartItemVectorView.h>
 #include "arcane/materials/IMeshEnvironment.h"
 #include "arcane/materials/MeshMaterialVariableRef.h"
 
+#include <algorithm>
+#include <cmath>
+
 /*---------------------------------------------------------------------------*/
 /* Pour créer une vue sur les valeurs d'un environnement                     */
 /*---------------------------------------------------------------------------*/
@@ -250,6 +255,7 @@ class MultiEnvVarHD {
 
 /*---------------------------------------------------------------------------*/
 /* Vue sur stockage du multi-env                                             */
+/* Mêmes accès quelle que soit la disposition (dense ou CSR) du stockage     */
 /*---------------------------------------------------------------------------*/
 class MultiEnvCellViewIn {
  public:
@@ -257,20 +263,29 @@ class MultiEnvCellViewIn {
       const VariableCellInteger& v_nb_env,
       const UniqueArray<Int16>& v_l_env_arrays_idx,
       const VariableCellArrayInteger& v_l_env_values_idx,
-      const VariableCellInteger& v_env_id) :
+      const VariableCellInteger& v_env_id,
+      bool is_csr,
+      const UniqueArray<Int32>& v_csr_offset,
+      const UniqueArray<EnvVarIndex>& v_csr_evi) :
     m_max_nb_env (max_nb_env),
+    m_is_csr (is_csr),
     m_nb_env_in (ax::viewIn(command,v_nb_env)),
     m_l_env_arrays_idx_in (v_l_env_arrays_idx.constSpan()),
     m_l_env_values_idx_in (ax::viewIn(command,v_l_env_values_idx)),
-    m_env_id_in (ax::viewIn(command,v_env_id))
+    m_env_id_in (ax::viewIn(command,v_env_id)),
+    m_csr_offset_in (v_csr_offset.constSpan()),
+    m_csr_evi_in (v_csr_evi.constSpan())
   {}
 
   ARCCORE_HOST_DEVICE MultiEnvCellViewIn(const MultiEnvCellViewIn& rhs) : 
     m_max_nb_env (rhs.m_max_nb_env),
+    m_is_csr (rhs.m_is_csr),
     m_nb_env_in (rhs.m_nb_env_in),
     m_l_env_arrays_idx_in (rhs.m_l_env_arrays_idx_in),
     m_l_env_values_idx_in (rhs.m_l_env_values_idx_in),
-    m_env_id_in (rhs.m_env_id_in)
+    m_env_id_in (rhs.m_env_id_in),
+    m_csr_offset_in (rhs.m_csr_offset_in),
+    m_csr_evi_in (rhs.m_csr_evi_in)
   {}
 
   ARCCORE_HOST_DEVICE Integer nbEnv(CellLocalId cid) const {
@@ -278,23 +293,35 @@ class MultiEnvCellViewIn {
   }
 
   ARCCORE_HOST_DEVICE EnvVarIndex envCell(CellLocalId cid, Integer ienv) const {
+    if (m_is_csr) {
+      // Maille pure : pas d'entrée dans la liste compacte, 0 référence le tableau global
+      return (m_env_id_in[cid]>=0 ? 
+          EnvVarIndex(0, cid.localId()) :
+          m_csr_evi_in[m_csr_offset_in[cid.localId()]+ienv]);
+    }
     return EnvVarIndex(
         m_l_env_arrays_idx_in[cid.localId()*m_max_nb_env+ienv],
         m_l_env_values_idx_in[cid][ienv]);
   }
 
   ARCCORE_HOST_DEVICE Integer envId(CellLocalId cid, Integer ienv) const {
-    return (m_env_id_in[cid]>=0 ? 
-        m_env_id_in[cid] : 
+    if (m_env_id_in[cid]>=0) {
+      return m_env_id_in[cid];
+    }
+    return (m_is_csr ?
+        m_csr_evi_in[m_csr_offset_in[cid.localId()]+ienv].arrayIndex()-1 :
         m_l_env_arrays_idx_in[cid.localId()*m_max_nb_env+ienv]-1);
   }
 
  protected:
   Integer m_max_nb_env;
+  bool m_is_csr;
   ax::VariableCellInt32InView m_nb_env_in;
   Span<const Int16> m_l_env_arrays_idx_in;
   ax::ItemVariableArrayInViewT<Cell,Int32> m_l_env_values_idx_in;
   ax::VariableCellInt32InView m_env_id_in;
+  Span<const Int32> m_csr_offset_in;
+  Span<const EnvVarIndex> m_csr_evi_in;
 };
 
 /*---------------------------------------------------------------------------*/
@@ -302,21 +329,38 @@ class MultiEnvCellViewIn {
 /*---------------------------------------------------------------------------*/
 class MultiEnvCellStorage {
  public:
-  MultiEnvCellStorage(IMeshMaterialMng* mm, AccMemAdviser* acc_mem_adv) :
+  MultiEnvCellStorage(IMeshMaterialMng* mm, AccMemAdviser* acc_mem_adv,
+      eMultiEnvCellLayout layout=MEL_dense) :
     m_mesh_material_mng (mm),
+    m_acc_mem_adv (acc_mem_adv),
+    m_layout (layout),
     m_max_nb_env (mm->environments().size()),
     m_nb_env(VariableBuildInfo(mm->mesh(), "NbEnv" , IVariable::PNoDump| IVariable::PNoNeedSync)),
     m_l_env_arrays_idx(platform::getAcceleratorHostMemoryAllocator()),
     m_l_env_values_idx(VariableBuildInfo(mm->mesh(), "LEnvValuesIdx" , IVariable::PNoDump| IVariable::PNoNeedSync | IVariable::PSubDomainDepend)),
     m_env_id(VariableBuildInfo(mm->mesh(), "EnvId" , IVariable::PNoDump| IVariable::PNoNeedSync))
   {
-    m_l_env_arrays_idx.resize(m_max_nb_env*mm->mesh()->allCells().size());
-    acc_mem_adv->setReadMostly(m_l_env_arrays_idx.view());
-    m_l_env_values_idx.resize(m_max_nb_env);
+    if (m_layout==MEL_csr) {
+      // Seules les mailles mixtes ont des entrées, allouées par buildStorage
+      m_csr_offset.resize(mm->mesh()->allCells().size());
+    } else {
+      m_l_env_arrays_idx.resize(m_max_nb_env*mm->mesh()->allCells().size());
+      acc_mem_adv->setReadMostly(m_l_env_arrays_idx.view());
+      m_l_env_values_idx.resize(m_max_nb_env);
+    }
+    m_changed_marker.resize(mm->mesh()->allCells().size());
+    m_changed_marker.fill(0);
   }
 
+  //! Disposition du stockage
+  eMultiEnvCellLayout layout() const { return m_layout; }
+
   //! Remplissage
   void buildStorage(ax::Runner& runner, Materials::MaterialVariableCellInteger& v_global_cell) {
+    if (m_layout==MEL_csr) {
+      _buildCsrStorage(runner, v_global_cell);
+      return;
+    }
     PROF_ACC_BEGIN(__FUNCTION__);
 
     auto queue = makeQueue(runner);
@@ -400,6 +444,103 @@ class MultiEnvCellStorage {
     PROF_ACC_END;
   }
 
+  /*!
+   * \brief Mise à jour des seules mailles changed_cell_lids dont la composition
+   * en environnements a changé
+   *
+   * m_env_id et v_global_cell doivent être à jour sur ces mailles. Les entrées
+   * des autres mailles sont conservées, seuls leurs indices dans les listes de
+   * mailles mixtes sont recopiés car le compactage des environnements modifiés
+   * a pu les déplacer. Les listes de mailles pures ne sont pas parcourues.
+   */
+  void updateStorage(ax::Runner& runner, Materials::MaterialVariableCellInteger& v_global_cell,
+      Int32ConstArrayView changed_cell_lids) {
+    if (m_layout==MEL_csr) {
+      // Les décalages de toutes les mailles suivantes changent
+      _buildCsrStorage(runner, v_global_cell);
+      return;
+    }
+    PROF_ACC_BEGIN(__FUNCTION__);
+
+    // Copie accessible depuis l'accélérateur et marquage des mailles modifiées
+    m_changed_lids.copy(changed_cell_lids);
+    for(Int32 lid : changed_cell_lids) {
+      m_changed_marker[lid] = 1;
+    }
+    Integer nb_changed = m_changed_lids.size();
+
+    auto queue = makeQueue(runner);
+    {
+      auto command = makeCommand(queue);
+
+      Span<const Int32> in_changed_lids(m_changed_lids.constSpan());
+      auto in_env_id = ax::viewIn(command, m_env_id);
+      auto out_nb_env = ax::viewOut(command, m_nb_env);
+      auto out_l_env_values_idx = ax::viewOut(command, m_l_env_values_idx);
+      auto out_l_env_arrays_idx = m_l_env_arrays_idx.span();
+      Integer max_nb_env = m_max_nb_env;
+
+      command << RUNCOMMAND_LOOP1(iter, nb_changed) {
+        CellLocalId cid(in_changed_lids[iter()[0]]);
+        if (in_env_id[cid]>=0) {
+          // Maille pure : remplie ici, 0 référence le tableau global
+          out_l_env_arrays_idx[cid*max_nb_env] = 0;
+          out_l_env_values_idx[cid][0] = cid.localId();
+          out_nb_env[cid] = 1;
+        } else {
+          // Maille mixte ou vide, remplie par les boucles sur les environnements
+          out_nb_env[cid] = 0;
+        }
+      };
+    }
+
+    Integer max_nb_env = m_max_nb_env; // on ne peut pas utiliser un attribut dans le kernel
+    ENUMERATE_ENV(ienv, m_mesh_material_mng) {
+      IMeshEnvironment* env = *ienv;
+      Integer env_id = env->id();
+
+      auto command = makeCommand(queue);
+
+      Span<const Int16> in_changed_marker(m_changed_marker.constSpan());
+      auto inout_nb_env = ax::viewInOut(command, m_nb_env);
+      auto out_l_env_values_idx = ax::viewOut(command, m_l_env_values_idx);
+      auto inout_l_env_arrays_idx = m_l_env_arrays_idx.span();
+
+      Span<const Integer> in_global_cell(envView(v_global_cell, env));
+
+      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      Integer nb_imp = in_imp_idx.size();
+
+      command << RUNCOMMAND_LOOP1(iter, nb_imp) {
+        auto imix = in_imp_idx[iter()[0]]; // iter()[0] \in [0,nb_imp[
+        CellLocalId cid(in_global_cell[imix]); // on récupère l'identifiant de la maille globale
+
+        Integer nb_env_cell = inout_nb_env[cid];
+        if (in_changed_marker[cid]) {
+          // Maille modifiée : même remplissage que buildStorage
+          inout_l_env_arrays_idx[cid*max_nb_env+nb_env_cell] = env_id+1;
+          out_l_env_values_idx[cid][nb_env_cell] = imix;
+          inout_nb_env[cid] = nb_env_cell+1;
+        } else {
+          // Maille inchangée : l'indice imix a pu être déplacé
+          for(Integer ienv=0 ; ienv<nb_env_cell ; ++ienv) {
+            if (inout_l_env_arrays_idx[cid*max_nb_env+ienv]==env_id+1) {
+              out_l_env_values_idx[cid][ienv] = imix;
+            }
+          }
+        }
+      };
+    }
+    queue.barrier();
+
+    for(Int32 lid : changed_cell_lids) {
+      m_changed_marker[lid] = 0;
+    }
+
+    checkStorage(v_global_cell);
+    PROF_ACC_END;
+  }
+
   //! Verification
   void checkStorage([[maybe_unused]] Materials::MaterialVariableCellInteger& v_global_cell) {
 #ifdef ARCANE_DEBUG
@@ -417,9 +558,14 @@ class MultiEnvCellStorage {
       ARCANE_ASSERT(nb_env_bis==nb_env, ("nb_env_bis!=nb_env"));
 
       for(Integer ienv=0 ; ienv<nb_env ; ++ienv) {
-        Integer i=m_l_env_arrays_idx[cid*m_max_nb_env+ienv];
-        Integer j=m_l_env_values_idx[icell][ienv];
-        EnvVarIndex evi(i,j);
+        EnvVarIndex evi;
+        if (m_layout==MEL_csr) {
+          evi = (m_env_id[cell]>=0 ? EnvVarIndex(0, cid) : m_csr_evi[m_csr_offset[cid]+ienv]);
+        } else {
+          Integer i=m_l_env_arrays_idx[cid*m_max_nb_env+ienv];
+          Integer j=m_l_env_values_idx[icell][ienv];
+          evi = EnvVarIndex(i,j);
+        }
 
         Integer cid_bis=in_menv_global_cell[evi];
         ARCANE_ASSERT(cid_bis==cid, ("cid_bis!=cid"));
@@ -429,18 +575,260 @@ class MultiEnvCellStorage {
 #endif
   }
 
+  /*!
+   * \brief Vérifie que le stockage courant (ex : issu de updateStorage) est
+   * celui que produit buildStorage, à l'ordre des environnements près dans
+   * chaque maille. Le stockage est reconstruit par buildStorage au passage.
+   */
+  void checkSameAsBuild([[maybe_unused]] ax::Runner& runner, 
+      [[maybe_unused]] Materials::MaterialVariableCellInteger& v_global_cell) {
+#ifdef ARCANE_DEBUG
+    PROF_ACC_BEGIN(__FUNCTION__);
+    UniqueArray<Integer> cur_offset, ref_offset;
+    UniqueArray<Int64> cur_evis, ref_evis;
+    _hostSnapshot(cur_offset, cur_evis);
+    buildStorage(runner, v_global_cell);
+    _hostSnapshot(ref_offset, ref_evis);
+
+    Integer icell=0;
+    ENUMERATE_CELL(icell_i, m_mesh_material_mng->mesh()->allCells()) {
+      Integer cur_nb = cur_offset[icell+1]-cur_offset[icell];
+      Integer ref_nb = ref_offset[icell+1]-ref_offset[icell];
+      bool is_same = (cur_nb==ref_nb);
+      for(Integer ienv=0 ; is_same && ienv<cur_nb ; ++ienv) {
+        is_same = (cur_evis[cur_offset[icell]+ienv]==ref_evis[ref_offset[icell]+ienv]);
+      }
+      if (!is_same) {
+        ARCANE_FATAL("Stockage multi-env different de buildStorage pour la maille lid={0}", icell_i.localId());
+      }
+      ++icell;
+    }
+    PROF_ACC_END;
+#endif
+  }
+
   //! Vue sur le stockage pour utilisation en lecture sur GPU
   MultiEnvCellViewIn viewIn(ax::RunCommand& command) {
-    return MultiEnvCellViewIn(command, m_max_nb_env, m_nb_env, m_l_env_arrays_idx, m_l_env_values_idx, m_env_id);
+    return MultiEnvCellViewIn(command, m_max_nb_env, m_nb_env, m_l_env_arrays_idx, m_l_env_values_idx, m_env_id,
+        m_layout==MEL_csr, m_csr_offset, m_csr_evi);
+  }
+
+ protected:
+
+  /*!
+   * \brief Copie sur l'hôte des EnvVarIndex de chaque maille (arrayIndex en
+   * poids fort, valueIndex en poids faible), triés dans chaque maille
+   */
+  void _hostSnapshot(Array<Integer>& offset, Array<Int64>& evis) {
+    offset.clear();
+    evis.clear();
+    ENUMERATE_CELL(icell, m_mesh_material_mng->mesh()->allCells()){
+      Integer cid = icell.localId();
+      offset.add(evis.size());
+      for(Integer ienv=0 ; ienv<m_nb_env[icell] ; ++ienv) {
+        EnvVarIndex evi;
+        if (m_layout==MEL_csr) {
+          evi = (m_env_id[icell]>=0 ? EnvVarIndex(0, cid) : m_csr_evi[m_csr_offset[cid]+ienv]);
+        } else {
+          evi = EnvVarIndex(m_l_env_arrays_idx[cid*m_max_nb_env+ienv], m_l_env_values_idx[icell][ienv]);
+        }
+        evis.add((Int64(evi.arrayIndex())<<32) | Int64(UInt32(evi.valueIndex())));
+      }
+      std::sort(evis.begin()+offset.back(), evis.end());
+    }
+    offset.add(evis.size());
+  }
+
+  /*!
+   * \brief Remplissage de la disposition CSR
+   *
+   * Comptage des environnements des mailles mixtes, décalages par somme
+   * préfixe sur l'hôte, puis remplissage des paires (env_id+1, imix).
+   * Les mailles pures n'ont aucune entrée.
+   */
+  void _buildCsrStorage(ax::Runner& runner, Materials::MaterialVariableCellInteger& v_global_cell) {
+    PROF_ACC_BEGIN(__FUNCTION__);
+
+    auto queue = makeQueue(runner);
+    {
+      auto command = makeCommand(queue);
+
+      auto in_env_id = ax::viewIn(command, m_env_id);
+      auto out_nb_env = ax::viewOut(command, m_nb_env);
+
+      command << RUNCOMMAND_ENUMERATE(Cell, cid, m_mesh_material_mng->mesh()->allCells()){
+        // Une maille pure n'a qu'un environnement
+        out_nb_env[cid] = (in_env_id[cid]>=0 ? 1 : 0);
+      };
+    }
+    // Comptage des environnements des mailles mixtes
+    ENUMERATE_ENV(ienv, m_mesh_material_mng) {
+      IMeshEnvironment* env = *ienv;
+
+      auto command = makeCommand(queue);
+
+      auto inout_nb_env = ax::viewInOut(command, m_nb_env);
+      Span<const Integer> in_global_cell(envView(v_global_cell, env));
+
+      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      Integer nb_imp = in_imp_idx.size();
+
+      command << RUNCOMMAND_LOOP1(iter, nb_imp) {
+        auto imix = in_imp_idx[iter()[0]]; // iter()[0] \in [0,nb_imp[
+        CellLocalId cid(in_global_cell[imix]);
+        inout_nb_env[cid] = inout_nb_env[cid]+1; // ++ n'est pas supporté
+      };
+    }
+    queue.barrier();
+
+    // Décalages des mailles mixtes dans m_csr_evi
+    Int32 nb_evi = 0;
+    ENUMERATE_CELL(icell, m_mesh_material_mng->mesh()->allCells()) {
+      m_csr_offset[icell.localId()] = nb_evi;
+      if (m_env_id[icell]<0) {
+        nb_evi += m_nb_env[icell];
+      }
+    }
+    m_csr_evi.resize(nb_evi);
+    m_acc_mem_adv->setReadMostly(m_csr_evi.view());
+    m_acc_mem_adv->setReadMostly(m_csr_offset.view());
+
+    // Remplissage, m_nb_env des mailles mixtes sert de curseur et retrouve sa valeur
+    {
+      auto command = makeCommand(queue);
+
+      auto in_env_id = ax::viewIn(command, m_env_id);
+      auto out_nb_env = ax::viewOut(command, m_nb_env);
+
+      command << RUNCOMMAND_ENUMERATE(Cell, cid, m_mesh_material_mng->mesh()->allCells()){
+        if (in_env_id[cid]<0) {
+          out_nb_env[cid] = 0;
+        }
+      };
+    }
+    ENUMERATE_ENV(ienv, m_mesh_material_mng) {
+      IMeshEnvironment* env = *ienv;
+      Integer env_id = env->id();
+
+      auto command = makeCommand(queue);
+
+      auto inout_nb_env = ax::viewInOut(command, m_nb_env);
+      Span<const Int32> in_csr_offset(m_csr_offset.constSpan());
+      Span<EnvVarIndex> out_csr_evi(m_csr_evi.span());
+      Span<const Integer> in_global_cell(envView(v_global_cell, env));
+
+      Span<const Int32> in_imp_idx(env->impureEnvItems().valueIndexes());
+      Integer nb_imp = in_imp_idx.size();
+
+      command << RUNCOMMAND_LOOP1(iter, nb_imp) {
+        auto imix = in_imp_idx[iter()[0]]; // iter()[0] \in [0,nb_imp[
+        CellLocalId cid(in_global_cell[imix]);
+
+        Integer index_cell = inout_nb_env[cid];
+        out_csr_evi[in_csr_offset[cid.localId()]+index_cell] = EnvVarIndex(env_id+1, imix); // +1 car 0 est pris pour global
+        inout_nb_env[cid] = index_cell+1;
+      };
+    }
+    queue.barrier();
+
+    checkStorage(v_global_cell);
+    PROF_ACC_END;
   }
 
  protected:
   IMeshMaterialMng* m_mesh_material_mng=nullptr;
+  AccMemAdviser* m_acc_mem_adv=nullptr;
+  eMultiEnvCellLayout m_layout=MEL_dense;
   Integer m_max_nb_env;
   VariableCellInteger m_nb_env;  //! Nb d'env par maille
   UniqueArray<Int16> m_l_env_arrays_idx; //! liste des indexes des env par maille
   VariableCellArrayInteger m_l_env_values_idx;
   VariableCellInteger m_env_id;
+
+  // Disposition CSR : paires (env_id+1, imix) des seules mailles mixtes
+  UniqueArray<Int32> m_csr_offset{platform::getAcceleratorHostMemoryAllocator()}; //! début des paires de chaque maille
+  UniqueArray<EnvVarIndex> m_csr_evi{platform::getAcceleratorHostMemoryAllocator()};
+
+  // Pour updateStorage
+  UniqueArray<Int16> m_changed_marker{platform::getAcceleratorHostMemoryAllocator()}; //! 1 si la maille a changé
+  UniqueArray<Int32> m_changed_lids{platform::getAcceleratorHostMemoryAllocator()}; //! mailles modifiées
+};
+
+/*---------------------------------------------------------------------------*/
+/* Affectation des environnements aux queues selon leur coût estimé          */
+/*---------------------------------------------------------------------------*/
+class MultiEnvQueueSchedule {
+ public:
+  /*!
+   * \brief Coût d'un environnement = nb de mailles impures x weight
+   * Un environnement plus coûteux que la charge moyenne d'une queue est
+   * découpé en tranches contiguës de mailles impures de coût au plus égal
+   * à cette charge moyenne (sinon, il resterait le chemin critique).
+   * Les tranches (lancements) sont ensuite réparties sur les queues par LPT
+   */
+  MultiEnvQueueSchedule(MultiAsyncRunQueue* menv_queue, IMeshMaterialMng* mm, Real weight=1.) :
+    m_menv_queue (menv_queue),
+    m_mesh_material_mng (mm)
+  {
+    Integer nb_env = mm->environments().size();
+    Real sum_cost = 0.;
+    for(IMeshEnvironment* env : mm->environments()) {
+      sum_cost += weight*env->impureEnvItems().nbItem();
+    }
+    Real queue_cost = sum_cost/m_menv_queue->nbQueue();
+
+    UniqueArray<Real> costs;
+    for(Integer env_id=0 ; env_id<nb_env ; ++env_id) {
+      Integer nb_imp = mm->environments()[env_id]->impureEnvItems().nbItem();
+      Real env_cost = weight*nb_imp;
+      Integer nb_chunk = 1;
+      if (queue_cost>0. && env_cost>queue_cost) {
+        nb_chunk = std::min(Integer(std::ceil(env_cost/queue_cost)), nb_imp);
+      }
+      // Tranches de tailles égales à 1 près
+      for(Integer ichunk=0 ; ichunk<nb_chunk ; ++ichunk) {
+        Integer beg = (Int64(nb_imp)*ichunk)/nb_chunk;
+        Integer end = (Int64(nb_imp)*(ichunk+1))/nb_chunk;
+        m_launch_env.add(env_id);
+        m_launch_beg.add(beg);
+        m_launch_size.add(end-beg);
+        costs.add(weight*(end-beg));
+      }
+    }
+    Integer nb_launch = costs.size();
+    m_queue_ids.resize(nb_launch);
+    m_launch_order.resize(nb_launch);
+    m_menv_queue->scheduleByCost(costs, m_queue_ids, m_launch_order);
+  }
+
+  //! Nb de lancements (tranches d'environnements)
+  Integer nbLaunch() const { return m_launch_order.size(); }
+
+  //! Environnement du lancement de rang i (les plus coûteux en premier)
+  IMeshEnvironment* env(Integer i) const {
+    return m_mesh_material_mng->environments()[m_launch_env[m_launch_order[i]]];
+  }
+
+  //! Indices des valeurs des mailles impures de env(i) traitées par le lancement de rang i
+  Span<const Int32> impureValueIndexes(Integer i) const {
+    Integer ilaunch = m_launch_order[i];
+    Span<const Int32> imp_idx(env(i)->impureEnvItems().valueIndexes());
+    return imp_idx.subspan(m_launch_beg[ilaunch], m_launch_size[ilaunch]);
+  }
+
+  //! Queue sur laquelle lancer les calculs du lancement de rang i
+  ax::RunQueue& queue(Integer i) {
+    return m_menv_queue->queue(m_queue_ids[m_launch_order[i]]);
+  }
+
+ protected:
+  MultiAsyncRunQueue* m_menv_queue=nullptr;
+  IMeshMaterialMng* m_mesh_material_mng=nullptr;
+  UniqueArray<Integer> m_launch_env;   //! environnement de chaque lancement
+  UniqueArray<Integer> m_launch_beg;   //! 1ere maille impure de chaque lancement
+  UniqueArray<Integer> m_launch_size;  //! nb de mailles impures de chaque lancement
+  UniqueArray<Integer> m_queue_ids;  //! queue de chaque lancement
+  UniqueArray<Integer> m_launch_order;
 };
 
 #endif
@@ -0,0 +1,251 @@
+#ifndef ACC_ENV_NODE_GATHER_H
+#define ACC_ENV_NODE_GATHER_H
+
+#include "accenv/AcceleratorUtils.h"
+
+#include <arcane/UnstructuredMeshConnectivity.h>
+#include <arcane/Concurrency.h>
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/PlatformUtils.h>
+
+using namespace Arcane;
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+//! Reduction of the contributions by sum
+struct GatherSum {
+  template<typename T>
+  ARCCORE_HOST_DEVICE T operator()(const T& a, const T& b) const {
+    return a+b;
+  }
+};
+
+//! Contributions subtracted from the initial value
+struct GatherSub {
+  template<typename T>
+  ARCCORE_HOST_DEVICE T operator()(const T& a, const T& b) const {
+    return a-b;
+  }
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Read-only view on the node->(cell, corner) table of a NodeGatherEngine
+ *
+ * Trivially copyable : can be captured by value in a RUNCOMMAND kernel or
+ * used by host threads. corner is the local index of the node in the cell.
+ */
+class NodeGatherView {
+ public:
+  NodeGatherView(Span<const Int32> offsets, Span<const Int32> cells, Span<const Int16> corners) :
+    m_offsets (offsets),
+    m_cells (cells),
+    m_corners (corners)
+  {}
+
+  //! Number of (cell, corner) contributions to node nid
+  ARCCORE_HOST_DEVICE Int32 nbContrib(NodeLocalId nid) const {
+    return m_offsets[nid.localId()+1]-m_offsets[nid.localId()];
+  }
+
+  //! Contributions of nid are at positions [begin(nid), end(nid)[
+  ARCCORE_HOST_DEVICE Int32 begin(NodeLocalId nid) const {
+    return m_offsets[nid.localId()];
+  }
+  ARCCORE_HOST_DEVICE Int32 end(NodeLocalId nid) const {
+    return m_offsets[nid.localId()+1];
+  }
+
+  ARCCORE_HOST_DEVICE CellLocalId cell(Int32 pos) const {
+    return CellLocalId(m_cells[pos]);
+  }
+  ARCCORE_HOST_DEVICE Int16 corner(Int32 pos) const {
+    return m_corners[pos];
+  }
+
+  /*!
+   * \brief Reduction by op, starting from init, of value_func(cid, corner)
+   * over the contributions of nid, always in the order of the table
+   * (same result on host and device)
+   */
+  template<typename T, typename ValueFunc, typename ReduceOp=GatherSum>
+  ARCCORE_HOST_DEVICE T gather(NodeLocalId nid, T init, const ValueFunc& value_func,
+      const ReduceOp& op=ReduceOp()) const {
+    T acc = init;
+    Int32 pos_end = end(nid);
+    for(Int32 pos=begin(nid) ; pos<pos_end ; ++pos) {
+      acc = op(acc, value_func(CellLocalId(m_cells[pos]), m_corners[pos]));
+    }
+    return acc;
+  }
+
+ protected:
+  Span<const Int32> m_offsets;  //! nb_node+1 offsets in m_cells/m_corners
+  Span<const Int32> m_cells;
+  Span<const Int16> m_corners;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief CSR table node->(cell, corner) built once per mesh
+ *
+ * Replaces the hand-written loops over node->cells() combined with
+ * nodeIndexInCells() : the contributions of a node are contiguous, with
+ * no padding up to maxNodeCell(). The cells of each node can be sorted
+ * by increasing local id, which makes the reads of cell values closer
+ * in memory for neighbouring nodes (but changes the order of the sums).
+ * The arrays are allocated in memory accessible from host and device.
+ */
+class NodeGatherEngine {
+ public:
+  NodeGatherEngine() :
+    m_offsets (platform::getAcceleratorHostMemoryAllocator()),
+    m_cells (platform::getAcceleratorHostMemoryAllocator()),
+    m_corners (platform::getAcceleratorHostMemoryAllocator()),
+    m_nodes (platform::getAcceleratorHostMemoryAllocator())
+  {}
+
+  //! True if the table was built for this mesh timestamp and sorting
+  bool isUpToDate(Int64 mesh_timestamp, bool sort_cells) const {
+    return mesh_timestamp==m_timestamp && sort_cells==m_sort_cells;
+  }
+
+  /*!
+   * \brief (Re)build the table of all the nodes of the mesh of cty
+   * nodes must be allNodes() (nodes indexed by their local id)
+   */
+  void build(const UnstructuredMeshConnectivityView& cty, NodeGroup nodes,
+      Int64 mesh_timestamp, bool sort_cells) {
+    auto nc_cty = cty.nodeCell();
+    auto cn_cty = cty.cellNode();
+    Integer nb_node = nodes.size();
+
+    // Offsets : somme préfixe du nb de mailles de chaque noeud
+    m_offsets.resize(nb_node+1);
+    m_offsets[0] = 0;
+    m_nodes.clear();
+    for(Integer inode=0 ; inode<nb_node ; ++inode) {
+      Int32 nb_contrib = nc_cty.cells(NodeLocalId(inode)).size();
+      if (nb_contrib>0) {
+        m_nodes.add(inode);
+      }
+      m_offsets[inode+1] = m_offsets[inode] + nb_contrib;
+    }
+    m_cells.resize(m_offsets[nb_node]);
+    m_corners.resize(m_offsets[nb_node]);
+
+    ParallelLoopOptions options;
+    options.setPartitioner(ParallelLoopOptions::Partitioner::Auto);
+
+    // Chaque noeud remplit ses propres positions : pas de conflit d'écriture
+    arcaneParallelForeach(nodes, options, [&](NodeVectorView sub_nodes) {
+      ENUMERATE_NODE(inode, sub_nodes) {
+        NodeLocalId nid(inode.localId());
+        Int32 first_pos = m_offsets[nid.localId()];
+        Int32 pos = first_pos;
+        for( CellLocalId cid : nc_cty.cells(nid) ){
+          Int16 corner = 0;
+          for( NodeLocalId cell_node : cn_cty.nodes(cid) ){
+            if (cell_node==nid)
+              break;
+            ++corner;
+          }
+          // Tri par insertion (quelques mailles par noeud)
+          Int32 ins = pos;
+          if (sort_cells) {
+            for( ; ins>first_pos && m_cells[ins-1]>cid.localId() ; --ins) {
+              m_cells[ins] = m_cells[ins-1];
+              m_corners[ins] = m_corners[ins-1];
+            }
+          }
+          m_cells[ins] = cid.localId();
+          m_corners[ins] = corner;
+          ++pos;
+        }
+      }
+    });
+    m_timestamp = mesh_timestamp;
+    m_sort_cells = sort_cells;
+  }
+
+  /*!
+   * \brief (Re)build the table restricted to the contributions of the cells
+   * of cells, nb_node being allNodes().size()
+   *
+   * The contributions of each node are in the order of cells : a gather with
+   * this table performs, for each node, the same operations in the same
+   * order as a scatter ENUMERATE_CELL(cells) / ENUMERATE_NODE(cell->nodes())
+   */
+  void buildFromCells(const UnstructuredMeshConnectivityView& cty, Integer nb_node,
+      CellVectorView cells, Int64 mesh_timestamp) {
+    auto cn_cty = cty.cellNode();
+
+    // Nb de contributions de chaque noeud, rangé en inode+1 pour la somme préfixe
+    m_offsets.resize(nb_node+1);
+    m_offsets.fill(0);
+    ENUMERATE_CELL(icell, cells) {
+      for( NodeLocalId nid : cn_cty.nodes(CellLocalId(icell.localId())) ){
+        m_offsets[nid.localId()+1]++;
+      }
+    }
+    m_nodes.clear();
+    for(Integer inode=0 ; inode<nb_node ; ++inode) {
+      if (m_offsets[inode+1]>0) {
+        m_nodes.add(inode);
+      }
+      m_offsets[inode+1] += m_offsets[inode];
+    }
+    m_cells.resize(m_offsets[nb_node]);
+    m_corners.resize(m_offsets[nb_node]);
+
+    // Remplissage séquentiel dans l'ordre de cells
+    UniqueArray<Int32> cursor(m_offsets.subConstView(0, nb_node));
+    ENUMERATE_CELL(icell, cells) {
+      CellLocalId cid(icell.localId());
+      Int16 corner = 0;
+      for( NodeLocalId nid : cn_cty.nodes(cid) ){
+        Int32 pos = cursor[nid.localId()]++;
+        m_cells[pos] = cid.localId();
+        m_corners[pos] = corner++;
+      }
+    }
+    m_timestamp = mesh_timestamp;
+    m_sort_cells = false;
+  }
+
+  //! Advices for unified memory : the table is only read by the kernels
+  void setReadMostly(AccMemAdviser* acc_mem_adv) {
+    acc_mem_adv->setReadMostly(m_offsets.view());
+    acc_mem_adv->setReadMostly(m_cells.view());
+    acc_mem_adv->setReadMostly(m_corners.view());
+    acc_mem_adv->setReadMostly(m_nodes.view());
+  }
+
+  //! Total number of (cell, corner) contributions
+  Integer nbContrib() const {
+    return m_cells.size();
+  }
+
+  //! Local ids of the nodes with at least one contribution
+  Span<const Int32> nodes() const {
+    return m_nodes.constSpan();
+  }
+
+  NodeGatherView view() const {
+    return NodeGatherView(m_offsets.constSpan(), m_cells.constSpan(), m_corners.constSpan());
+  }
+
+ protected:
+  UniqueArray<Int32> m_offsets;
+  UniqueArray<Int32> m_cells;
+  UniqueArray<Int16> m_corners;
+  UniqueArray<Int32> m_nodes;
+
+  Int64 m_timestamp=-1;  //! mesh()->timestamp() when built
+  bool m_sort_cells=false;
+};
+
+#endif
+
@@ -0,0 +1,222 @@
+#include "accenv/NumaTopology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef ACCENV_HWLOC
+#include <hwloc.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Lecture d'une liste de CPUs au format sysfs ("0-3,8,10-11")               */
+/*---------------------------------------------------------------------------*/
+static UniqueArray<Integer> _parseCpuList(const std::string& cpu_list) {
+  UniqueArray<Integer> cpus;
+  std::istringstream iss(cpu_list);
+  std::string range;
+  while (std::getline(iss, range, ',')) {
+    if (range.empty() || range=="\n") {
+      continue;
+    }
+    size_t dash = range.find('-');
+    Integer first = std::stoi(range.substr(0, dash));
+    Integer last = (dash==std::string::npos ? first : std::stoi(range.substr(dash+1)));
+    for(Integer cpu=first ; cpu<=last ; ++cpu) {
+      cpus.add(cpu);
+    }
+  }
+  return cpus;
+}
+
+/*---------------------------------------------------------------------------*/
+/* \class NumaTopology                                                       */
+/* \brief NUMA domains of the node and their CPUs                            */
+/*---------------------------------------------------------------------------*/
+
+NumaTopology::NumaTopology() {
+  _discoverHwloc();
+  if (!isAvailable()) {
+    _discoverSysfs();
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Découverte avec hwloc (si disponible)                                     */
+/*---------------------------------------------------------------------------*/
+void NumaTopology::_discoverHwloc() {
+#ifdef ACCENV_HWLOC
+  hwloc_topology_t topology;
+  if (hwloc_topology_init(&topology)<0) {
+    return;
+  }
+  if (hwloc_topology_load(topology)<0) {
+    hwloc_topology_destroy(topology);
+    return;
+  }
+  int nb_node = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_NUMANODE);
+  for(int inode=0 ; inode<nb_node ; ++inode) {
+    hwloc_obj_t node = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NUMANODE, inode);
+    UniqueArray<Integer> cpus;
+    unsigned int cpu;
+    hwloc_bitmap_foreach_begin(cpu, node->cpuset) {
+      cpus.add(cpu);
+    } hwloc_bitmap_foreach_end();
+    m_node_os_index.add(node->os_index);
+    m_node_cpus.add(cpus);
+  }
+  hwloc_topology_destroy(topology);
+  if (!m_node_cpus.empty()) {
+    m_method = "hwloc";
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Découverte par lecture de /sys/devices/system/node/node<N>/cpulist        */
+/*---------------------------------------------------------------------------*/
+void NumaTopology::_discoverSysfs() {
+#ifdef __linux__
+  const std::string sys_node_dir("/sys/devices/system/node");
+  DIR* dir = opendir(sys_node_dir.c_str());
+  if (!dir) {
+    return;
+  }
+  UniqueArray<Integer> os_indexes;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name.size()>4 && name.compare(0, 4, "node")==0 &&
+        std::all_of(name.begin()+4, name.end(), ::isdigit)) {
+      os_indexes.add(std::stoi(name.substr(4)));
+    }
+  }
+  closedir(dir);
+  std::sort(os_indexes.begin(), os_indexes.end());
+
+  for(Integer os_index : os_indexes) {
+    std::ifstream ifs(sys_node_dir+"/node"+std::to_string(os_index)+"/cpulist");
+    std::string cpu_list;
+    if (!ifs || !std::getline(ifs, cpu_list)) {
+      continue;
+    }
+    UniqueArray<Integer> cpus = _parseCpuList(cpu_list);
+    if (cpus.empty()) {
+      continue;  // domaine mémoire sans CPU (ex : HBM)
+    }
+    m_node_os_index.add(os_index);
+    m_node_cpus.add(cpus);
+  }
+  if (!m_node_cpus.empty()) {
+    m_method = "sysfs";
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+Integer NumaTopology::_nodeFromOsIndex(Integer os_index) const {
+  for(Integer inode=0 ; inode<nbNode() ; ++inode) {
+    if (m_node_os_index[inode]==os_index) {
+      return inode;
+    }
+  }
+  return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Domaine le plus proche d'un périphérique PCI (lu dans sysfs dans les deux */
+/* cas, hwloc donnant la même information)                                   */
+/*---------------------------------------------------------------------------*/
+Integer NumaTopology::pciDeviceNode([[maybe_unused]] const String& pci_bus_id) const {
+#ifdef __linux__
+  // sysfs utilise des minuscules, CUDA/HIP des majuscules
+  std::string bus_id(pci_bus_id.localstr());
+  std::transform(bus_id.begin(), bus_id.end(), bus_id.begin(), ::tolower);
+  std::ifstream ifs("/sys/bus/pci/devices/"+bus_id+"/numa_node");
+  Integer os_index = -1;
+  if (ifs >> os_index && os_index>=0) {
+    return _nodeFromOsIndex(os_index);
+  }
+#endif
+  return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+Integer NumaTopology::currentNode() const {
+#ifdef __linux__
+  Integer cpu = sched_getcpu();
+  for(Integer inode=0 ; inode<nbNode() ; ++inode) {
+    if (m_node_cpus[inode].contains(cpu)) {
+      return inode;
+    }
+  }
+#endif
+  return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Le thread appelant ne s'exécute plus que sur les CPUs du domaine inode et */
+/* y alloue préférentiellement sa mémoire                                    */
+/*---------------------------------------------------------------------------*/
+bool NumaTopology::bindCurrentThread([[maybe_unused]] Integer inode) const {
+#ifdef __linux__
+  if (inode<0 || inode>=nbNode()) {
+    return false;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for(Integer cpu : m_node_cpus[inode]) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set)!=0) {
+    return false;
+  }
+
+  // Politique mémoire "preferred" : les pages touchées ensuite sont allouées
+  // sur le domaine, sans échec si celui-ci est plein
+  const int mpol_preferred = 1;  // MPOL_PREFERRED de <numaif.h>
+  const Integer nb_bits = 8*sizeof(unsigned long);
+  UniqueArray<unsigned long> node_mask(m_node_os_index[inode]/nb_bits+1, 0ul);
+  Integer os_index = m_node_os_index[inode];
+  node_mask[os_index/nb_bits] |= (1ul << (os_index%nb_bits));
+  syscall(SYS_set_mempolicy, mpol_preferred, node_mask.data(), node_mask.size()*nb_bits+1);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Migre sur le domaine inode les pages du processus déjà allouées sur les   */
+/* autres domaines (ex : variables du maillage touchées avant le placement). */
+/* Les pages verrouillées (buffers épinglés) ne sont pas déplacées           */
+/*---------------------------------------------------------------------------*/
+Int64 NumaTopology::migrateCurrentProcess([[maybe_unused]] Integer inode) const {
+#ifdef __linux__
+  if (inode<0 || inode>=nbNode()) {
+    return -1;
+  }
+  const Integer nb_bits = 8*sizeof(unsigned long);
+  Integer max_os_index = *std::max_element(m_node_os_index.begin(), m_node_os_index.end());
+  UniqueArray<unsigned long> old_mask(max_os_index/nb_bits+1, 0ul);
+  UniqueArray<unsigned long> new_mask(max_os_index/nb_bits+1, 0ul);
+  for(Integer os_index : m_node_os_index) {
+    UniqueArray<unsigned long>& mask = (os_index==m_node_os_index[inode] ? new_mask : old_mask);
+    mask[os_index/nb_bits] |= (1ul << (os_index%nb_bits));
+  }
+  long nb_unmoved = syscall(SYS_migrate_pages, 0, old_mask.size()*nb_bits+1,
+      old_mask.data(), new_mask.data());
+  return (nb_unmoved<0 ? -1 : Int64(nb_unmoved));
+#else
+  return -1;
+#endif
+}
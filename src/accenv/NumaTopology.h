@@ -0,0 +1,63 @@
+#ifndef ACC_ENV_NUMA_TOPOLOGY_H
+#define ACC_ENV_NUMA_TOPOLOGY_H
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/String.h>
+
+using namespace Arcane;
+
+/*---------------------------------------------------------------------------*/
+/* \class NumaTopology                                                       */
+/* \brief NUMA domains of the node and their CPUs                            */
+/*                                                                           */
+/* Discovered with hwloc if ACCENV_HWLOC is defined, otherwise by reading    */
+/* /sys/devices/system/node. Domains are numbered [0,nbNode()[ in the order  */
+/* of their OS indexes. Binding a thread also sets its preferred memory      */
+/* domain : the memory it first touches afterwards (pinned buffers, newly    */
+/* allocated arrays) is local, and the threads it creates inherit the        */
+/* binding (HostWorkerThread).                                               */
+/*---------------------------------------------------------------------------*/
+class NumaTopology {
+ public:
+  NumaTopology();
+  virtual ~NumaTopology() {}
+
+  //! True if at least one NUMA domain has been discovered
+  bool isAvailable() const { return !m_node_cpus.empty(); }
+
+  //! "hwloc", "sysfs" or "none"
+  const String& discoveryMethod() const { return m_method; }
+
+  //! Number of NUMA domains
+  Integer nbNode() const { return m_node_cpus.size(); }
+
+  //! CPUs (OS indexes) of the domain inode
+  ConstArrayView<Integer> nodeCpus(Integer inode) const { return m_node_cpus[inode]; }
+
+  //! Domain closest to the PCI device pci_bus_id ("dddd:bb:dd.f"), -1 if unknown
+  Integer pciDeviceNode(const String& pci_bus_id) const;
+
+  //! Domain of the CPU executing the calling thread, -1 if unknown
+  Integer currentNode() const;
+
+  //! Bind the calling thread on the CPUs and memory of the domain inode
+  bool bindCurrentThread(Integer inode) const;
+
+  //! Move the pages already touched by the process to the domain inode, returns the number of pages not moved (-1 on failure)
+  Int64 migrateCurrentProcess(Integer inode) const;
+
+ protected:
+  void _discoverHwloc();
+  void _discoverSysfs();
+
+  //! Index in [0,nbNode()[ of the domain with OS index os_index, -1 if unknown
+  Integer _nodeFromOsIndex(Integer os_index) const;
+
+ protected:
+  String m_method="none";
+  UniqueArray<Integer> m_node_os_index;  //! OS index of each domain
+  UniqueArray<UniqueArray<Integer>> m_node_cpus;  //! CPUs of each domain
+};
+
+#endif
+
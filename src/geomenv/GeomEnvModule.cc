@@ -15,6 +15,8 @@
 #include <arcane/utils/ArcaneGlobal.h>
 #include <arcane/utils/StringBuilder.h>
 
+#include <algorithm>
+
 using namespace Arcane;
 using namespace Arcane::Materials;
 
@@ -387,7 +389,23 @@ initGeomEnv()
   debug() << "Dans InitGeomEnv";
   // On va d'abord créer les environnements en les lisant dans le JDD
 
-  MeshBlockBuildInfo mbbi("BLOCK1",allCells());
+  // Avec nb-blocks>1, les mailles sont réparties entre blocs selon leur
+  // uniqueId (même répartition pour les mailles fantômes)
+  Integer nb_blocks = std::max(options()->nbBlocks(), 1);
+  UniqueArray<CellGroup> block_cells;
+  if (nb_blocks==1) {
+    block_cells.add(allCells());
+  } else {
+    UniqueArray<Int32UniqueArray> block_lids(nb_blocks);
+    ENUMERATE_CELL(icell, allCells()) {
+      block_lids[Integer(icell->uniqueId().asInt64()%nb_blocks)].add(icell.localId());
+    }
+    for(Integer ib=0 ; ib<nb_blocks ; ++ib) {
+      block_cells.add(mesh()->cellFamily()->createGroup(String::format("BLOCK{0}_CELLS",ib+1), block_lids[ib]));
+    }
+  }
+
+  MeshBlockBuildInfo mbbi("BLOCK1",block_cells[0]);
 
   // Définition des différents objets qui vont composer la scene géométrique
   IGeometricScene* geom_scene=nullptr;
@@ -420,6 +438,11 @@ initGeomEnv()
   }
 
   IMeshBlock* block1 = m_mesh_material_mng->createBlock(mbbi);
+  // Les blocs suivants n'ont pas d'environnement
+  for(Integer ib=1 ; ib<nb_blocks ; ++ib) {
+    MeshBlockBuildInfo mbbi_ib(String::format("BLOCK{0}",ib+1),block_cells[ib]);
+    m_mesh_material_mng->createBlock(mbbi_ib);
+  }
 
   m_mesh_material_mng->endCreate(subDomain()->isContinue());
 
@@ -1,6 +1,8 @@
 #include "msgpass/Algo1SyncDataD.h"
 #include "msgpass/PackTransfer.h"
 
+#include <arcane/utils/PlatformUtils.h>
+
 Algo1SyncDataD::PersistentInfo::PersistentInfo(
     bool is_device_aware,
     Integer nb_nei,
@@ -10,6 +12,7 @@ Algo1SyncDataD::PersistentInfo::PersistentInfo(
   m_nb_nei       (nb_nei),
   m_is_device_aware (is_device_aware)
 {
+  m_init_event = makeEventRef(runner);
   m_pack_events.resize(m_nb_nei);
   for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
     m_pack_events[inei]     = makeEventRef(runner);
@@ -30,11 +33,13 @@ Algo1SyncDataD::PersistentInfo::~PersistentInfo()
 Algo1SyncDataD::Algo1SyncDataD(
     MeshVariableSynchronizerList& vars,
     Ref<RunQueue> ref_queue,
-    Algo1SyncDataD::PersistentInfo& pi
+    Algo1SyncDataD::PersistentInfo& pi,
+    SyncPlan* plan
     ) :
   m_vars         (vars),
   m_ref_queue    (ref_queue),
-  m_pi           (pi)
+  m_pi           (pi),
+  m_plan         (plan)
 {
   if (!m_pi.m_is_device_aware) {
     throw NotSupportedException(A_FUNCINFO,
@@ -43,6 +48,8 @@ Algo1SyncDataD::Algo1SyncDataD(
 }
 
 Algo1SyncDataD::~Algo1SyncDataD() {
+  // La synchronisation est terminée, sa part de l'arène peut être réutilisée
+  m_pi.m_sync_buffers->release(m_sub_buf);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -61,22 +68,33 @@ void Algo1SyncDataD::initComm() {
 
   // Asynchronous pointers tranfer onto device
   m_vars.asyncHToD(*(m_ref_queue.get()));
+  // Les queues par voisin (packNeigh) ne doivent pas démarrer avant ce transfert
+  m_ref_queue->recordEvent(m_pi.m_init_event);
+
+  Integer nb_nei = m_pi.m_nb_nei;
 
   // On prévoit une taille max du buffer qui va contenir tous les messages
+  // et on la réserve dans l'arène jusqu'à la fin de la synchronisation
   Int64 buf_estim_sz=0;
   for(auto var : lvars) {
     buf_estim_sz += var->estimatedMaxBufSz();
   }
+  m_sub_buf = m_pi.m_sync_buffers->acquire(buf_estim_sz);
 
-  m_pi.m_sync_buffers->resetBuf();
-  // Le buffer de tous les messages est réalloué si pas assez de place
-  m_pi.m_sync_buffers->allocIfNeeded(buf_estim_sz);
+  if (m_plan) {
+    // Les buffers ne sont recalculés que si leurs adresses ont changé
+    if (!m_plan->isLayoutValid(m_sub_buf)) {
+      m_plan->buildLayout(lvars, nb_nei, m_pi.m_sync_buffers, m_sub_buf);
+    }
+    m_buf_snd_d = m_plan->bufSnd(1);
+    m_buf_rcv_d = m_plan->bufRcv(1);
+    return;
+  }
 
-  Integer nb_nei = m_pi.m_nb_nei;
   // On récupère les adresses et tailles des buffers d'envoi et de réception 
   // sur le DEVICE (_d et "1")
-  m_buf_snd_d = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_owned, 1);
-  m_buf_rcv_d = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_ghost, 1);
+  m_buf_snd_d = m_pi.m_sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_owned, 1);
+  m_buf_rcv_d = m_pi.m_sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_ghost, 1);
 }
 
 
@@ -105,6 +123,10 @@ void Algo1SyncDataD::initSendings() {
   // On enchaine sur le device : 
   //    copie de var_dev dans buf_dev 
 
+  if (m_pi.m_stats) {
+    m_pi.m_stats->beginPack();
+  }
+
   // On remplit les buffers sur le DEVICE
   for(Integer inei=0 ; inei<m_pi.m_nb_nei ; ++inei) {
 
@@ -116,6 +138,9 @@ void Algo1SyncDataD::initSendings() {
       // "buf_snd[inei] <= var_menv"
       auto byte_buf_var_d = byte_buf_snd_d.byteBuf(ivar);
       lvars[ivar]->asyncPackOwnedIntoBuf(inei, byte_buf_var_d, *(m_ref_queue.get()));
+      if (m_pi.m_stats) {
+        m_pi.m_stats->addPacked(inei, ivar, byte_buf_var_d.size());
+      }
     }
 
     // On enregistre un événement pour la fin de packing pour le voisin inei
@@ -129,6 +154,10 @@ void Algo1SyncDataD::initSendings() {
 void Algo1SyncDataD::finalizePackBeforeSend(Integer inei) {
   // Attente de la fin du packing
   m_pi.m_pack_events[inei]->wait();
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->endPack(inei);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -144,6 +173,8 @@ void Algo1SyncDataD::finalizeSendings() {
 /*---------------------------------------------------------------------------*/
 void Algo1SyncDataD::unpackAfterRecv(Integer inei) {
 
+  Real unpack_beg = platform::getRealTime();
+
   auto lvars = m_vars.varsList();
   Integer nb_var = lvars.size();
 
@@ -159,6 +190,10 @@ void Algo1SyncDataD::unpackAfterRecv(Integer inei) {
     auto byte_buf_var_d = byte_buf_rcv_d.byteBuf(ivar);
     lvars[ivar]->asyncUnpackGhostFromBuf(inei, byte_buf_var_d, *(m_ref_queue.get()));
   }
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addUnpackTime(inei, platform::getRealTime()-unpack_beg);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -166,7 +201,11 @@ void Algo1SyncDataD::unpackAfterRecv(Integer inei) {
 /*---------------------------------------------------------------------------*/
 void Algo1SyncDataD::finalizeReceipts() {
   // on attend la terminaison de tous les unpacks asynchrones
+  Real drain_beg = platform::getRealTime();
   m_ref_queue->barrier();
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addDrainTime(platform::getRealTime()-drain_beg);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -176,3 +215,57 @@ void Algo1SyncDataD::finalizeWoComm() {
   m_ref_queue->barrier();
 }
 
+/*---------------------------------------------------------------------------*/
+/* Pack the values to send to the neighbour inei on queue                    */
+/* (called by the progress thread of inei, concurrently with the others)     */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataD::packNeigh(Integer inei, RunQueue& queue) {
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_snd_d = m_buf_snd_d.multiView(inei); // le buffer d'envoi pour inei sur le DEVICE
+
+  // Les pointeurs des variables doivent être sur le DEVICE
+  queue.waitEvent(m_pi.m_init_event);
+
+  // "buf_snd[inei] <= var_menv"
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    auto byte_buf_var_d = byte_buf_snd_d.byteBuf(ivar);
+    lvars[ivar]->asyncPackOwnedIntoBuf(inei, byte_buf_var_d, queue);
+    if (m_pi.m_stats) {
+      m_pi.m_stats->addPacked(inei, ivar, byte_buf_var_d.size());
+    }
+  }
+  queue.barrier();
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->endPack(inei);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Unpack the values received from the neighbour inei on queue               */
+/* (called by the progress thread of inei, concurrently with the others)     */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataD::unpackNeigh(Integer inei, RunQueue& queue) {
+
+  Real unpack_beg = platform::getRealTime();
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_rcv_d = m_buf_rcv_d.multiView(inei); // buffer des données reçues sur le DEVICE
+
+  // "var_menv <= m_buf_rcv_d[inei]"
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    auto byte_buf_var_d = byte_buf_rcv_d.byteBuf(ivar);
+    lvars[ivar]->asyncUnpackGhostFromBuf(inei, byte_buf_var_d, queue);
+  }
+  queue.barrier();
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addUnpackTime(inei, platform::getRealTime()-unpack_beg);
+  }
+}
+
@@ -5,6 +5,8 @@
 #include "msgpass/MeshVariableSynchronizerList.h"
 #include "msgpass/SyncItems.h"
 #include "msgpass/SyncBuffers.h"
+#include "msgpass/SyncPlan.h"
+#include "msgpass/SyncStats.h"
 
 /*---------------------------------------------------------------------------*/
 /* \class Algo1SyncDataD                                                     */
@@ -25,18 +27,24 @@ class Algo1SyncDataD : public IAlgo1SyncData {
         Runner& runner,
         SyncBuffers* sync_buffers);
     virtual ~PersistentInfo();
+
+    //! If not null, the pack/unpack sizes and times are recorded into stats
+    void setSyncStats(SyncStats* stats) { m_stats = stats; }
    protected:
     SyncBuffers* m_sync_buffers=nullptr;
+    SyncStats* m_stats=nullptr;  //! Statistics (not owned)
     Integer m_nb_nei=0;
     bool m_is_device_aware=false;
 
     UniqueArray<Ref<ax::RunQueueEvent>> m_pack_events;  //! Les evenements pour le packing des données
+    Ref<ax::RunQueueEvent> m_init_event;  //! Fin de initComm, attendu par les queues des voisins
   };
 
  public:
   Algo1SyncDataD(MeshVariableSynchronizerList& vars,
       Ref<RunQueue> ref_queue,
-      PersistentInfo& pi);
+      PersistentInfo& pi,
+      SyncPlan* plan=nullptr);
 
   virtual ~Algo1SyncDataD();
 
@@ -70,10 +78,18 @@ class Algo1SyncDataD : public IAlgo1SyncData {
   //! Finalize if no communication needed
   void finalizeWoComm() override;
 
+  //! Pack the values to send to the neighbour inei on queue, sendBuf(inei) is ready at return
+  void packNeigh(Integer inei, RunQueue& queue) override;
+
+  //! Unpack the values received from the neighbour inei on queue, done at return
+  void unpackNeigh(Integer inei, RunQueue& queue) override;
+
  protected:
   MeshVariableSynchronizerList& m_vars;
   Ref<RunQueue> m_ref_queue;
   PersistentInfo& m_pi;
+  SyncPlan* m_plan=nullptr;  //! If not null, the buffer layouts are cached into the plan
+  SyncBuffers::SubBuf* m_sub_buf=nullptr;  //! Part of the SyncBuffers arena reserved to this synchronization
 
   MultiBufView2 m_buf_snd_d;  //! Buffers on Device (_d) to send
   MultiBufView2 m_buf_rcv_d;  //! Buffers on Device (_d) to recv
@@ -1,6 +1,14 @@
 #include "msgpass/Algo1SyncDataDH.h"
 #include "msgpass/PackTransfer.h"
 
+#include <arcane/utils/PlatformUtils.h>
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/utils/NotSupportedException.h>
+
+#include <algorithm>
+#include <cstring>
+
 Algo1SyncDataDH::PersistentInfo::PersistentInfo(
     Integer nb_nei,
     Runner& runner,
@@ -8,6 +16,10 @@ Algo1SyncDataDH::PersistentInfo::PersistentInfo(
   m_sync_buffers (sync_buffers),
   m_nb_nei       (nb_nei)
 {
+  m_cmp_offsets.resize(m_nb_nei+1);
+  m_cmp_snd_sizes.resize(m_nb_nei);
+
+  m_init_event = makeEventRef(runner);
   m_pack_events.resize(m_nb_nei);
   m_transfer_events.resize(m_nb_nei);
   for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
@@ -32,15 +44,19 @@ Algo1SyncDataDH::PersistentInfo::~PersistentInfo()
 Algo1SyncDataDH::Algo1SyncDataDH(
     MeshVariableSynchronizerList& vars,
     Ref<RunQueue> ref_queue,
-    Algo1SyncDataDH::PersistentInfo& pi
+    Algo1SyncDataDH::PersistentInfo& pi,
+    SyncPlan* plan
     ) :
   m_vars         (vars),
   m_ref_queue    (ref_queue),
-  m_pi           (pi)
+  m_pi           (pi),
+  m_plan         (plan)
 {
 }
 
 Algo1SyncDataDH::~Algo1SyncDataDH() {
+  // La synchronisation est terminée, sa part de l'arène peut être réutilisée
+  m_pi.m_sync_buffers->release(m_sub_buf);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -59,27 +75,70 @@ void Algo1SyncDataDH::initComm() {
 
   // Asynchronous pointers tranfer onto device
   m_vars.asyncHToD(*(m_ref_queue.get()));
+  // Les queues par voisin (packNeigh) ne doivent pas démarrer avant ce transfert
+  m_ref_queue->recordEvent(m_pi.m_init_event);
+
+  Integer nb_nei = m_pi.m_nb_nei;
 
   // On prévoit une taille max du buffer qui va contenir tous les messages
+  // et on la réserve dans l'arène jusqu'à la fin de la synchronisation
   Int64 buf_estim_sz=0;
   for(auto var : lvars) {
     buf_estim_sz += var->estimatedMaxBufSz();
   }
+  m_sub_buf = m_pi.m_sync_buffers->acquire(buf_estim_sz);
 
-  m_pi.m_sync_buffers->resetBuf();
-  // Le buffer de tous les messages est réalloué si pas assez de place
-  m_pi.m_sync_buffers->allocIfNeeded(buf_estim_sz);
+  if (m_plan) {
+    // Les buffers ne sont recalculés que si leurs adresses ont changé
+    if (!m_plan->isLayoutValid(m_sub_buf)) {
+      m_plan->buildLayout(lvars, nb_nei, m_pi.m_sync_buffers, m_sub_buf);
+    }
+    m_buf_snd_h = m_plan->bufSnd(0);
+    m_buf_rcv_h = m_plan->bufRcv(0);
+    m_buf_snd_d = m_plan->bufSnd(1);
+    m_buf_rcv_d = m_plan->bufRcv(1);
+  } else {
+    _initBuffers(lvars, nb_nei);
+  }
+
+  m_use_cmp = m_vars.hasBufCompression();
+  if (m_use_cmp) {
+    // Taille max du message compressé de chaque voisin : les tailles compressées
+    // de chaque variable puis les données compressées
+    Integer nb_var = lvars.size();
+    m_pi.m_cmp_offsets[0] = 0;
+    for(Integer inei=0 ; inei<nb_nei ; ++inei) {
+      Int64 cmp_max_sz = nb_var*sizeof(Int64);
+      for(auto var : lvars) {
+        cmp_max_sz += buf_compress_max_size(var->sizeInBytes(IMeshVarSync::IS_owned, inei));
+      }
+      Int64 cmp_max_rcv_sz = nb_var*sizeof(Int64);
+      for(auto var : lvars) {
+        cmp_max_rcv_sz += buf_compress_max_size(var->sizeInBytes(IMeshVarSync::IS_ghost, inei));
+      }
+      m_pi.m_cmp_offsets[inei+1] = m_pi.m_cmp_offsets[inei] + std::max(cmp_max_sz, cmp_max_rcv_sz);
+    }
+    m_pi.m_cmp_buf_snd.resize(m_pi.m_cmp_offsets[nb_nei]);
+    m_pi.m_cmp_buf_rcv.resize(m_pi.m_cmp_offsets[nb_nei]);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Compute the buffer layouts without plan                                   */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataDH::_initBuffers(ConstArrayView<IMeshVarSync*> lvars, Integer nb_nei) {
+
+  SyncBuffers* sync_buffers = m_pi.m_sync_buffers;
 
-  Integer nb_nei = m_pi.m_nb_nei;
   // On récupère les adresses et tailles des buffers d'envoi et de réception 
-  // sur l'HOTE (_h et "0")
-  m_buf_snd_h = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_owned, 0);
-  m_buf_rcv_h = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_ghost, 0);
+  // sur l'HOTE (_h et "0") dans la sous-allocation m_sub_buf
+  m_buf_snd_h = sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_owned, 0);
+  m_buf_rcv_h = sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_ghost, 0);
 
   // On récupère les adresses et tailles des buffers d'envoi et de réception 
   // sur le DEVICE (_d et "1")
-  m_buf_snd_d = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_owned, 1);
-  m_buf_rcv_d = m_pi.m_sync_buffers->multiBufViewVars(lvars, nb_nei, IMeshVarSync::IS_ghost, 1);
+  m_buf_snd_d = sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_owned, 1);
+  m_buf_rcv_d = sync_buffers->multiBufViewVars(m_sub_buf, lvars, nb_nei, IMeshVarSync::IS_ghost, 1);
 }
 
 
@@ -87,6 +146,11 @@ void Algo1SyncDataDH::initComm() {
 /* Get the receive buffer for the neighbour inei                             */
 /*---------------------------------------------------------------------------*/
 ArrayView<Byte> Algo1SyncDataDH::recvBuf(Integer inei) {
+  if (m_use_cmp) {
+    // Taille max, le message reçu peut être plus court
+    Int64 beg = m_pi.m_cmp_offsets[inei];
+    return m_pi.m_cmp_buf_rcv.subView(beg, m_pi.m_cmp_offsets[inei+1]-beg);
+  }
   return m_buf_rcv_h.multiView(inei).rangeView();
 }
 
@@ -94,6 +158,10 @@ ArrayView<Byte> Algo1SyncDataDH::recvBuf(Integer inei) {
 /* Get the send buffer for the neighbour inei                                */
 /*---------------------------------------------------------------------------*/
 ArrayView<Byte> Algo1SyncDataDH::sendBuf(Integer inei) {
+  if (m_use_cmp) {
+    // Taille effective calculée par finalizePackBeforeSend(inei)
+    return m_pi.m_cmp_buf_snd.subView(m_pi.m_cmp_offsets[inei], m_pi.m_cmp_snd_sizes[inei]);
+  }
   return m_buf_snd_h.multiView(inei).rangeView();
 }
 
@@ -109,6 +177,10 @@ void Algo1SyncDataDH::initSendings() {
   //    copie de var_dev dans buf_dev 
   //    puis transfert buf_dev => buf_hst
 
+  if (m_pi.m_stats) {
+    m_pi.m_stats->beginPack();
+  }
+
   // On remplit les buffers sur le DEVICE
   for(Integer inei=0 ; inei<m_pi.m_nb_nei ; ++inei) {
 
@@ -121,6 +193,9 @@ void Algo1SyncDataDH::initSendings() {
       // "buf_snd[inei] <= var_menv"
       auto byte_buf_var_d = byte_buf_snd_d.byteBuf(ivar);
       lvars[ivar]->asyncPackOwnedIntoBuf(inei, byte_buf_var_d, *(m_ref_queue.get()));
+      if (m_pi.m_stats) {
+        m_pi.m_stats->addPacked(inei, ivar, byte_buf_var_d.size());
+      }
     }
 
     // On enregistre un événement pour la fin de packing pour le voisin inei
@@ -144,6 +219,14 @@ void Algo1SyncDataDH::initSendings() {
 void Algo1SyncDataDH::finalizePackBeforeSend(Integer inei) {
   // Attente de la fin du transfert
   m_pi.m_transfer_events[inei]->wait();
+
+  if (m_use_cmp) {
+    _compressSnd(inei);
+  }
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->endPack(inei);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -160,6 +243,8 @@ void Algo1SyncDataDH::finalizeSendings() {
 /*---------------------------------------------------------------------------*/
 void Algo1SyncDataDH::unpackAfterRecv(Integer inei) {
 
+  Real unpack_beg = platform::getRealTime();
+
   auto lvars = m_vars.varsList();
   Integer nb_var = lvars.size();
 
@@ -169,6 +254,11 @@ void Algo1SyncDataDH::unpackAfterRecv(Integer inei) {
   auto byte_buf_rcv_h = m_buf_rcv_h.multiView(inei); // buffer des données reçues sur l'HOTE
   auto byte_buf_rcv_d = m_buf_rcv_d.multiView(inei); // buffer des données reçues à transférer sur le DEVICE
 
+  if (m_use_cmp) {
+    // m_buf_rcv_h[inei] <= décompression du message reçu
+    _decompressRcv(inei);
+  }
+
   // transfert m_buf_rcv_h[inei] => m_buf_rcv_d[inei]
   async_transfer(byte_buf_rcv_d, byte_buf_rcv_h, *(m_pi.m_ref_queue_data.get()));
 
@@ -186,6 +276,10 @@ void Algo1SyncDataDH::unpackAfterRecv(Integer inei) {
     auto byte_buf_var_d = byte_buf_rcv_d.byteBuf(ivar);
     lvars[ivar]->asyncUnpackGhostFromBuf(inei, byte_buf_var_d, *(m_ref_queue.get()));
   }
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addUnpackTime(inei, platform::getRealTime()-unpack_beg);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -193,8 +287,12 @@ void Algo1SyncDataDH::unpackAfterRecv(Integer inei) {
 /*---------------------------------------------------------------------------*/
 void Algo1SyncDataDH::finalizeReceipts() {
   // on attend la terminaison de tous les unpacks asynchrones
+  Real drain_beg = platform::getRealTime();
   m_pi.m_ref_queue_data->barrier();
   m_ref_queue->barrier();
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addDrainTime(platform::getRealTime()-drain_beg);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -204,3 +302,126 @@ void Algo1SyncDataDH::finalizeWoComm() {
   m_ref_queue->barrier();
 }
 
+/*---------------------------------------------------------------------------*/
+/* Pack the values to send to the neighbour inei on queue                    */
+/* (called by the progress thread of inei, concurrently with the others)     */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataDH::packNeigh(Integer inei, RunQueue& queue) {
+
+  if (m_use_cmp) {
+    // Les buffers de travail de la compression sont communs à tous les voisins
+    throw NotSupportedException(A_FUNCINFO, "Pas de compression avec un thread par voisin");
+  }
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_snd_d = m_buf_snd_d.multiView(inei); // le buffer d'envoi pour inei sur le DEVICE
+  auto byte_buf_snd_h = m_buf_snd_h.multiView(inei); // le buffer d'envoi pour inei sur l'HOTE
+
+  // Les pointeurs des variables doivent être sur le DEVICE
+  queue.waitEvent(m_pi.m_init_event);
+
+  // "buf_snd[inei] <= var_menv" sur le DEVICE
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    auto byte_buf_var_d = byte_buf_snd_d.byteBuf(ivar);
+    lvars[ivar]->asyncPackOwnedIntoBuf(inei, byte_buf_var_d, queue);
+    if (m_pi.m_stats) {
+      m_pi.m_stats->addPacked(inei, ivar, byte_buf_var_d.size());
+    }
+  }
+
+  // transfert m_buf_snd_d[inei] => m_buf_snd_h[inei] sur la même queue
+  async_transfer(byte_buf_snd_h, byte_buf_snd_d, queue);
+  queue.barrier();
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->endPack(inei);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Unpack the values received from the neighbour inei on queue               */
+/* (called by the progress thread of inei, concurrently with the others)     */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataDH::unpackNeigh(Integer inei, RunQueue& queue) {
+
+  Real unpack_beg = platform::getRealTime();
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_rcv_h = m_buf_rcv_h.multiView(inei); // buffer des données reçues sur l'HOTE
+  auto byte_buf_rcv_d = m_buf_rcv_d.multiView(inei); // buffer des données reçues à transférer sur le DEVICE
+
+  // transfert m_buf_rcv_h[inei] => m_buf_rcv_d[inei] puis unpacking sur la même queue
+  // Les items fantômes d'un voisin ne sont reçus que de ce voisin : pas de conflit entre threads
+  async_transfer(byte_buf_rcv_d, byte_buf_rcv_h, queue);
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    auto byte_buf_var_d = byte_buf_rcv_d.byteBuf(ivar);
+    lvars[ivar]->asyncUnpackGhostFromBuf(inei, byte_buf_var_d, queue);
+  }
+  queue.barrier();
+
+  if (m_pi.m_stats) {
+    m_pi.m_stats->addUnpackTime(inei, platform::getRealTime()-unpack_beg);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Compress the host send buffer of the neighbour inei                       */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataDH::_compressSnd(Integer inei) {
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_snd_h = m_buf_snd_h.multiView(inei);
+
+  Int64 beg = m_pi.m_cmp_offsets[inei];
+  ArrayView<Byte> cmp_buf = m_pi.m_cmp_buf_snd.subView(beg, m_pi.m_cmp_offsets[inei+1]-beg);
+  Int64 pos = nb_var*sizeof(Int64);  // les données suivent les tailles compressées
+
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    auto byte_buf_var_h = byte_buf_snd_h.byteBuf(ivar);
+    Int64 raw_sz = byte_buf_var_h.size();
+    Int64 max_sz = buf_compress_max_size(raw_sz);
+
+    Int64 cmp_sz = buf_compress(lvars[ivar]->bufCompression(), lvars[ivar]->sizeInfos().sizeOf,
+        byte_buf_var_h, cmp_buf.subView(pos, max_sz), m_pi.m_cmp_tmp);
+    std::memcpy(cmp_buf.data()+ivar*sizeof(Int64), &cmp_sz, sizeof(Int64));
+    pos += cmp_sz;
+
+    if (lvars[ivar]->bufCompression()!=BC_none) {
+      m_pi.m_cmp_stats.add(lvars[ivar]->name(), raw_sz, cmp_sz);
+    }
+  }
+  m_pi.m_cmp_snd_sizes[inei] = pos;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Decompress the message received from the neighbour inei                   */
+/*---------------------------------------------------------------------------*/
+void Algo1SyncDataDH::_decompressRcv(Integer inei) {
+
+  auto lvars = m_vars.varsList();
+  Integer nb_var = lvars.size();
+
+  auto byte_buf_rcv_h = m_buf_rcv_h.multiView(inei);
+
+  Int64 beg = m_pi.m_cmp_offsets[inei];
+  ArrayView<Byte> cmp_buf = m_pi.m_cmp_buf_rcv.subView(beg, m_pi.m_cmp_offsets[inei+1]-beg);
+  Int64 pos = nb_var*sizeof(Int64);
+
+  for(Integer ivar=0 ; ivar<nb_var ; ++ivar) {
+    Int64 cmp_sz;
+    std::memcpy(&cmp_sz, cmp_buf.data()+ivar*sizeof(Int64), sizeof(Int64));
+    if (cmp_sz<0 || pos+cmp_sz>cmp_buf.size()) {
+      throw FatalErrorException(A_FUNCINFO, "Taille de message compresse incorrecte");
+    }
+
+    buf_decompress(lvars[ivar]->bufCompression(), lvars[ivar]->sizeInfos().sizeOf,
+        cmp_buf.subView(pos, cmp_sz), byte_buf_rcv_h.byteBuf(ivar), m_pi.m_cmp_tmp);
+    pos += cmp_sz;
+  }
+}
@@ -5,6 +5,9 @@
 #include "msgpass/MeshVariableSynchronizerList.h"
 #include "msgpass/SyncItems.h"
 #include "msgpass/SyncBuffers.h"
+#include "msgpass/SyncPlan.h"
+#include "msgpass/SyncStats.h"
+#include "msgpass/BufCompression.h"
 
 /*---------------------------------------------------------------------------*/
 /* \class Algo1SyncDataDH                                                    */
@@ -24,19 +27,36 @@ class Algo1SyncDataDH : public IAlgo1SyncData {
         Runner& runner,
         SyncBuffers* sync_buffers);
     virtual ~PersistentInfo();
+
+    //! If not null, the pack/unpack sizes and times are recorded into stats
+    void setSyncStats(SyncStats* stats) { m_stats = stats; }
+
+    //! Compression ratios of the comm buffers since the beginning
+    const BufCompressionStats& bufCompressionStats() const { return m_cmp_stats; }
    protected:
     SyncBuffers* m_sync_buffers=nullptr;
+    SyncStats* m_stats=nullptr;  //! Statistics (not owned)
     Integer m_nb_nei=0;
 
     Ref<ax::RunQueue> m_ref_queue_data;  //! Référence sur une queue prioritaire pour le transfert des données
     UniqueArray<Ref<ax::RunQueueEvent>> m_pack_events;  //! Les evenements pour le packing des données
+    Ref<ax::RunQueueEvent> m_init_event;  //! Fin de initComm, attendu par les queues des voisins
     UniqueArray<Ref<ax::RunQueueEvent>> m_transfer_events;  //! Les evenements pour le transfert des données
+
+    // Buffers compressés sur l'HOTE : par voisin, nb_var tailles compressées (Int64) puis les données
+    UniqueArray<Byte> m_cmp_buf_snd;  //! Buffers compressés à envoyer
+    UniqueArray<Byte> m_cmp_buf_rcv;  //! Buffers compressés reçus
+    UniqueArray<Int64> m_cmp_offsets;  //! Début du buffer compressé de chaque voisin (taille nb_nei+1)
+    UniqueArray<Int64> m_cmp_snd_sizes;  //! Taille effective du message compressé envoyé à chaque voisin
+    UniqueArray<Byte> m_cmp_tmp;  //! Buffer de travail pour la compression
+    BufCompressionStats m_cmp_stats;
   };
 
  public:
   Algo1SyncDataDH(MeshVariableSynchronizerList& vars,
       Ref<RunQueue> ref_queue,
-      PersistentInfo& pi);
+      PersistentInfo& pi,
+      SyncPlan* plan=nullptr);
 
   virtual ~Algo1SyncDataDH();
 
@@ -70,10 +90,29 @@ class Algo1SyncDataDH : public IAlgo1SyncData {
   //! Finalize if no communication needed
   void finalizeWoComm() override;
 
+  //! Pack the values to send to the neighbour inei on queue, sendBuf(inei) is ready at return
+  void packNeigh(Integer inei, RunQueue& queue) override;
+
+  //! Unpack the values received from the neighbour inei on queue, done at return
+  void unpackNeigh(Integer inei, RunQueue& queue) override;
+
+ protected:
+  //! Compute the buffer layouts without plan
+  void _initBuffers(ConstArrayView<IMeshVarSync*> lvars, Integer nb_nei);
+
+  //! Compress the host send buffer of the neighbour inei
+  void _compressSnd(Integer inei);
+
+  //! Decompress the message received from the neighbour inei into the host recv buffer
+  void _decompressRcv(Integer inei);
+
  protected:
   MeshVariableSynchronizerList& m_vars;
   Ref<RunQueue> m_ref_queue;
   PersistentInfo& m_pi;
+  SyncPlan* m_plan=nullptr;  //! If not null, the buffer layouts are cached into the plan
+  SyncBuffers::SubBuf* m_sub_buf=nullptr;  //! Part of the SyncBuffers arena reserved to this synchronization
+  bool m_use_cmp=false;  //! True if the messages are compressed on Host
 
   MultiBufView2 m_buf_snd_h;  //! Buffers on Host (_h) to send
   MultiBufView2 m_buf_rcv_h;  //! Buffers on Host (_h) to recv
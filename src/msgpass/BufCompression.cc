@@ -0,0 +1,218 @@
+#include "msgpass/BufCompression.h"
+
+#include <arcane/utils/FatalErrorException.h>
+
+#include <cstring>
+
+/*---------------------------------------------------------------------------*/
+/* RLE façon "PackBits" :                                                    */
+/*  octet de contrôle c<128  : c+1 octets littéraux suivent                  */
+/*  octet de contrôle c>=128 : l'octet suivant est répété c-128+3 fois       */
+/*---------------------------------------------------------------------------*/
+namespace {
+constexpr Int64 RLE_MAX_LITERAL = 128;
+constexpr Int64 RLE_MIN_RUN = 3;
+constexpr Int64 RLE_MAX_RUN = 130;
+
+Int64 _rle_encode(ConstArrayView<Byte> in, ArrayView<Byte> out) {
+  Int64 n = in.size();
+  Int64 i = 0, o = 0;
+  while(i<n) {
+    Int64 run = 1;
+    while(i+run<n && run<RLE_MAX_RUN && in[i+run]==in[i]) {
+      run++;
+    }
+    if (run>=RLE_MIN_RUN) {
+      out[o++] = static_cast<Byte>(128+run-RLE_MIN_RUN);
+      out[o++] = in[i];
+      i += run;
+    } else {
+      // Littéraux jusqu'au début d'une répétition ou jusqu'à RLE_MAX_LITERAL octets
+      Int64 start = i, len = 0;
+      while(i<n && len<RLE_MAX_LITERAL) {
+        if (i+2<n && in[i]==in[i+1] && in[i]==in[i+2]) {
+          break;
+        }
+        i++;
+        len++;
+      }
+      out[o++] = static_cast<Byte>(len-1);
+      std::memcpy(out.data()+o, in.data()+start, len);
+      o += len;
+    }
+  }
+  return o;
+}
+
+void _rle_decode(ConstArrayView<Byte> in, ArrayView<Byte> out) {
+  Int64 n = in.size(), m = out.size();
+  Int64 i = 0, o = 0;
+  while(i<n) {
+    Int64 c = in[i++];
+    if (c<128) {
+      Int64 len = c+1;
+      if (o+len>m || i+len>n) {
+        throw FatalErrorException(A_FUNCINFO, "Buffer RLE corrompu");
+      }
+      std::memcpy(out.data()+o, in.data()+i, len);
+      i += len;
+      o += len;
+    } else {
+      Int64 run = c-128+RLE_MIN_RUN;
+      if (o+run>m || i>=n) {
+        throw FatalErrorException(A_FUNCINFO, "Buffer RLE corrompu");
+      }
+      std::memset(out.data()+o, in[i++], run);
+      o += run;
+    }
+  }
+  if (o!=m) {
+    throw FatalErrorException(A_FUNCINFO, "Taille decompressee RLE incorrecte");
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Les valeurs sont vues comme des mots de word_size octets (8 pour Real,    */
+/* 4 pour Integer), une valeur de data_size octets contient                  */
+/* stride=data_size/word_size composantes (3 pour Real3, 9 pour Real3x3)     */
+/*---------------------------------------------------------------------------*/
+Int64 _word_size(Int64 data_size, Int64 raw_size) {
+  Int64 ws = (data_size%8==0 ? 8 : (data_size%4==0 ? 4 : 1));
+  return (raw_size%ws==0 ? ws : 1);
+}
+
+template<typename WordType>
+void _xor_shuffle(ConstArrayView<Byte> in, ArrayView<Byte> out, Int64 stride) {
+  constexpr Int64 ws = sizeof(WordType);
+  Int64 nw = in.size()/ws;
+  WordType prev, cur;
+  for(Int64 i=0 ; i<nw ; ++i) {
+    std::memcpy(&cur, in.data()+i*ws, ws);
+    WordType delta = cur;
+    if (i>=stride) {
+      // XOR avec la même composante de la valeur précédente
+      std::memcpy(&prev, in.data()+(i-stride)*ws, ws);
+      delta ^= prev;
+    }
+    const Byte* bytes = reinterpret_cast<const Byte*>(&delta);
+    for(Int64 b=0 ; b<ws ; ++b) {
+      out[b*nw+i] = bytes[b];
+    }
+  }
+}
+
+template<typename WordType>
+void _unshuffle_xor(ConstArrayView<Byte> in, ArrayView<Byte> out, Int64 stride) {
+  constexpr Int64 ws = sizeof(WordType);
+  Int64 nw = out.size()/ws;
+  WordType prev, cur;
+  for(Int64 i=0 ; i<nw ; ++i) {
+    Byte* bytes = reinterpret_cast<Byte*>(&cur);
+    for(Int64 b=0 ; b<ws ; ++b) {
+      bytes[b] = in[b*nw+i];
+    }
+    if (i>=stride) {
+      std::memcpy(&prev, out.data()+(i-stride)*ws, ws);
+      cur ^= prev;
+    }
+    std::memcpy(out.data()+i*ws, &cur, ws);
+  }
+}
+}
+
+/*---------------------------------------------------------------------------*/
+/* Taille max en octets d'un buffer de raw_size octets une fois compressé    */
+/*---------------------------------------------------------------------------*/
+Int64 buf_compress_max_size(Int64 raw_size) {
+  // Pire cas RLE : un octet de contrôle tous les RLE_MAX_LITERAL octets
+  return raw_size + (raw_size+RLE_MAX_LITERAL-1)/RLE_MAX_LITERAL;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Compresse in dans out, retourne la taille compressée en octets            */
+/*---------------------------------------------------------------------------*/
+Int64 buf_compress(eBufCompression bc, Int64 data_size,
+    ConstArrayView<Byte> in, ArrayView<Byte> out, UniqueArray<Byte>& tmp) {
+
+  ARCANE_ASSERT(out.size()>=buf_compress_max_size(in.size()), ("Buffer de sortie trop petit"));
+
+  if (bc == BC_none) {
+    std::memcpy(out.data(), in.data(), in.size());
+    return in.size();
+  } else if (bc == BC_rle) {
+    return _rle_encode(in, out);
+  } else if (bc == BC_xor_shuffle_rle) {
+    Int64 raw_size = in.size();
+    Int64 ws = _word_size(data_size, raw_size);
+    Int64 stride = (data_size%ws==0 ? data_size/ws : 1);
+    tmp.resize(raw_size);
+    if (ws==8) {
+      _xor_shuffle<UInt64>(in, tmp, stride);
+    } else if (ws==4) {
+      _xor_shuffle<UInt32>(in, tmp, stride);
+    } else {
+      _xor_shuffle<Byte>(in, tmp, stride);
+    }
+    return _rle_encode(tmp, out);
+  }
+  throw FatalErrorException(A_FUNCINFO, String::format("Invalid eBufCompression={0}", (int)bc));
+  return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Décompresse in dans out, out.size() est la taille non compressée          */
+/*---------------------------------------------------------------------------*/
+void buf_decompress(eBufCompression bc, Int64 data_size,
+    ConstArrayView<Byte> in, ArrayView<Byte> out, UniqueArray<Byte>& tmp) {
+
+  if (bc == BC_none) {
+    ARCANE_ASSERT(in.size()==out.size(), ("Tailles differentes sans compression"));
+    std::memcpy(out.data(), in.data(), out.size());
+  } else if (bc == BC_rle) {
+    _rle_decode(in, out);
+  } else if (bc == BC_xor_shuffle_rle) {
+    Int64 raw_size = out.size();
+    Int64 ws = _word_size(data_size, raw_size);
+    Int64 stride = (data_size%ws==0 ? data_size/ws : 1);
+    tmp.resize(raw_size);
+    _rle_decode(in, tmp);
+    if (ws==8) {
+      _unshuffle_xor<UInt64>(tmp, out, stride);
+    } else if (ws==4) {
+      _unshuffle_xor<UInt32>(tmp, out, stride);
+    } else {
+      _unshuffle_xor<Byte>(tmp, out, stride);
+    }
+  } else {
+    throw FatalErrorException(A_FUNCINFO, String::format("Invalid eBufCompression={0}", (int)bc));
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Cumul des tailles non compressées/compressées par variable                */
+/*---------------------------------------------------------------------------*/
+void BufCompressionStats::add(const String& var_name, Int64 raw_size, Int64 cmp_size) {
+  auto& sizes = m_var_sizes[var_name];
+  sizes.m_raw_size += raw_size;
+  sizes.m_cmp_size += cmp_size;
+  m_all_sizes.m_raw_size += raw_size;
+  m_all_sizes.m_cmp_size += cmp_size;
+}
+
+Real BufCompressionStats::ratio() const {
+  return (m_all_sizes.m_cmp_size>0 ?
+      Real(m_all_sizes.m_raw_size)/Real(m_all_sizes.m_cmp_size) : 1.);
+}
+
+void BufCompressionStats::print(ITraceMng* tm) const {
+  if (m_var_sizes.empty()) {
+    return;
+  }
+  for(const auto& [name, sizes] : m_var_sizes) {
+    Real ratio = (sizes.m_cmp_size>0 ? Real(sizes.m_raw_size)/Real(sizes.m_cmp_size) : 1.);
+    tm->info() << "Compression buffers comms " << name
+      << " : " << sizes.m_raw_size << " -> " << sizes.m_cmp_size
+      << " octets, taux=" << ratio;
+  }
+  tm->info() << "Compression buffers comms (toutes variables) : taux=" << ratio();
+}
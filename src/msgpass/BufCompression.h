@@ -0,0 +1,60 @@
+#ifndef MSG_PASS_BUF_COMPRESSION_H
+#define MSG_PASS_BUF_COMPRESSION_H
+
+#include "msgpass/VarSyncMngOptions.h"
+
+#include <arcane/utils/ArrayView.h>
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/String.h>
+#include <arcane/utils/ITraceMng.h>
+
+#include <map>
+
+using namespace Arcane;
+
+/*---------------------------------------------------------------------------*/
+/* Compression sans perte (sur l'hôte) des buffers de comms                  */
+/*---------------------------------------------------------------------------*/
+
+//! Taille max en octets d'un buffer de raw_size octets une fois compressé
+Int64 buf_compress_max_size(Int64 raw_size);
+
+/*!
+ * \brief Compresse in dans out, retourne la taille compressée en octets
+ * data_size : taille d'une valeur (sizeof(DataType)) pour le XOR avec la valeur précédente
+ * tmp : buffer de travail redimensionné si besoin
+ */
+Int64 buf_compress(eBufCompression bc, Int64 data_size,
+    ConstArrayView<Byte> in, ArrayView<Byte> out, UniqueArray<Byte>& tmp);
+
+/*!
+ * \brief Décompresse in (de taille compressée in.size()) dans out
+ * out.size() doit être la taille non compressée
+ */
+void buf_decompress(eBufCompression bc, Int64 data_size,
+    ConstArrayView<Byte> in, ArrayView<Byte> out, UniqueArray<Byte>& tmp);
+
+/*---------------------------------------------------------------------------*/
+/* Cumul des tailles non compressées/compressées par variable                */
+/*---------------------------------------------------------------------------*/
+class BufCompressionStats {
+ public:
+  //! Ajoute raw_size octets compressés en cmp_size octets pour la variable var_name
+  void add(const String& var_name, Int64 raw_size, Int64 cmp_size);
+
+  //! Taux de compression global (taille non compressée / taille compressée)
+  Real ratio() const;
+
+  //! Affiche les taux de compression par variable
+  void print(ITraceMng* tm) const;
+
+ protected:
+  struct Sizes {
+    Int64 m_raw_size=0;
+    Int64 m_cmp_size=0;
+  };
+  std::map<String, Sizes> m_var_sizes;
+  Sizes m_all_sizes;
+};
+
+#endif
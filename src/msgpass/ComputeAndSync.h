@@ -12,12 +12,16 @@
 /*                                                                           */
 /* Synchronise les items fantômes de var en utilisant ref_queue              */
 /* La queue ref_queue est synchronisée à la sortie de la méthode             */
+/* Seules les couches fantômes 1..ghost_depth sont synchronisées (<=0 :      */
+/* toutes), sauf avec VS_bulksync_std qui passe par Arcane                   */
 /*---------------------------------------------------------------------------*/
 template<typename MeshVariableRefT>
 void VarSyncMng::
-globalSynchronize(Ref<RunQueue> ref_queue, MeshVariableRefT var, eVarSyncVersion vs_version) {
+globalSynchronize(Ref<RunQueue> ref_queue, MeshVariableRefT var, eVarSyncVersion vs_version,
+    Integer ghost_depth) {
 
   MeshVariableSynchronizerList mvsl(this);
+  mvsl.setGhostDepth(ghost_depth);
   mvsl.add(var);
 
   this->synchronize(mvsl, ref_queue, vs_version);
@@ -136,19 +140,14 @@ computeAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
 {
   PROF_ACC_BEGIN(__FUNCTION__);
 
-  // Les seuls groupes supportés sont "own" ou "all"
-  typename SyncItems<ItemType>::eGroupCategory group_category;
-  if (item_group == get_own_items<ItemType>(m_mesh)) {
-    group_category = SyncItems<ItemType>::GC_own;
-  } else if (item_group == get_all_items<ItemType>(m_mesh)) {
-    group_category = SyncItems<ItemType>::GC_all;
-    if (vs_version != VS_nosync) {
-      throw NotSupportedException(A_FUNCINFO, 
-	  String::format("eVarSyncVersion={0} utilisé : \"all\" ne peut se combiner qu'avec VS_nosync", (int)vs_version));
-    }
-  } else {
+  // Tout groupe est supporté, il est découpé en items private et items de bord
+  // par intersection avec les SyncItems (découpage mis en cache par groupe)
+  SyncItems<ItemType>* sync_items = this->getSyncItems<ItemType>();
+  if (vs_version != VS_nosync && sync_items->hasGhostItems(item_group)) {
+    // Les valeurs calculées sur les fantômes seraient écrasées par la synchro
     throw NotSupportedException(A_FUNCINFO, 
-	String("Les seuls groupes supportés sont \"own\" ou \"all\""));
+        String::format("eVarSyncVersion={0} utilisé : un groupe avec des items fantômes ({1}) ne peut se combiner qu'avec VS_nosync", 
+          (int)vs_version, item_group.name()));
   }
 
   // Pour qu'une queue attende des événements avant de commencer
@@ -161,11 +160,21 @@ computeAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
   if (vs_version == VS_auto) {
     vs_version = defaultVarSyncVersion();
   }
+
+  if (vs_version == VS_autotune) {
+    // La version est choisie après chronométrage des versions candidates
+    VarSyncTuner::Trial trial = m_vsync_tuner->beginTrial(vars.varsList(), VarSyncTuner::OK_compute_and_sync);
+    computeAndSyncOnEvents<ItemType, Func>(depends_on_evts, item_group, func, vars, trial.m_version);
+    m_vsync_tuner->endTrial(trial);
+    PROF_ACC_END;
+    return;
+  }
   
   ITraceMng* tm = m_mesh->traceMng();
   if (vs_version == VS_bulksync_std ||
       vs_version == VS_bulksync_evqueue ||
-      vs_version == VS_bulksync_evqueue_d) 
+      vs_version == VS_bulksync_evqueue_d ||
+      vs_version == VS_bulksync_neighcoll) 
   {
     // Calcul sur tous les items de item_group
     auto ref_queue = AcceleratorUtils::refQueueAsync(m_runner, QP_default); 
@@ -182,21 +191,20 @@ computeAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
 
   } 
   else if (vs_version == VS_overlap_evqueue ||
-      vs_version == VS_overlap_evqueue_d) 
+      vs_version == VS_overlap_evqueue_d ||
+      vs_version == VS_overlap_neighcoll) 
   {
-    SyncItems<ItemType>* sync_items = this->getSyncItems<ItemType>();
-
     // On amorce sur le DEVICE le calcul sur les items dont dépendent
     // les comms sur la queue m_ref_queue_bnd (_bnd = boundary)
     depends_on(m_ref_queue_bnd, depends_on_evts);
-    func(sync_items->boundaryItems(group_category), m_ref_queue_bnd.get());
+    func(sync_items->boundaryItems(item_group), m_ref_queue_bnd.get());
     // ici, le calcul n'est pas terminé sur le DEVICE
 
     // On amorce sur le DEVICE le calcul des items intérieurs dont ne dépendent
     // pas les comms sur la queue ref_queue_inr (_inr = inner)
     Ref<RunQueue> ref_queue_inr = AcceleratorUtils::refQueueAsync(m_runner, QP_default);
     depends_on(ref_queue_inr, depends_on_evts);
-    func(sync_items->privateItems(), ref_queue_inr.get());
+    func(sync_items->privateItems(item_group), ref_queue_inr.get());
 
     // Sur la même queue de bord m_ref_queue_bnd, on amorce le packing des données
     // puis les comms MPI sur CPU, puis unpacking des données et on synchronise 
@@ -206,6 +214,30 @@ computeAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
     // On attend la terminaison des calculs intérieurs
     ref_queue_inr->barrier();
   } 
+  else if (vs_version == VS_overlap_host) 
+  {
+    // Sans accélérateur, les queues sont synchrones : le recouvrement est
+    // obtenu en calculant les items intérieurs sur un thread dédié
+    // (boucles multi-threadées si les tâches sont actives)
+    Ref<RunQueue> ref_queue_inr = AcceleratorUtils::refQueueAsync(m_runner, QP_default);
+    depends_on(ref_queue_inr, depends_on_evts);
+    auto private_items = sync_items->privateItems(item_group);
+    // La tâche attend sa fin même si le thread appelant lève une exception
+    HostWorkerTask host_task(_hostWorker(), [&]() {
+      func(private_items, ref_queue_inr.get());
+      ref_queue_inr->barrier();
+    });
+
+    // Pendant ce temps, le thread appelant calcule les items de bord
+    // puis effectue pack/send/recv/unpack (seul thread à faire des comms)
+    depends_on(m_ref_queue_bnd, depends_on_evts);
+    func(sync_items->boundaryItems(item_group), m_ref_queue_bnd.get());
+    m_ref_queue_bnd->barrier();
+    this->synchronize(vars, m_ref_queue_bnd, vs_version);
+
+    // On attend la terminaison des calculs intérieurs
+    host_task.wait();
+  } 
   else if (vs_version == VS_overlap_iqueue) 
   {
     tm->debug() << "overlap_iqueue";
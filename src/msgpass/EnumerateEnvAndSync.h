@@ -112,11 +112,25 @@ enumerateEnvAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
       // TODO : enregistrer un événement sur menv_queue->queue(env_id)
     }
   };
+
+  if (vs_version == VS_auto) {
+    vs_version = defaultVarSyncVersion();
+  }
+
+  if (vs_version == VS_autotune) {
+    // La version est choisie après chronométrage des versions candidates
+    VarSyncTuner::Trial trial = m_vsync_tuner->beginTrial(vars.varsList(), VarSyncTuner::OK_enumerate_env_and_sync);
+    enumerateEnvAndSyncOnEvents<Func>(depends_on_evts, func, vars, trial.m_version);
+    m_vsync_tuner->endTrial(trial);
+    PROF_ACC_END;
+    return;
+  }
   
   ITraceMng* tm = m_mesh->traceMng();
   if (vs_version == VS_bulksync_std ||
       vs_version == VS_bulksync_evqueue ||
-      vs_version == VS_bulksync_evqueue_d) 
+      vs_version == VS_bulksync_evqueue_d ||
+      vs_version == VS_bulksync_neighcoll) 
   {
     // Calcul sur les EnvVarIndex(es) intérieurs "own"
     auto own_levis_penv = m_sync_evi->ownEviPenv();
@@ -136,7 +150,8 @@ enumerateEnvAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
 
   } 
   else if (vs_version == VS_overlap_evqueue ||
-      vs_version == VS_overlap_evqueue_d) 
+      vs_version == VS_overlap_evqueue_d ||
+      vs_version == VS_overlap_neighcoll) 
   {
     // On amorce sur le DEVICE le calcul sur les EnvVarIndex(es) "shared" sur 
     // le bord du sous-domaine sur la queue m_menv_queue_bnd (_bnd = boundary)
@@ -164,6 +179,29 @@ enumerateEnvAndSyncOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
     // On attend la terminaison des calculs intérieurs
     m_menv_queue_inr->waitAllQueues();
   } 
+  else if (vs_version == VS_overlap_host) 
+  {
+    // La queue va dépendre des événements de depends_on_evts
+    wait_for(depends_on_evts);
+
+    // Les EnvVarIndex(es) intérieurs sont calculés sur un thread dédié
+    auto private_levis_penv = m_sync_evi->privateEviPenv();
+    // La tâche attend sa fin même si le thread appelant lève une exception
+    HostWorkerTask host_task(_hostWorker(), [&]() {
+      allenv_func(private_levis_penv, m_menv_queue_inr);
+      m_menv_queue_inr->waitAllQueues();
+    });
+
+    // Pendant ce temps, le thread appelant calcule les EnvVarIndex(es) "shared"
+    // puis effectue les comms
+    auto shared_levis_penv = m_sync_evi->sharedEviPenv();
+    allenv_func(shared_levis_penv, m_menv_queue_bnd);
+    m_menv_queue_bnd->waitAllQueues();
+    this->synchronize(vars, m_ref_queue_bnd, vs_version);
+
+    // On attend la terminaison des calculs intérieurs
+    host_task.wait();
+  } 
   else if (vs_version == VS_overlap_iqueue) 
   {
     tm->debug() << "overlap_iqueue";
@@ -0,0 +1,80 @@
+#include "msgpass/HostWorkerThread.h"
+
+#include <arccore/base/FatalErrorException.h>
+
+using namespace Arccore;
+
+/*---------------------------------------------------------------------------*/
+/* \class HostWorkerThread                                                   */
+/* \brief Persistent host thread executing one task at a time                */
+/*---------------------------------------------------------------------------*/
+
+HostWorkerThread::HostWorkerThread() {
+  m_thread = std::thread([this]() { _loop(); });
+}
+
+HostWorkerThread::~HostWorkerThread() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Execute task on the worker thread                                         */
+/*---------------------------------------------------------------------------*/
+void HostWorkerThread::post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_has_task) {
+      throw FatalErrorException(A_FUNCINFO, "Une tache est deja en cours sur le thread");
+    }
+    m_task = std::move(task);
+    m_has_task = true;
+  }
+  m_cv.notify_all();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for the end of the posted task                                       */
+/*---------------------------------------------------------------------------*/
+void HostWorkerThread::wait() {
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_has_task; });
+    std::swap(exception, m_exception);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Boucle du thread : attend une tâche, l'exécute, signale sa fin            */
+/*---------------------------------------------------------------------------*/
+void HostWorkerThread::_loop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true) {
+    m_cv.wait(lock, [this]() { return m_has_task || m_stop; });
+    if (m_has_task) {
+      lock.unlock();
+      std::exception_ptr exception;
+      try {
+        m_task();
+      } catch(...) {
+        exception = std::current_exception();
+      }
+      lock.lock();
+      m_exception = exception;
+      m_task = nullptr;
+      m_has_task = false;
+      m_cv.notify_all();
+    } else if (m_stop) {
+      return;
+    }
+  }
+}
+
@@ -0,0 +1,80 @@
+#ifndef MSG_PASS_HOST_WORKER_THREAD_H
+#define MSG_PASS_HOST_WORKER_THREAD_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*---------------------------------------------------------------------------*/
+/* \class HostWorkerThread                                                   */
+/* \brief Persistent host thread executing one task at a time                */
+/*                                                                           */
+/* Used to compute on the host while the calling thread communicates (the    */
+/* comms stay on the calling thread, MPI_THREAD_FUNNELED is enough). An      */
+/* exception thrown by the task is rethrown by wait().                       */
+/*---------------------------------------------------------------------------*/
+class HostWorkerThread {
+ public:
+  HostWorkerThread();
+  virtual ~HostWorkerThread();
+
+  //! Execute task on the worker thread (the previous task must be finished)
+  void post(std::function<void()> task);
+
+  //! Wait for the end of the posted task
+  void wait();
+
+ protected:
+  void _loop();
+
+ protected:
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::function<void()> m_task;
+  bool m_has_task=false;
+  bool m_stop=false;
+  std::exception_ptr m_exception;
+};
+
+/*---------------------------------------------------------------------------*/
+/* \class HostWorkerTask                                                     */
+/* \brief Scoped task posted on a HostWorkerThread                           */
+/*                                                                           */
+/* The destructor waits for the task if wait() was not called, so that the   */
+/* worker never outlives the references captured by the task when the        */
+/* calling thread unwinds (the task exception is then dropped).              */
+/*---------------------------------------------------------------------------*/
+class HostWorkerTask {
+ public:
+  HostWorkerTask(HostWorkerThread* worker, std::function<void()> task)
+  : m_worker(worker) {
+    m_worker->post(std::move(task));
+  }
+
+  ~HostWorkerTask() {
+    if (m_worker) {
+      try {
+        m_worker->wait();
+      } catch(...) {
+      }
+    }
+  }
+
+  HostWorkerTask(const HostWorkerTask&) = delete;
+  HostWorkerTask& operator=(const HostWorkerTask&) = delete;
+
+  //! Wait for the end of the task and rethrow its exception
+  void wait() {
+    HostWorkerThread* worker = m_worker;
+    m_worker = nullptr;
+    worker->wait();
+  }
+
+ protected:
+  HostWorkerThread* m_worker=nullptr;
+};
+
+#endif
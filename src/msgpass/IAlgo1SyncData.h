@@ -1,6 +1,8 @@
 #ifndef MSG_PASS_I_ALGO1_SYNC_DATA_H
 #define MSG_PASS_I_ALGO1_SYNC_DATA_H
 
+#include "accenv/AcceleratorUtils.h"
+
 #include <arcane/utils/ArrayView.h>
 
 using namespace Arcane;
@@ -43,6 +45,15 @@ class IAlgo1SyncData {
 
   //! Finalize if no communication needed 
   virtual void finalizeWoComm() = 0;
+
+  /* Per-neighbour progress : after initComm(), may be called concurrently */
+  /* by different threads for different neighbours (VarSyncNeighThreads)   */
+
+  //! Pack the values to send to the neighbour inei on queue, sendBuf(inei) is ready at return
+  virtual void packNeigh(Integer inei, RunQueue& queue) = 0;
+
+  //! Unpack the values received from the neighbour inei on queue, done at return
+  virtual void unpackNeigh(Integer inei, RunQueue& queue) = 0;
 };
 
 #endif
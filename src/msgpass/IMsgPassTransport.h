@@ -0,0 +1,40 @@
+#ifndef MSG_PASS_I_MSG_PASS_TRANSPORT_H
+#define MSG_PASS_I_MSG_PASS_TRANSPORT_H
+
+#include <arcane/utils/ArrayView.h>
+
+using namespace Arcane;
+
+/*---------------------------------------------------------------------------*/
+/* Class interface of the point-to-point transport used by VarSyncAlgo1      */
+/*                                                                           */
+/* A request is identified by an index ireq given by the caller, unique      */
+/* among the requests of an exchange (VarSyncAlgo1 uses [0,nb_nei[ for the   */
+/* receipts and [nb_nei,2*nb_nei[ for the sendings).                         */
+/*---------------------------------------------------------------------------*/
+class IMsgPassTransport {
+ public:
+
+  //! Destructor to override
+  virtual ~IMsgPassTransport() {}
+
+  //! Post a non-blocking receipt of buf from rank
+  virtual void postRecv(Integer ireq, ArrayView<Byte> buf, Int32 rank) = 0;
+
+  //! Post a non-blocking sending of buf to rank
+  virtual void postSend(Integer ireq, ArrayView<Byte> buf, Int32 rank) = 0;
+
+  //! Wait for at least one pending request, fill done_ireqs and return the number of them
+  virtual Integer waitSome(ArrayView<Integer> done_ireqs) = 0;
+
+  //! Same as waitSome but return 0 if no request is completed
+  virtual Integer testSome(ArrayView<Integer> done_ireqs) = 0;
+
+  //! Wait for all the pending requests
+  virtual void waitAll() = 0;
+
+  //! Number of pending requests
+  virtual Integer nbPending() const = 0;
+};
+
+#endif
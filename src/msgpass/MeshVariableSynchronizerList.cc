@@ -3,6 +3,8 @@
 #include "msgpass/PackTransfer.h"
 #include "msgpass/VarSyncMng.h"
 
+#include <arcane/utils/FatalErrorException.h>
+
 /*---------------------------------------------------------------------------*/
 /* CellMatVarScalSync<DataType> : a Cell multi-mat variable to synchronize   */
 /*---------------------------------------------------------------------------*/
@@ -61,8 +63,8 @@ template<typename DataType>
 size_t CellMatVarScalSync<DataType>::sizeInBytes(eItemSync item_sync, Integer inei) const
 {
   auto item_sizes = (item_sync == IS_owned ? 
-      m_sync_evi->nbOwnedEviPn() :
-      m_sync_evi->nbGhostEviPn());
+      m_sync_evi->nbOwnedEviPn(m_ghost_depth) :
+      m_sync_evi->nbGhostEviPn(m_ghost_depth));
 
   size_t sizeof_item = sizeof(DataType)*1;  // 1 = degree
   size_t sz_nei_in_bytes = item_sizes[inei]*sizeof_item;
@@ -76,7 +78,7 @@ void CellMatVarScalSync<DataType>::asyncPackOwnedIntoBuf(
     Integer inei,
     ArrayView<Byte> buf, RunQueue& queue)  
 {
-  ConstArrayView<EnvVarIndex> levis = m_sync_evi->ownedEviPn()[inei];  // Owned
+  ConstArrayView<EnvVarIndex> levis = m_sync_evi->ownedEviPn(m_ghost_depth)[inei];  // Owned
   auto command = makeCommand(queue);
 
   auto in_var_menv = m_menv_var.spanD();
@@ -97,7 +99,7 @@ void CellMatVarScalSync<DataType>::asyncUnpackGhostFromBuf(
     Integer inei,
     ArrayView<Byte> buf, RunQueue& queue)  
 {
-  ConstArrayView<EnvVarIndex> levis = m_sync_evi->ghostEviPn()[inei];  // Ghost
+  ConstArrayView<EnvVarIndex> levis = m_sync_evi->ghostEviPn(m_ghost_depth)[inei];  // Ghost
   auto command = makeCommand(queue);
 
   auto out_var_menv = m_menv_var.spanD();
@@ -112,6 +114,13 @@ void CellMatVarScalSync<DataType>::asyncUnpackGhostFromBuf(
   }; // asynchrone
 }
 
+//! New instance on the same variable (multi-mat addresses managed by bam)
+template<typename DataType>
+IMeshVarSync* CellMatVarScalSync<DataType>::clone(BufAddrMng* bam)
+{
+  return new CellMatVarScalSync<DataType>(m_var, m_sync_evi, bam);
+}
+
 /*---------------------------------------------------------------------------*/
 /* GlobVarSync<MeshVariableRefT> : a global variable to synchronize          */
 /*---------------------------------------------------------------------------*/
@@ -168,8 +177,8 @@ template<typename MeshVariableRefT>
 size_t GlobVarSync<MeshVariableRefT>::sizeInBytes(eItemSync item_sync, Integer inei) const
 {
   auto item_sizes = (item_sync == IS_owned ? 
-      m_sync_items->nbOwnedItemIdxPn() :
-      m_sync_items->nbGhostItemIdxPn());
+      m_sync_items->nbOwnedItemIdxPn(m_ghost_depth) :
+      m_sync_items->nbGhostItemIdxPn(m_ghost_depth));
 
   size_t sizeof_item = sizeof(DataType)*m_degree;
   size_t sz_nei_in_bytes = item_sizes[inei]*sizeof_item;
@@ -183,7 +192,7 @@ void GlobVarSync<MeshVariableRefT>::asyncPackOwnedIntoBuf(
     Integer inei,
     ArrayView<Byte> buf, RunQueue& queue)  
 {
-  auto owned_item_idx = m_sync_items->ownedItemIdxPn()[inei];
+  auto owned_item_idx = m_sync_items->ownedItemIdxPn(m_ghost_depth)[inei];
   async_pack_var2buf(owned_item_idx, m_var, buf, queue);
 }
 
@@ -193,10 +202,17 @@ void GlobVarSync<MeshVariableRefT>::asyncUnpackGhostFromBuf(
     Integer inei,
     ArrayView<Byte> buf, RunQueue& queue)  
 {
-  auto ghost_item_idx = m_sync_items->ghostItemIdxPn()[inei];
+  auto ghost_item_idx = m_sync_items->ghostItemIdxPn(m_ghost_depth)[inei];
   async_unpack_buf2var(ghost_item_idx, buf, m_var, queue);
 }
 
+//! New instance on the same variable (multi-mat addresses managed by bam)
+template<typename MeshVariableRefT>
+IMeshVarSync* GlobVarSync<MeshVariableRefT>::clone([[maybe_unused]] BufAddrMng* bam)
+{
+  return new GlobVarSync<MeshVariableRefT>(m_var, m_sync_items);
+}
+
 /*---------------------------------------------------------------------------*/
 /* MeshVariableSynchronizerList : List of mesh variables to synchronize      */
 /*---------------------------------------------------------------------------*/
@@ -206,27 +222,38 @@ MeshVariableSynchronizerList::MeshVariableSynchronizerList(VarSyncMng* vsync_mng
   m_buf_addr_mng = m_vsync_mng->bufAddrMng();
 }
 
+MeshVariableSynchronizerList::MeshVariableSynchronizerList(VarSyncMng* vsync_mng,
+    BufAddrMng* bam) :
+  m_vsync_mng (vsync_mng),
+  m_buf_addr_mng (bam)
+{
+}
+
 MeshVariableSynchronizerList::~MeshVariableSynchronizerList() {
-  for(auto v : m_vars) {
-    delete v;
-  }
-  m_buf_addr_mng->reset();
+  clear();
 }
 
 //! Add a multi-mat variable into the list of variables to synchronize
 template<typename DataType>
-void MeshVariableSynchronizerList::add(CellMaterialVariableScalarRef<DataType> var_menv) {
+void MeshVariableSynchronizerList::add(CellMaterialVariableScalarRef<DataType> var_menv,
+    eBufCompression bc) {
   auto sync_evi = m_vsync_mng->syncEnvIndexes();
-  m_vars.add(new CellMatVarScalSync<DataType>(var_menv, sync_evi, m_buf_addr_mng));
+  IMeshVarSync* var = new CellMatVarScalSync<DataType>(var_menv, sync_evi, m_buf_addr_mng);
+  var->setBufCompression(bc);
+  var->setGhostDepth(m_ghost_depth);
+  m_vars.add(var);
 }
 
 //! Add a global variable into the list of variables to synchronize
 template<typename MeshVariableRefT>
-void MeshVariableSynchronizerList::add(MeshVariableRefT var) {
+void MeshVariableSynchronizerList::add(MeshVariableRefT var, eBufCompression bc) {
   using ItemType = typename MeshVariableRefT::ItemType;
   SyncItems<ItemType>* sync_items = m_vsync_mng->getSyncItems<ItemType>();
 
-  m_vars.add(new GlobVarSync<MeshVariableRefT>(var, sync_items));
+  IMeshVarSync* gvar = new GlobVarSync<MeshVariableRefT>(var, sync_items);
+  gvar->setBufCompression(bc);
+  gvar->setGhostDepth(m_ghost_depth);
+  m_vars.add(gvar);
 }
 
 //! Return the list of variables to synchronize
@@ -234,9 +261,65 @@ ConstArrayView<IMeshVarSync*> MeshVariableSynchronizerList::varsList() const {
   return m_vars;
 }
 
+//! True if at least one variable has its comm buffers compressed
+bool MeshVariableSynchronizerList::hasBufCompression() const {
+  for(auto v : m_vars) {
+    if (v->bufCompression()!=BC_none) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Only synchronize the ghost layers 1..depth (<=0 : all the layers)
+void MeshVariableSynchronizerList::setGhostDepth(Integer depth) {
+  m_ghost_depth = depth;
+  for(auto v : m_vars) {
+    v->setGhostDepth(depth);
+  }
+}
+
 //! Asynchronous pointers tranfer onto device
 void MeshVariableSynchronizerList::asyncHToD(RunQueue& queue) {
-  m_buf_addr_mng->asyncCpyHToD(queue);
+  if (m_buf_addr_mng) {
+    m_buf_addr_mng->asyncCpyHToD(queue);
+  }
+}
+
+//! Add copies of the variables of vars (a variable already in the list is not added)
+void MeshVariableSynchronizerList::append(const MeshVariableSynchronizerList& vars) {
+  for(auto var : vars.varsList()) {
+    bool is_present = false;
+    for(auto v : m_vars) {
+      if (v->isSameVariable(var)) {
+        is_present = true;
+        break;
+      }
+    }
+    if (!is_present) {
+      if (var->materialVariable() && !m_buf_addr_mng) {
+        throw FatalErrorException(A_FUNCINFO, 
+            "Impossible d'ajouter une variable multi-mat sans BufAddrMng");
+      }
+      // Les adresses multi-mat de la copie sont gérées par m_buf_addr_mng
+      // et ne dépendent donc plus de la durée de vie de vars
+      IMeshVarSync* cvar = var->clone(m_buf_addr_mng);
+      cvar->setBufCompression(var->bufCompression());
+      cvar->setGhostDepth(var->ghostDepth());
+      m_vars.add(cvar);
+    }
+  }
+}
+
+//! Remove all the variables
+void MeshVariableSynchronizerList::clear() {
+  for(auto v : m_vars) {
+    delete v;
+  }
+  m_vars.clear();
+  if (m_buf_addr_mng) {
+    m_buf_addr_mng->reset();
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -245,7 +328,7 @@ void MeshVariableSynchronizerList::asyncHToD(RunQueue& queue) {
 #include <arcane/utils/Real3x3.h>
 
 #define INST_MESH_VAR_SYNC_LIST_ADD(__DataType__) \
-  template void MeshVariableSynchronizerList::add(CellMaterialVariableScalarRef<__DataType__> var_menv)
+  template void MeshVariableSynchronizerList::add(CellMaterialVariableScalarRef<__DataType__> var_menv, eBufCompression bc)
 
 INST_MESH_VAR_SYNC_LIST_ADD(Integer);
 INST_MESH_VAR_SYNC_LIST_ADD(Real);
@@ -253,7 +336,7 @@ INST_MESH_VAR_SYNC_LIST_ADD(Real3);
 INST_MESH_VAR_SYNC_LIST_ADD(Real3x3);
 
 #define INST_MESH_VAR_SYNC_LIST_ADDG(__MeshVariableRefT__) \
-  template void MeshVariableSynchronizerList::add(__MeshVariableRefT__ var)
+  template void MeshVariableSynchronizerList::add(__MeshVariableRefT__ var, eBufCompression bc)
 
 INST_MESH_VAR_SYNC_LIST_ADDG(VariableCellInteger);
 
@@ -4,6 +4,7 @@
 #include "accenv/MultiEnvUtils.h"
 #include "msgpass/SyncItems.h"
 #include "msgpass/SyncEnvIndexes.h"
+#include "msgpass/VarSyncMngOptions.h"
 
 #include <arcane/materials/MeshMaterialVariable.h>
 
@@ -54,6 +55,32 @@ class IMeshVarSync {
   //! Asynchronously unpack "ghost" items with neighbour <inei> from the buffer (buf)
   virtual void asyncUnpackGhostFromBuf(Integer inei, ArrayView<Byte> buf, 
       RunQueue& queue) = 0;
+
+  //! New instance on the same variable (multi-mat addresses managed by bam)
+  virtual IMeshVarSync* clone(BufAddrMng* bam) = 0;
+
+  //! True if rhs synchronizes the same variable
+  bool isSameVariable(IMeshVarSync* rhs) {
+    return (variable() && variable()==rhs->variable()) ||
+      (materialVariable() && materialVariable()==rhs->materialVariable());
+  }
+
+  //! Name of the synchronized variable
+  String name() {
+    return (variable() ? variable()->name() : materialVariable()->name());
+  }
+
+  //! Lossless compression of the comm buffers of the variable
+  eBufCompression bufCompression() const { return m_buf_compression; }
+  void setBufCompression(eBufCompression bc) { m_buf_compression = bc; }
+
+  //! Number of ghost layers to synchronize (<=0 : all the layers)
+  Integer ghostDepth() const { return m_ghost_depth; }
+  void setGhostDepth(Integer depth) { m_ghost_depth = depth; }
+
+ protected:
+  eBufCompression m_buf_compression=BC_none;
+  Integer m_ghost_depth=0;
 };
 
 /*---------------------------------------------------------------------------*/
@@ -93,6 +120,9 @@ class CellMatVarScalSync : public IMeshVarSync {
   void asyncUnpackGhostFromBuf(Integer inei, ArrayView<Byte> buf, 
       RunQueue& queue) override;
 
+  //! New instance on the same variable (multi-mat addresses managed by bam)
+  IMeshVarSync* clone(BufAddrMng* bam) override;
+
  protected:
   CellMaterialVariableScalarRef<DataType> m_var;  //! Variable to synchronize
   MultiEnvVarHD<DataType> m_menv_var;  //! View memories on multi-mat data in HOST/DEVICE
@@ -137,6 +167,9 @@ class GlobVarSync : public IMeshVarSync {
   void asyncUnpackGhostFromBuf(Integer inei, ArrayView<Byte> buf, 
       RunQueue& queue) override;
 
+  //! New instance on the same variable (multi-mat addresses managed by bam)
+  IMeshVarSync* clone(BufAddrMng* bam) override;
+
  protected:
   MeshVariableRefT m_var;  //! Variable to synchronize
   SyncItems<ItemType>* m_sync_items;  //! Items to synchronize
@@ -152,26 +185,44 @@ class MeshVariableSynchronizerList {
  public:
   MeshVariableSynchronizerList(VarSyncMng* vsync_mng);
 
+  //! Multi-mat addresses managed by bam instead of vsync_mng->bufAddrMng()
+  MeshVariableSynchronizerList(VarSyncMng* vsync_mng, BufAddrMng* bam);
+
   virtual ~MeshVariableSynchronizerList();
 
   //! Add a multi-mat variable into the list of variables to synchronize
   template<typename DataType>
-  void add(CellMaterialVariableScalarRef<DataType> var_menv);
+  void add(CellMaterialVariableScalarRef<DataType> var_menv,
+      eBufCompression bc=BC_none);
 
   //! Add a global variable into the list of variables to synchronize
   template<typename MeshVariableRefT>
-  void add(MeshVariableRefT var);
+  void add(MeshVariableRefT var, eBufCompression bc=BC_none);
 
   //! Return the list of variables to synchronize
   ConstArrayView<IMeshVarSync*> varsList() const;
 
+  //! True if at least one variable has its comm buffers compressed
+  bool hasBufCompression() const;
+
+  //! Only synchronize the ghost layers 1..depth of the variables already in
+  //! the list and of the next ones (<=0 : all the layers)
+  void setGhostDepth(Integer depth);
+
   //! Asynchronous pointers tranfer onto device
   void asyncHToD(RunQueue& queue);
 
+  //! Add copies of the variables of vars (a variable already in the list is not added)
+  void append(const MeshVariableSynchronizerList& vars);
+
+  //! Remove all the variables
+  void clear();
+
  protected:
   VarSyncMng* m_vsync_mng=nullptr;
   BufAddrMng* m_buf_addr_mng=nullptr;
   UniqueArray<IMeshVarSync*> m_vars;  //! List of variables to synchronize
+  Integer m_ghost_depth=0;  //! Ghost layers to synchronize for the next added variables
 };
 
 #endif
@@ -1,36 +1,69 @@
 #ifdef MSG_PASS_HAS_MPI
 #include <arcane/utils/ArcaneGlobal.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <mpi.h>
 
 using namespace Arcane;
 
-void msg_pass_init([[maybe_unused]] int* argc, [[maybe_unused]] char*** argv) {
+/*! \brief Vrai si le niveau MPI_THREAD_MULTIPLE doit être demandé : compilé
+ * avec USE_THREAD_MULTIPLE ou variable d'environnement P4GPU_MPI_THREAD_MULTIPLE=1
+ * (le jeu de données n'est pas encore lu à l'initialisation de MPI)
+ */
+static bool want_thread_multiple() {
 //#define USE_THREAD_MULTIPLE
 #ifdef USE_THREAD_MULTIPLE
-  // On impose le niveau MPI_THREAD_MULTIPLE
-  Integer provided;
-  MPI_Init_thread(argc, argv, MPI_THREAD_MULTIPLE, &provided);
-  ARCANE_ASSERT(provided==MPI_THREAD_MULTIPLE, 
-      ("Impossible d'utiliser le niveau MPI_THREAD_MULTIPLE"));
-  Integer rank;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  if (rank==0) {
-    if (provided==MPI_THREAD_SERIALIZED)
-      std::cout << "MPI_THREAD_SERIALIZED" << std::endl;
-    else if (provided==MPI_THREAD_MULTIPLE)
-      std::cout << "MPI_THREAD_MULTIPLE" << std::endl;
-    else
-      std::cout << "MPI_THREAD_{SINGLE|FUNNELED}" << std::endl;
-  }
-  // Fin init MPI en dur
+  return true;
+#else
+  const char* env = std::getenv("P4GPU_MPI_THREAD_MULTIPLE");
+  return (env && std::strcmp(env, "0")!=0);
 #endif
 }
+
+void msg_pass_init(int* argc, char*** argv) {
+  if (want_thread_multiple()) {
+    // On demande le niveau MPI_THREAD_MULTIPLE, Arcane utilisera MPI déjà initialisé
+    int provided;
+    MPI_Init_thread(argc, argv, MPI_THREAD_MULTIPLE, &provided);
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank==0) {
+      if (provided==MPI_THREAD_SERIALIZED)
+        std::cout << "MPI_THREAD_SERIALIZED" << std::endl;
+      else if (provided==MPI_THREAD_MULTIPLE)
+        std::cout << "MPI_THREAD_MULTIPLE" << std::endl;
+      else
+        std::cout << "MPI_THREAD_{SINGLE|FUNNELED}" << std::endl;
+      if (provided!=MPI_THREAD_MULTIPLE) {
+        std::cout << "WARNING : niveau MPI_THREAD_MULTIPLE non fourni, pas de threads de progression par voisin" << std::endl;
+      }
+    }
+  }
+}
+
+/*! \brief Vrai si MPI est initialisé avec le niveau MPI_THREAD_MULTIPLE
+ * (par msg_pass_init ou par Arcane)
+ */
+bool is_mpi_thread_multiple() {
+  int is_init=0;
+  MPI_Initialized(&is_init);
+  if (!is_init) {
+    return false;
+  }
+  int provided;
+  MPI_Query_thread(&provided);
+  return (provided==MPI_THREAD_MULTIPLE);
+}
 #else
 #ifdef P4GPU_HAS_WARNING_INFO
 #warning "MPI non détecté : msg_pass_init(...) vide"
 #endif
 void msg_pass_init(int* , char*** ) {
 }
+
+bool is_mpi_thread_multiple() {
+  return false;
+}
 #endif
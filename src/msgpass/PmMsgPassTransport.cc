@@ -0,0 +1,106 @@
+#include "msgpass/PmMsgPassTransport.h"
+
+#include <arccore/base/FatalErrorException.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class PmMsgPassTransport                                                 */
+/* \brief Transport by the send/recv of IParallelMng (MPI, threads or both)  */
+/*---------------------------------------------------------------------------*/
+
+PmMsgPassTransport::PmMsgPassTransport(IParallelMng* pm, Integer max_nb_req) :
+  m_pm (pm)
+{
+  m_requests.resize(max_nb_req);
+  m_ireqs.resize(max_nb_req);
+  m_is_done_req.resize(max_nb_req);
+}
+
+PmMsgPassTransport::~PmMsgPassTransport() {
+}
+
+/*---------------------------------------------------------------------------*/
+/* Post a non-blocking receipt of buf from rank                              */
+/*---------------------------------------------------------------------------*/
+void PmMsgPassTransport::postRecv(Integer ireq, ArrayView<Byte> buf, Int32 rank) {
+  if (m_nb_pending>=m_requests.size()) {
+    throw FatalErrorException(A_FUNCINFO, "Trop de requetes en cours");
+  }
+  m_requests[m_nb_pending] = m_pm->recv(buf, rank, /*blocking=*/false);
+  m_ireqs[m_nb_pending] = ireq;
+  m_nb_pending++;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Post a non-blocking sending of buf to rank                                */
+/*---------------------------------------------------------------------------*/
+void PmMsgPassTransport::postSend(Integer ireq, ArrayView<Byte> buf, Int32 rank) {
+  if (m_nb_pending>=m_requests.size()) {
+    throw FatalErrorException(A_FUNCINFO, "Trop de requetes en cours");
+  }
+  m_requests[m_nb_pending] = m_pm->send(buf, rank, /*blocking=*/false);
+  m_ireqs[m_nb_pending] = ireq;
+  m_nb_pending++;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for at least one pending request                                     */
+/*---------------------------------------------------------------------------*/
+Integer PmMsgPassTransport::waitSome(ArrayView<Integer> done_ireqs) {
+  if (m_nb_pending==0) {
+    return 0;
+  }
+  IntegerUniqueArray done_indexes = m_pm->waitSomeRequests(m_requests.subView(0, m_nb_pending));
+  return _removeDone(done_indexes, done_ireqs);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Same as waitSome but return 0 if no request is completed                  */
+/*---------------------------------------------------------------------------*/
+Integer PmMsgPassTransport::testSome(ArrayView<Integer> done_ireqs) {
+  if (m_nb_pending==0) {
+    return 0;
+  }
+  IntegerUniqueArray done_indexes = m_pm->testSomeRequests(m_requests.subView(0, m_nb_pending));
+  return _removeDone(done_indexes, done_ireqs);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for all the pending requests                                         */
+/*---------------------------------------------------------------------------*/
+void PmMsgPassTransport::waitAll() {
+  if (m_nb_pending>0) {
+    m_pm->waitAllRequests(m_requests.subView(0, m_nb_pending));
+    m_nb_pending = 0;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Remove the completed requests done_indexes from the pending ones          */
+/*---------------------------------------------------------------------------*/
+Integer PmMsgPassTransport::_removeDone(ConstArrayView<Integer> done_indexes,
+    ArrayView<Integer> done_ireqs) {
+
+  ArrayView<bool> is_done_requests(m_is_done_req.subView(0, m_nb_pending));
+  is_done_requests.fill(false);
+
+  Integer nb_done = done_indexes.size();
+  for(Integer i=0 ; i<nb_done ; ++i) {
+    Integer idone_req = done_indexes[i];
+    done_ireqs[i] = m_ireqs[idone_req];
+    is_done_requests[idone_req] = true;
+  }
+
+  // On tasse les requêtes encore en cours en conservant leur ordre
+  Integer upd_nb_pending=0;
+  for(Integer ireq=0 ; ireq<m_nb_pending ; ++ireq) {
+    if (!is_done_requests[ireq]) {
+      m_requests[upd_nb_pending] = m_requests[ireq];
+      m_ireqs[upd_nb_pending] = m_ireqs[ireq];
+      upd_nb_pending++;
+    }
+  }
+  m_nb_pending = upd_nb_pending;
+
+  return nb_done;
+}
+
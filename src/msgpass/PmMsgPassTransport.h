@@ -0,0 +1,50 @@
+#ifndef MSG_PASS_PM_MSG_PASS_TRANSPORT_H
+#define MSG_PASS_PM_MSG_PASS_TRANSPORT_H
+
+#include "msgpass/IMsgPassTransport.h"
+
+#include <arcane/IParallelMng.h>
+#include <arcane/utils/UniqueArray.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class PmMsgPassTransport                                                 */
+/* \brief Transport by the send/recv of IParallelMng (MPI, threads or both)  */
+/*---------------------------------------------------------------------------*/
+class PmMsgPassTransport : public IMsgPassTransport {
+ public:
+  PmMsgPassTransport(IParallelMng* pm, Integer max_nb_req);
+  virtual ~PmMsgPassTransport();
+
+  //! Post a non-blocking receipt of buf from rank
+  void postRecv(Integer ireq, ArrayView<Byte> buf, Int32 rank) override;
+
+  //! Post a non-blocking sending of buf to rank
+  void postSend(Integer ireq, ArrayView<Byte> buf, Int32 rank) override;
+
+  //! Wait for at least one pending request, fill done_ireqs and return the number of them
+  Integer waitSome(ArrayView<Integer> done_ireqs) override;
+
+  //! Same as waitSome but return 0 if no request is completed
+  Integer testSome(ArrayView<Integer> done_ireqs) override;
+
+  //! Wait for all the pending requests
+  void waitAll() override;
+
+  //! Number of pending requests
+  Integer nbPending() const override { return m_nb_pending; }
+
+ protected:
+  //! Remove the completed requests done_indexes from the pending ones
+  Integer _removeDone(ConstArrayView<Integer> done_indexes, ArrayView<Integer> done_ireqs);
+
+ protected:
+  IParallelMng* m_pm=nullptr;
+
+  // Alloués une fois pour toutes pour éviter les allocations à chaque échange
+  Integer m_nb_pending=0;
+  UniqueArray<Parallel::Request> m_requests;  //! Pending requests in [0,m_nb_pending[
+  IntegerUniqueArray m_ireqs;  //! Index given by the caller for each pending request
+  UniqueArray<bool> m_is_done_req;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "msgpass/SimMsgPassTransport.h"
+
+#include <arcane/utils/PlatformUtils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+// Pas max d'attente active lorsque des envois sont retenus (s)
+constexpr Real SIM_MAX_POLL_SLEEP = 20e-6;
+}
+
+/*---------------------------------------------------------------------------*/
+/* \class SimMsgPassTransport                                                */
+/* \brief Transport emulating a network with a given latency and bandwidth   */
+/*   on top of another transport                                             */
+/*---------------------------------------------------------------------------*/
+
+SimMsgPassTransport::SimMsgPassTransport(IMsgPassTransport* inner,
+    Real latency, Real bandwidth) :
+  m_inner     (inner),
+  m_latency   (latency),
+  m_bandwidth (bandwidth)
+{
+}
+
+SimMsgPassTransport::~SimMsgPassTransport() {
+}
+
+/*---------------------------------------------------------------------------*/
+/* Post a non-blocking receipt of buf from rank                              */
+/*---------------------------------------------------------------------------*/
+void SimMsgPassTransport::postRecv(Integer ireq, ArrayView<Byte> buf, Int32 rank) {
+  m_inner->postRecv(ireq, buf, rank);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Hold the sending of buf to rank until its simulated arrival time          */
+/*---------------------------------------------------------------------------*/
+void SimMsgPassTransport::postSend(Integer ireq, ArrayView<Byte> buf, Int32 rank) {
+  Real now = platform::getRealTime();
+
+  // Les messages vers un même rang se partagent le même lien
+  Integer ilink = m_link_ranks.size();
+  for(Integer i=0 ; i<m_link_ranks.size() ; ++i) {
+    if (m_link_ranks[i]==rank) {
+      ilink = i;
+      break;
+    }
+  }
+  if (ilink==m_link_ranks.size()) {
+    m_link_ranks.add(rank);
+    m_link_free_time.add(now);
+  }
+
+  Real transfer_time = (m_bandwidth>0 ? buf.size()/m_bandwidth : 0.);
+  Real start = std::max(now, m_link_free_time[ilink]);
+  m_link_free_time[ilink] = start + transfer_time;
+
+  m_held.add(HeldSending{ireq, buf, rank, start + transfer_time + m_latency});
+
+  // Sans latence ni débit limité, l'envoi part tout de suite
+  _postDueSendings();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for at least one pending request                                     */
+/*---------------------------------------------------------------------------*/
+Integer SimMsgPassTransport::waitSome(ArrayView<Integer> done_ireqs) {
+  while(true) {
+    _postDueSendings();
+    if (m_held.empty()) {
+      // Plus rien de retenu, on peut attendre de façon bloquante
+      return m_inner->waitSome(done_ireqs);
+    }
+    // Un voisin peut attendre un de nos envois retenus : pas d'attente bloquante
+    Integer nb_done = m_inner->testSome(done_ireqs);
+    if (nb_done>0) {
+      return nb_done;
+    }
+    _sleepUntilNextSending(SIM_MAX_POLL_SLEEP);
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Same as waitSome but return 0 if no request is completed                  */
+/*---------------------------------------------------------------------------*/
+Integer SimMsgPassTransport::testSome(ArrayView<Integer> done_ireqs) {
+  _postDueSendings();
+  return m_inner->testSome(done_ireqs);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for all the pending requests                                         */
+/*---------------------------------------------------------------------------*/
+void SimMsgPassTransport::waitAll() {
+  while(!m_held.empty()) {
+    _sleepUntilNextSending(m_latency+1.);
+    _postDueSendings();
+  }
+  m_inner->waitAll();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Number of pending requests (held sendings included)                       */
+/*---------------------------------------------------------------------------*/
+Integer SimMsgPassTransport::nbPending() const {
+  return m_held.size() + m_inner->nbPending();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Post to the inner transport the held sendings whose time has come         */
+/*---------------------------------------------------------------------------*/
+void SimMsgPassTransport::_postDueSendings() {
+  if (m_held.empty()) {
+    return;
+  }
+  Real now = platform::getRealTime();
+  Integer nb_held=0;
+  for(Integer i=0 ; i<m_held.size() ; ++i) {
+    const HeldSending& hs = m_held[i];
+    if (hs.m_release_time<=now) {
+      m_inner->postSend(hs.m_ireq, hs.m_buf, hs.m_rank);
+    } else {
+      m_held[nb_held++] = hs;
+    }
+  }
+  m_held.resize(nb_held);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Sleep until the next held sending (at most max_sleep seconds)             */
+/*---------------------------------------------------------------------------*/
+void SimMsgPassTransport::_sleepUntilNextSending(Real max_sleep) {
+  if (m_held.empty()) {
+    return;
+  }
+  Real next_time = m_held[0].m_release_time;
+  for(const auto& hs : m_held) {
+    next_time = std::min(next_time, hs.m_release_time);
+  }
+  Real dt = std::min(next_time-platform::getRealTime(), max_sleep);
+  if (dt>0) {
+    std::this_thread::sleep_for(std::chrono::duration<Real>(dt));
+  }
+}
+
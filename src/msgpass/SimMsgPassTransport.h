@@ -0,0 +1,72 @@
+#ifndef MSG_PASS_SIM_MSG_PASS_TRANSPORT_H
+#define MSG_PASS_SIM_MSG_PASS_TRANSPORT_H
+
+#include "msgpass/IMsgPassTransport.h"
+
+#include <arcane/utils/UniqueArray.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class SimMsgPassTransport                                                */
+/* \brief Transport emulating a network with a given latency and bandwidth   */
+/*   on top of another transport                                             */
+/*                                                                           */
+/* Used with the shared memory implementation of Arcane (ranks are threads   */
+/* of the same process), it allows to study the overlap strategies without  */
+/* MPI nor network. A sending of n bytes to a rank is only posted to the     */
+/* inner transport at max(now, end of the previous sending to this rank)     */
+/* + latency + n/bandwidth, the messages to the same rank are serialized.    */
+/* The caller keeps on working meanwhile : the held sendings are posted      */
+/* while waiting for the requests.                                           */
+/*---------------------------------------------------------------------------*/
+class SimMsgPassTransport : public IMsgPassTransport {
+ public:
+  /*!
+   * \brief inner : transport doing the actual exchanges (not owned)
+   * latency in seconds, bandwidth in bytes/s (<=0 : infinite)
+   */
+  SimMsgPassTransport(IMsgPassTransport* inner, Real latency, Real bandwidth);
+  virtual ~SimMsgPassTransport();
+
+  //! Post a non-blocking receipt of buf from rank
+  void postRecv(Integer ireq, ArrayView<Byte> buf, Int32 rank) override;
+
+  //! Hold the sending of buf to rank until its simulated arrival time
+  void postSend(Integer ireq, ArrayView<Byte> buf, Int32 rank) override;
+
+  //! Wait for at least one pending request, fill done_ireqs and return the number of them
+  Integer waitSome(ArrayView<Integer> done_ireqs) override;
+
+  //! Same as waitSome but return 0 if no request is completed
+  Integer testSome(ArrayView<Integer> done_ireqs) override;
+
+  //! Wait for all the pending requests
+  void waitAll() override;
+
+  //! Number of pending requests (held sendings included)
+  Integer nbPending() const override;
+
+ protected:
+  //! Post to the inner transport the held sendings whose time has come
+  void _postDueSendings();
+
+  //! Sleep until the next held sending (at most max_sleep seconds)
+  void _sleepUntilNextSending(Real max_sleep);
+
+ protected:
+  struct HeldSending {
+    Integer m_ireq;
+    ArrayView<Byte> m_buf;
+    Int32 m_rank;
+    Real m_release_time;
+  };
+
+  IMsgPassTransport* m_inner=nullptr;
+  Real m_latency=0;
+  Real m_bandwidth=0;
+
+  UniqueArray<HeldSending> m_held;  //! Sendings not yet posted to m_inner
+  UniqueArray<Int32> m_link_ranks;  //! Destination ranks ...
+  UniqueArray<Real> m_link_free_time;  //! ... and time when their link is free again
+};
+
+#endif
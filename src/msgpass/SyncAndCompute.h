@@ -107,16 +107,9 @@ syncAndComputeOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
 {
   PROF_ACC_BEGIN(__FUNCTION__);
 
-  // Les seuls groupes supportés sont "own" ou "all"
-  typename SyncItems<ItemType>::eGroupCategory group_category;
-  if (item_group == get_own_items<ItemType>(m_mesh)) {
-    group_category = SyncItems<ItemType>::GC_own;
-  } else if (item_group == get_all_items<ItemType>(m_mesh)) {
-    group_category = SyncItems<ItemType>::GC_all;
-  } else {
-    throw NotSupportedException(A_FUNCINFO, 
-	String("Les seuls groupes supportés sont \"own\" ou \"all\""));
-  }
+  // Tout groupe est supporté, il est découpé en items private et items de bord
+  // par intersection avec les SyncItems (découpage mis en cache par groupe)
+  SyncItems<ItemType>* sync_items = this->getSyncItems<ItemType>();
 
   // Pour qu'une queue attende des événements avant de commencer
   auto depends_on = [](Ref<RunQueue> rqueue, ArrayView<Ref<ax::RunQueueEvent>>& levts) {
@@ -128,11 +121,21 @@ syncAndComputeOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
   if (vs_version == VS_auto) {
     vs_version = defaultVarSyncVersion();
   }
+
+  if (vs_version == VS_autotune) {
+    // La version est choisie après chronométrage des versions candidates
+    VarSyncTuner::Trial trial = m_vsync_tuner->beginTrial(vars.varsList(), VarSyncTuner::OK_sync_and_compute);
+    syncAndComputeOnEvents<ItemType, Func>(depends_on_evts, vars, item_group, func, trial.m_version);
+    m_vsync_tuner->endTrial(trial);
+    PROF_ACC_END;
+    return;
+  }
   
   ITraceMng* tm = m_mesh->traceMng();
   if (vs_version == VS_bulksync_std ||
       vs_version == VS_bulksync_evqueue ||
-      vs_version == VS_bulksync_evqueue_d) 
+      vs_version == VS_bulksync_evqueue_d ||
+      vs_version == VS_bulksync_neighcoll) 
   {
     auto ref_queue = AcceleratorUtils::refQueueAsync(m_runner, QP_default); 
 
@@ -147,15 +150,14 @@ syncAndComputeOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
     ref_queue->barrier(); // on attend la fin du calcul sur tous les items demandés
   } 
   else if (vs_version == VS_overlap_evqueue ||
-      vs_version == VS_overlap_evqueue_d) 
+      vs_version == VS_overlap_evqueue_d ||
+      vs_version == VS_overlap_neighcoll) 
   {
-    SyncItems<ItemType>* sync_items = this->getSyncItems<ItemType>();
-
     // On amorce sur le DEVICE le calcul des items intérieurs dont ne dépendent
     // pas les comms sur la queue ref_queue_inr (_inr = inner)
     Ref<RunQueue> ref_queue_inr = AcceleratorUtils::refQueueAsync(m_runner, QP_default);
     depends_on(ref_queue_inr, depends_on_evts);
-    func(sync_items->privateItems(), ref_queue_inr.get());
+    func(sync_items->privateItems(item_group), ref_queue_inr.get());
     // ici, le calcul sur ref_queue_inr n'est pas terminé sur le DEVICE
 
     // Sur la queue de bord m_ref_queue_bnd, on amorce le packing des données
@@ -166,12 +168,36 @@ syncAndComputeOnEvents(ArrayView<Ref<ax::RunQueueEvent>> depends_on_evts,
 
     // Puis on amorce sur le DEVICE le calcul sur les items dont dépendent
     // les comms sur la queue m_ref_queue_bnd (_bnd = boundary)
-    func(sync_items->boundaryItems(group_category), m_ref_queue_bnd.get());
+    func(sync_items->boundaryItems(item_group), m_ref_queue_bnd.get());
     m_ref_queue_bnd->barrier();
 
     // On attend la terminaison des calculs intérieurs
     ref_queue_inr->barrier();
   } 
+  else if (vs_version == VS_overlap_host) 
+  {
+    // Sans accélérateur, les queues sont synchrones : le recouvrement est
+    // obtenu en calculant les items intérieurs sur un thread dédié
+    // (boucles multi-threadées si les tâches sont actives)
+    Ref<RunQueue> ref_queue_inr = AcceleratorUtils::refQueueAsync(m_runner, QP_default);
+    depends_on(ref_queue_inr, depends_on_evts);
+    auto private_items = sync_items->privateItems(item_group);
+    // La tâche attend sa fin même si le thread appelant lève une exception
+    HostWorkerTask host_task(_hostWorker(), [&]() {
+      func(private_items, ref_queue_inr.get());
+      ref_queue_inr->barrier();
+    });
+
+    // Pendant ce temps, le thread appelant effectue pack/send/recv/unpack
+    // (seul thread à faire des comms) puis calcule les items de bord
+    depends_on(m_ref_queue_bnd, depends_on_evts);
+    this->synchronize(vars, m_ref_queue_bnd, vs_version);
+    func(sync_items->boundaryItems(item_group), m_ref_queue_bnd.get());
+    m_ref_queue_bnd->barrier();
+
+    // On attend la terminaison des calculs intérieurs
+    host_task.wait();
+  } 
   else if (vs_version == VS_overlap_iqueue) 
   {
     tm->debug() << "overlap_iqueue";
@@ -3,6 +3,8 @@
 #include <arcane/utils/IMemoryRessourceMng.h>
 #include <arcane/utils/IndexOutOfRangeException.h>
 
+#include <algorithm>
+
 /*---------------------------------------------------------------------------*/
 /* MultiBufView                                                              */
 /*---------------------------------------------------------------------------*/
@@ -184,13 +186,20 @@ SyncBuffers::SyncBuffers(bool is_acc_avl) :
 {
   for(Integer imem(0) ; imem<2 ; ++imem) {
     m_buf_mem[imem].m_buf=nullptr;
-    m_buf_mem[imem].m_first_av_pos=0;
   }
 }
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 SyncBuffers::~SyncBuffers() {
+  for(auto sub_buf : m_live_sub_bufs) {
+    if (sub_buf->m_overflow) {
+      delete sub_buf->m_overflow[0].m_buf;
+      delete sub_buf->m_overflow[1].m_buf;
+      delete[] sub_buf->m_overflow;
+    }
+    delete sub_buf;
+  }
   for(Integer imem(0) ; imem<2 ; ++imem) {
     delete m_buf_mem[imem].m_buf;
   }
@@ -217,66 +226,217 @@ Int64 SyncBuffers::estimatedMaxBufSz(IntegerConstArrayView item_sizes,
 }
 
 /*---------------------------------------------------------------------------*/
+/* Plus petite classe de taille >= buf_sz : entre 2^k et 2^(k+1), les classes */
+/* sont espacées de 2^k/4, ce qui limite la place perdue à 25%               */
 /*---------------------------------------------------------------------------*/
-void SyncBuffers::resetBuf() {
-  m_buf_estim_sz = 0;
-  for(Integer imem(0) ; imem<2 ; ++imem) {
-    m_buf_mem[imem].m_first_av_pos=0;
+Int64 SyncBuffers::sizeClass(Int64 buf_sz) {
+  const Int64 min_class = 64*1024;
+  if (buf_sz<=min_class) {
+    return min_class;
+  }
+  Int64 p2 = min_class;
+  while (2*p2<=buf_sz) {
+    p2 *= 2;
   }
+  Int64 step = p2/4;
+  return ((buf_sz+step-1)/step)*step;
 }
 
 /*---------------------------------------------------------------------------*/
-/* Ajout à partir du nb d'items par voisin                                   */
+/* Reallocation dans la mémoire hôte */
 /*---------------------------------------------------------------------------*/
-template<typename DataType>
-void SyncBuffers::addEstimatedMaxSz(IntegerConstArrayView item_sizes,
-    Integer degree) {
-  m_buf_estim_sz += estimatedMaxBufSz<DataType>(item_sizes, degree);
+void SyncBuffers::BufMem::reallocOnHost(Int64 wanted_size, bool is_acc_avl) {
+  // On libère d'abord l'ancien buffer pour ne pas cumuler les deux allocations
+  delete m_buf;
+  eMemoryRessource mem_res = (is_acc_avl ? eMemoryRessource::HostPinned : eMemoryRessource::Host);
+  IMemoryAllocator* allocator = platform::getDataMemoryRessourceMng()->getAllocator(mem_res);
+  m_buf = new UniqueArray<Byte>(allocator, wanted_size);
 }
 
 /*---------------------------------------------------------------------------*/
-/* Reallocation dans la mémoire hôte */
+/* Reallocation dans la mémoire device */
+/*---------------------------------------------------------------------------*/
+void SyncBuffers::BufMem::reallocOnDevice(Int64 wanted_size) {
+  delete m_buf;
+  IMemoryAllocator* allocator = 
+    platform::getDataMemoryRessourceMng()->getAllocator(eMemoryRessource::Device);
+  m_buf = new UniqueArray<Byte>(allocator, wanted_size);
+}
+
+/*---------------------------------------------------------------------------*/
+/* (Ré)alloue les buffers hôte et device de buf_mem[2] à la taille buf_sz    */
+/*---------------------------------------------------------------------------*/
+void SyncBuffers::_allocBufMem(BufMem* buf_mem, Int64 buf_sz) {
+  // D'abord l'hote
+  buf_mem[0].reallocOnHost(buf_sz, m_is_accelerator_available);
+
+  // Puis le device si celui-ci existe
+  if (m_is_accelerator_available) {
+    buf_mem[1].reallocOnDevice(buf_sz);
+  } else {
+    // Pour débugger, le buffer "device" se trouve dans la mémoire hôte
+    buf_mem[1].reallocOnHost(buf_sz, m_is_accelerator_available);
+  }
+}
+
 /*---------------------------------------------------------------------------*/
-void SyncBuffers::BufMem::reallocIfNeededOnHost(Int64 wanted_size, bool is_acc_avl) {
-  if (m_buf==nullptr) {
-    eMemoryRessource mem_res = (is_acc_avl ? eMemoryRessource::HostPinned : eMemoryRessource::Host);
-    IMemoryAllocator* allocator = platform::getDataMemoryRessourceMng()->getAllocator(mem_res);
-    m_buf = new UniqueArray<Byte>(allocator, wanted_size);
+/* Adapte la capacité de l'arène alors qu'aucune sous-allocation de l'arène  */
+/* n'est en cours (les adresses peuvent donc changer)                        */
+/*---------------------------------------------------------------------------*/
+void SyncBuffers::_adaptCapacity(Int64 buf_sz) {
+  // Demande de la période écoulée (synchros concurrentes comprises) et de la synchro courante
+  Int64 demand = std::max(m_epoch_demand, buf_sz);
+  m_epoch_demand = buf_sz;
+
+  Int64 new_capacity = m_capacity;
+  if (demand>m_capacity) {
+    // Croissance jusqu'à la classe de la plus forte demande
+    new_capacity = sizeClass(demand);
+    m_nb_calls_below = 0;
+    m_below_demand = 0;
+  } else if (m_shrink_after>0) {
+    if (sizeClass(demand)<m_capacity) {
+      // Appel sous la marque, on réduit après m_shrink_after appels consécutifs
+      m_below_demand = std::max(m_below_demand, demand);
+      if (++m_nb_calls_below>=m_shrink_after) {
+        new_capacity = sizeClass(m_below_demand);
+        m_nb_calls_below = 0;
+        m_below_demand = 0;
+      }
+    } else {
+      m_nb_calls_below = 0;
+      m_below_demand = 0;
+    }
+  }
+
+  if (new_capacity!=m_capacity) {
+    _allocBufMem(m_buf_mem, new_capacity);
+    m_capacity = new_capacity;
+    // Les vues construites sur les anciens buffers ne sont plus valides
+    m_alloc_generation++;
   }
-  m_buf->resize(wanted_size);
 }
 
 /*---------------------------------------------------------------------------*/
-/* Reallocation dans la mémoire device */
+/* Première position (alignée) de l'arène où buf_sz octets sont libres       */
+/*---------------------------------------------------------------------------*/
+Int64 SyncBuffers::_findFreeOffset(Int64 buf_sz) const {
+  // Les sous-allocations de l'arène triées par position
+  UniqueArray<SubBuf*> in_arena;
+  for(auto sub_buf : m_live_sub_bufs) {
+    if (!sub_buf->m_overflow) {
+      in_arena.add(sub_buf);
+    }
+  }
+  std::sort(in_arena.begin(), in_arena.end(),
+      [](SubBuf* a, SubBuf* b) { return a->m_offset<b->m_offset; });
+
+  Int64 offset = 0;
+  for(auto sub_buf : in_arena) {
+    if (offset+buf_sz<=sub_buf->m_offset) {
+      return offset;
+    }
+    offset = std::max(offset, _alignedSize(sub_buf->m_offset+sub_buf->m_size));
+  }
+  return (offset+buf_sz<=m_capacity ? offset : -1);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Grossit l'arène (si elle est libre) pour contenir au moins buf_sz octets  */
 /*---------------------------------------------------------------------------*/
-void SyncBuffers::BufMem::reallocIfNeededOnDevice(Int64 wanted_size) {
-  if (m_buf==nullptr) {
-    IMemoryAllocator* allocator = 
-      platform::getDataMemoryRessourceMng()->getAllocator(eMemoryRessource::Device);
-    m_buf = new UniqueArray<Byte>(allocator, wanted_size);
+void SyncBuffers::reserve(Int64 buf_sz) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_live_sub_bufs.empty() && buf_sz>m_capacity) {
+    _allocBufMem(m_buf_mem, sizeClass(buf_sz));
+    m_capacity = sizeClass(buf_sz);
+    m_alloc_generation++;
   }
-  m_buf->resize(wanted_size);
 }
 
 /*---------------------------------------------------------------------------*/
+/* Réserve une sous-allocation de buf_sz octets jusqu'à release()            */
 /*---------------------------------------------------------------------------*/
-void SyncBuffers::allocIfNeeded(Int64 buf_estim_sz) {
-  m_buf_estim_sz = buf_estim_sz;
-  // D'abord l'hote
-  m_buf_mem[0].reallocIfNeededOnHost(buf_estim_sz, m_is_accelerator_available);
+SyncBuffers::SubBuf* SyncBuffers::acquire(Int64 buf_sz) {
+  std::lock_guard<std::mutex> lock(m_mutex);
 
-  // Puis le device si celui-ci existe
-  if (m_is_accelerator_available) {
-    m_buf_mem[1].reallocIfNeededOnDevice(buf_estim_sz);
+  SubBuf* sub_buf = new SubBuf;
+  sub_buf->m_size = _alignedSize(std::max<Int64>(buf_sz, 0));
+
+  // Demande totale : la nouvelle synchro et celles qui sont en cours
+  bool arena_in_use = false;
+  Int64 demand = sub_buf->m_size;
+  for(auto live : m_live_sub_bufs) {
+    demand += live->m_size;
+    arena_in_use = arena_in_use || !live->m_overflow;
   }
-  if (!m_is_accelerator_available) {
-    // Pour débugger, le buffer "device" se trouve dans la mémoire hôte
-    m_buf_mem[1].reallocIfNeededOnHost(buf_estim_sz, m_is_accelerator_available);
+  m_high_water_mark = std::max(m_high_water_mark, demand);
+  m_epoch_demand = std::max(m_epoch_demand, demand);
+
+  if (!arena_in_use) {
+    // L'arène peut être réallouée, c'est le seul moment où elle change de taille
+    _adaptCapacity(sub_buf->m_size);
+  }
+
+  Int64 offset = _findFreeOffset(sub_buf->m_size);
+  if (offset>=0) {
+    sub_buf->m_offset = offset;
+    sub_buf->m_generation = m_alloc_generation;
+  } else {
+    // Arène pleine à cause des synchros concurrentes : buffers propres,
+    // la prochaine croissance de l'arène tiendra compte de cette demande
+    sub_buf->m_overflow = new BufMem[2];
+    _allocBufMem(sub_buf->m_overflow, sub_buf->m_size);
+    m_nb_overflow++;
+  }
+  m_live_sub_bufs.add(sub_buf);
+  return sub_buf;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Rend une sous-allocation obtenue par acquire()                            */
+/*---------------------------------------------------------------------------*/
+void SyncBuffers::release(SubBuf* sub_buf) {
+  if (!sub_buf) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(Integer i=0 ; i<m_live_sub_bufs.size() ; ++i) {
+    if (m_live_sub_bufs[i]==sub_buf) {
+      m_live_sub_bufs.remove(i);
+      break;
+    }
   }
+  if (sub_buf->m_overflow) {
+    delete sub_buf->m_overflow[0].m_buf;
+    delete sub_buf->m_overflow[1].m_buf;
+    delete[] sub_buf->m_overflow;
+  }
+  delete sub_buf;
 }
 
-void SyncBuffers::allocIfNeeded() {
-  allocIfNeeded(m_buf_estim_sz);
+/*---------------------------------------------------------------------------*/
+/* Partie encore disponible de la sous-allocation dans la mémoire imem       */
+/*---------------------------------------------------------------------------*/
+Span<Byte> SyncBuffers::_availableSpan(SubBuf* sub_buf, Integer imem) {
+  UniqueArray<Byte>* buf = (sub_buf->m_overflow ? 
+      sub_buf->m_overflow[imem].m_buf : m_buf_mem[imem].m_buf);
+  if (!buf) {
+    return Span<Byte>(); // rien n'a encore été alloué (sous-allocation vide)
+  }
+  Int64 first_av_pos = sub_buf->m_first_av_pos[imem];
+  return Span<Byte>(buf->data()+sub_buf->m_offset+first_av_pos, 
+      sub_buf->m_size-first_av_pos);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Avance la première position disponible de la sous-allocation après range  */
+/*---------------------------------------------------------------------------*/
+void SyncBuffers::_consume(SubBuf* sub_buf, Integer imem, Span<Byte> range) {
+  if (range.data()) {
+    Span<Byte> av_span = _availableSpan(sub_buf, imem);
+    Byte* end_ptr = range.data()+range.size();
+    sub_buf->m_first_av_pos[imem] += (end_ptr - av_span.data());
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -347,19 +507,12 @@ MultiBufView SyncBuffers::_multiBufView(
 /* */
 /*---------------------------------------------------------------------------*/
 template<typename DataType>
-MultiBufView SyncBuffers::multiBufView(
+MultiBufView SyncBuffers::multiBufView(SubBuf* sub_buf,
     IntegerConstArrayView item_sizes, Integer degree, Integer imem) {
 
-  auto& buf_mem = m_buf_mem[imem];
-  Byte* new_ptr = buf_mem.m_buf->data()+buf_mem.m_first_av_pos;
-  Int64 av_space = buf_mem.m_buf->size()-buf_mem.m_first_av_pos;
-  Span<Byte> buf_bytes(new_ptr, av_space);
-
-  auto mb = _multiBufView<DataType>(item_sizes, degree, buf_bytes);
+  auto mb = _multiBufView<DataType>(item_sizes, degree, _availableSpan(sub_buf, imem));
 
-  auto rg{mb.rangeSpan()}; // Encapsule [beg_ptr, end_ptr[
-  Byte* end_ptr = rg.data()+rg.size();
-  buf_mem.m_first_av_pos = (end_ptr - buf_mem.m_buf->data());
+  _consume(sub_buf, imem, mb.rangeSpan()); // rangeSpan encapsule [beg_ptr, end_ptr[
   return mb;
 }
 
@@ -429,20 +582,13 @@ MultiBufView2 SyncBuffers::_multiBufViewVars(ConstArrayView<IMeshVarSync*> vars,
 /*---------------------------------------------------------------------------*/
 /* */
 /*---------------------------------------------------------------------------*/
-MultiBufView2 SyncBuffers::multiBufViewVars(
+MultiBufView2 SyncBuffers::multiBufViewVars(SubBuf* sub_buf,
     ConstArrayView<IMeshVarSync*> vars,
     IntegerConstArrayView item_sizes, Integer imem) {
 
-  auto& buf_mem = m_buf_mem[imem];
-  Byte* new_ptr = buf_mem.m_buf->data()+buf_mem.m_first_av_pos;
-  Int64 av_space = buf_mem.m_buf->size()-buf_mem.m_first_av_pos;
-  Span<Byte> buf_bytes(new_ptr, av_space);
+  auto mb2 = _multiBufViewVars(vars, item_sizes, _availableSpan(sub_buf, imem));
 
-  auto mb2 = _multiBufViewVars(vars, item_sizes, buf_bytes);
-
-  auto rg{mb2.rangeSpan()}; // Encapsule [beg_ptr, end_ptr[
-  Byte* end_ptr = rg.data()+rg.size();
-  buf_mem.m_first_av_pos = (end_ptr - buf_mem.m_buf->data());
+  _consume(sub_buf, imem, mb2.rangeSpan()); // rangeSpan encapsule [beg_ptr, end_ptr[
   return mb2;
 }
 
@@ -515,20 +661,13 @@ MultiBufView2 SyncBuffers::_multiBufViewVars(ConstArrayView<IMeshVarSync*> vars,
 /*---------------------------------------------------------------------------*/
 /* */
 /*---------------------------------------------------------------------------*/
-MultiBufView2 SyncBuffers::multiBufViewVars(
+MultiBufView2 SyncBuffers::multiBufViewVars(SubBuf* sub_buf,
     ConstArrayView<IMeshVarSync*> vars,
     Integer nb_nei, IMeshVarSync::eItemSync item_sync, Integer imem) {
 
-  auto& buf_mem = m_buf_mem[imem];
-  Byte* new_ptr = buf_mem.m_buf->data()+buf_mem.m_first_av_pos;
-  Int64 av_space = buf_mem.m_buf->size()-buf_mem.m_first_av_pos;
-  Span<Byte> buf_bytes(new_ptr, av_space);
-
-  auto mb2 = _multiBufViewVars(vars, nb_nei, item_sync, buf_bytes);
+  auto mb2 = _multiBufViewVars(vars, nb_nei, item_sync, _availableSpan(sub_buf, imem));
 
-  auto rg{mb2.rangeSpan()}; // Encapsule [beg_ptr, end_ptr[
-  Byte* end_ptr = rg.data()+rg.size();
-  buf_mem.m_first_av_pos = (end_ptr - buf_mem.m_buf->data());
+  _consume(sub_buf, imem, mb2.rangeSpan()); // rangeSpan encapsule [beg_ptr, end_ptr[
   return mb2;
 }
 
@@ -540,8 +679,7 @@ MultiBufView2 SyncBuffers::multiBufViewVars(
 #define INST_SYNC_BUFFERS(__DataType__) \
   template ArrayView<__DataType__> MultiBufView::valBuf<__DataType__>(ArrayView<Byte> buf); \
   template Array2View<__DataType__> MultiBufView::valBuf2<__DataType__>(ArrayView<Byte> buf, Integer dim2_size); \
-  template MultiBufView SyncBuffers::multiBufView<__DataType__>(IntegerConstArrayView item_sizes, Integer degree, Integer imem); \
-  template void SyncBuffers::addEstimatedMaxSz<__DataType__>(IntegerConstArrayView item_sizes, Integer degree); \
+  template MultiBufView SyncBuffers::multiBufView<__DataType__>(SyncBuffers::SubBuf* sub_buf, IntegerConstArrayView item_sizes, Integer degree, Integer imem); \
   template Int64 SyncBuffers::estimatedMaxBufSz<__DataType__>(IntegerConstArrayView item_sizes, Integer degree)
 
 INST_SYNC_BUFFERS(Integer);
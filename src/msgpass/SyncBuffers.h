@@ -6,6 +6,8 @@
 
 #include <arcane/utils/MultiArray2.h>
 
+#include <mutex>
+
 using namespace Arcane;
 
 /*---------------------------------------------------------------------------*/
@@ -65,22 +67,72 @@ class MultiBufView2 {
 };
 
 /*---------------------------------------------------------------------------*/
+/* Arène des buffers de communication sur l'hôte et le device                */
+/*                                                                           */
+/* La capacité de l'arène suit, par classes de taille, la plus forte demande */
+/* constatée (high-water mark) : elle ne grandit qu'en dehors de toute       */
+/* synchronisation en cours et peut décroître après N appels sous la marque. */
+/* Chaque synchronisation obtient une sous-allocation (SubBuf) disjointe des */
+/* autres, ce qui permet à des synchronisations concurrentes sur des queues  */
+/* différentes de partager la même arène.                                    */
 /*---------------------------------------------------------------------------*/
 class SyncBuffers {
+ protected:
+  struct BufMem {
+    UniqueArray<Byte> *m_buf=nullptr;
+    void reallocOnHost(Int64 wanted_size, bool is_acc_avl);
+    void reallocOnDevice(Int64 wanted_size);
+  };
+
+ public:
+  /*!
+   * \brief Sub-allocation of the arena reserved to one synchronization
+   *
+   * Same offset and size in the host and device memories. When the arena
+   * is full because of concurrent synchronizations, the sub-allocation
+   * gets its own buffers (overflow) which are freed by release().
+   */
+  struct SubBuf {
+    Int64 m_offset=0;  //! Position in the arena
+    Int64 m_size=0;  //! Size in bytes
+    Int64 m_generation=-1;  //! Arena allocation holding the sub-allocation (-1 : overflow)
+    Int64 m_first_av_pos[2]={0,0};  //! First available position from m_offset, per memory
+    BufMem* m_overflow=nullptr;  //! Own host/device buffers if the arena was full
+  };
+
  public:
   SyncBuffers(bool is_acc_avl);
   virtual ~SyncBuffers();
 
-  //
-  void resetBuf();
+  //! Grow the arena (if no synchronization is running) to hold at least buf_sz bytes
+  void reserve(Int64 buf_sz);
 
-  // Ajout à partir du nb d'items par voisin
-  template<typename DataType>
-  void addEstimatedMaxSz(IntegerConstArrayView item_sizes, Integer degree);
+  //! Reserve a sub-allocation of buf_sz bytes (host and device) until release()
+  SubBuf* acquire(Int64 buf_sz);
+
+  //! Give back a sub-allocation obtained by acquire()
+  void release(SubBuf* sub_buf);
+
+  /*!
+   * \brief Shrink the arena after nb_calls synchronizations whose demand stays
+   * in a lower size class than the current capacity (0 : never shrink)
+   */
+  void setShrinkPolicy(Integer nb_calls) { m_shrink_after = nb_calls; }
+
+  //! Incremented each time the arena is reallocated (the addresses change)
+  Int64 allocGeneration() const { return m_alloc_generation; }
 
-  // 
-  void allocIfNeeded(Int64 buf_estim_sz);
-  void allocIfNeeded();
+  //! Current size in bytes of the arena
+  Int64 capacity() const { return m_capacity; }
+
+  //! Highest demand in bytes (concurrent synchronizations included) since the beginning
+  Int64 highWaterMark() const { return m_high_water_mark; }
+
+  //! Number of sub-allocations which did not fit in the arena
+  Int64 nbOverflow() const { return m_nb_overflow; }
+
+  //! Size class (multiple of a quarter of a power of 2) able to hold buf_sz bytes
+  static Int64 sizeClass(Int64 buf_sz);
 
   /*!
    * \brief A partir des nb d'items à communiquer, estime une borne sup de la taille du buffer en octets
@@ -89,23 +141,23 @@ class SyncBuffers {
   static Int64 estimatedMaxBufSz(IntegerConstArrayView item_sizes, Integer degree);
 
   /*!
-   * \brief A partir de la vue sur m_buf_bytes, construit une vue par voisin des buffers
+   * \brief A partir de la vue sur la sous-allocation, construit une vue par voisin des buffers
    */
   template<typename DataType>
-  MultiBufView multiBufView(
+  MultiBufView multiBufView(SubBuf* sub_buf,
     IntegerConstArrayView item_sizes, Integer degree, Integer imem);
 
   /*!
    * \brief Construit des vues par voisin et par variable
    */
-  MultiBufView2 multiBufViewVars(
+  MultiBufView2 multiBufViewVars(SubBuf* sub_buf,
     ConstArrayView<IMeshVarSync*> vars,
     IntegerConstArrayView item_sizes, Integer imem);
 
   /*!
-   * \brief TODO : à commenter
+   * \brief Construit des vues par voisin et par variable sur les items item_sync
    */
-  MultiBufView2 multiBufViewVars(
+  MultiBufView2 multiBufViewVars(SubBuf* sub_buf,
     ConstArrayView<IMeshVarSync*> vars,
     Integer nb_nei, IMeshVarSync::eItemSync item_sync, Integer imem);
 
@@ -132,18 +184,43 @@ class SyncBuffers {
     Integer nb_nei, IMeshVarSync::eItemSync item_sync,
     Span<Byte> buf_bytes);
 
- protected:
-  struct BufMem {
-    UniqueArray<Byte> *m_buf=nullptr;
-    Int64 m_first_av_pos=0;  //! Première position disponible
-    void reallocIfNeededOnHost(Int64 wanted_size, bool is_acc_avl);
-    void reallocIfNeededOnDevice(Int64 wanted_size);
-  };
+  //! Taille arrondie pour que les sous-allocations restent alignées
+  static Int64 _alignedSize(Int64 sz) { return ((sz+255)/256)*256; }
+
+  //! Partie encore disponible de la sous-allocation dans la mémoire imem
+  Span<Byte> _availableSpan(SubBuf* sub_buf, Integer imem);
+
+  //! Avance la première position disponible de la sous-allocation après range
+  void _consume(SubBuf* sub_buf, Integer imem, Span<Byte> range);
+
+  //! (Ré)alloue les buffers hôte et device de buf_mem[2] à la taille buf_sz
+  void _allocBufMem(BufMem* buf_mem, Int64 buf_sz);
+
+  //! Adapte la capacité de l'arène (aucune sous-allocation de l'arène en cours)
+  void _adaptCapacity(Int64 buf_sz);
+
+  //! Position libre de buf_sz octets dans l'arène, -1 si aucune
+  Int64 _findFreeOffset(Int64 buf_sz) const;
+
  protected:
   bool m_is_accelerator_available=false;  //! Vrai si un GPU est disponible pour les calculs
-  Int64 m_buf_estim_sz=0;  //! Taille qui va servir à allouer
+  Int64 m_alloc_generation=0;  //! Incrémenté à chaque fois que les adresses des buffers changent
   // Pour gérer les buffers sur l'hote et le device
   BufMem m_buf_mem[2];
+  Int64 m_capacity=0;  //! Taille de l'arène (une classe de taille)
+
+  std::mutex m_mutex;  //! Protège les (dé)allocations demandées par des synchros concurrentes
+  UniqueArray<SubBuf*> m_live_sub_bufs;  //! Sous-allocations en cours
+
+  // Suivi de la demande
+  Int64 m_high_water_mark=0;  //! Plus forte demande depuis le début
+  Int64 m_epoch_demand=0;  //! Plus forte demande depuis la dernière fois où l'arène était libre
+  Int64 m_nb_overflow=0;
+
+  // Politique de réduction de l'arène
+  Integer m_shrink_after=0;  //! Nb d'appels sous la marque avant réduction (0 : jamais)
+  Integer m_nb_calls_below=0;  //! Nb d'appels consécutifs sous la marque
+  Int64 m_below_demand=0;  //! Plus forte demande de ces appels
 };
 
 #endif
@@ -1,5 +1,10 @@
 #include "msgpass/SyncEnvIndexes.h"
 
+#include <arcane/IItemFamily.h>
+#include <arcane/IVariableSynchronizer.h>
+#include <arcane/ItemGroupImpl.h>
+#include <arcane/materials/CellToAllEnvCellConverter.h>
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 SyncEnvIndexes::SyncEnvIndexes(MatVarSpace mvs, IMeshMaterialMng* mm,
@@ -18,23 +23,7 @@ SyncEnvIndexes::SyncEnvIndexes(MatVarSpace mvs, IMeshMaterialMng* mm,
   
   m_buf_ghost_evi        (platform::getAcceleratorHostMemoryAllocator()),
   m_indexes_ghost_evi_pn (platform::getAcceleratorHostMemoryAllocator()),
-  m_nb_ghost_evi_pn      (platform::getAcceleratorHostMemoryAllocator()),
-
-  m_buf_all_evi_4env     (platform::getAcceleratorHostMemoryAllocator()),
-  m_indexes_all_evi_penv (platform::getAcceleratorHostMemoryAllocator()),
-  m_nb_all_evi_penv      (platform::getAcceleratorHostMemoryAllocator()),
-
-  m_buf_owned_evi_4env     (platform::getAcceleratorHostMemoryAllocator()),
-  m_indexes_owned_evi_penv (platform::getAcceleratorHostMemoryAllocator()),
-  m_nb_owned_evi_penv      (platform::getAcceleratorHostMemoryAllocator()),
-
-  m_buf_private_evi_4env     (platform::getAcceleratorHostMemoryAllocator()),
-  m_indexes_private_evi_penv (platform::getAcceleratorHostMemoryAllocator()),
-  m_nb_private_evi_penv      (platform::getAcceleratorHostMemoryAllocator()),
-
-  m_buf_shared_evi_4env     (platform::getAcceleratorHostMemoryAllocator()),
-  m_indexes_shared_evi_penv (platform::getAcceleratorHostMemoryAllocator()),
-  m_nb_shared_evi_penv      (platform::getAcceleratorHostMemoryAllocator())
+  m_nb_ghost_evi_pn      (platform::getAcceleratorHostMemoryAllocator())
 
 {
   if (!m_mesh_material_mng) {
@@ -52,13 +41,156 @@ SyncEnvIndexes::SyncEnvIndexes(MatVarSpace mvs, IMeshMaterialMng* mm,
 }
 
 /*---------------------------------------------------------------------------*/
-/* Recalcule les listes de EnvIndex "owned" ("shared") et "ghost"            */
+/* Liste d'EnvVarIndex(es) par environnement, un segment par environnement   */
+/*---------------------------------------------------------------------------*/
+SyncEnvIndexes::EviPenvList::EviPenvList() :
+  m_buf     (platform::getAcceleratorHostMemoryAllocator()),
+  m_indexes (platform::getAcceleratorHostMemoryAllocator()),
+  m_nb      (platform::getAcceleratorHostMemoryAllocator())
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/* Met à jour les listes de EnvIndex "owned" ("shared") et "ghost" ainsi     */
+/* que les listes par environnement                                          */
+/*                                                                           */
+/* Seuls les environnements modifiés depuis le dernier appel (mailles        */
+/* ajoutées/retirées ou passage pur/mixte de certaines de leurs mailles)     */
+/* sont retraités : le coût est proportionnel aux mailles modifiées et à la  */
+/* taille des environnements concernés, pas à celle du maillage. On ne       */
+/* descend pas en dessous de l'environnement car Arcane renumérote les       */
+/* valueIndex de tout un environnement modifié.                              */
 /*---------------------------------------------------------------------------*/
 void SyncEnvIndexes::updateEnvIndexes() {
 
+  Integer nb_env = m_mesh_material_mng->environments().size();
+
+  // Détection des environnements dont le groupe de mailles a changé depuis le dernier appel
+  IntegerUniqueArray grp_changed_env_ids;
+  if (m_env_timestamps.size() != nb_env) {
+    m_env_timestamps.resize(nb_env);
+    m_env_timestamps.fill(-1);
+    m_env_cell_lids.resize(nb_env);
+  }
+  ENUMERATE_ENV(ienv, m_mesh_material_mng) {
+    IMeshEnvironment* env = *ienv;
+    Int64 timestamp = env->cells().internal()->timestamp();
+    if (timestamp != m_env_timestamps[env->id()]) {
+      m_env_timestamps[env->id()] = timestamp;
+      grp_changed_env_ids.add(env->id());
+    }
+  }
+  if (grp_changed_env_ids.empty()) {
+    // Rien n'a changé, les listes et les "conseils" mémoire sont toujours valides
+    return;
+  }
+
+  // Mailles ajoutées ou retirées de ces environnements, par différence avec
+  // les listes de mailles précédentes (marqueur par maille, pas de tri)
+  IItemFamily* cell_family = m_mesh_material_mng->mesh()->cellFamily();
+  if (m_cell_marker.size() != cell_family->maxLocalId()) {
+    m_cell_marker.resize(cell_family->maxLocalId());
+    m_cell_marker.fill(0);
+    m_marker_tag = 0;
+  }
+  Int32UniqueArray changed_cell_lids;
+  EnvironmentList envs = m_mesh_material_mng->environments();
+  for(Integer env_id : grp_changed_env_ids) {
+    Int32UniqueArray& prev_lids = m_env_cell_lids[env_id];
+    Int32ConstArrayView cur_lids = envs[env_id]->cells().view().localIds();
+
+    Integer old_tag = ++m_marker_tag;
+    Integer kept_tag = ++m_marker_tag;
+    for(Int32 lid : prev_lids) {
+      m_cell_marker[lid] = old_tag;
+    }
+    for(Int32 lid : cur_lids) {
+      if (m_cell_marker[lid] == old_tag) {
+        m_cell_marker[lid] = kept_tag;
+      } else {
+        changed_cell_lids.add(lid);  // ajoutée
+      }
+    }
+    for(Int32 lid : prev_lids) {
+      if (m_cell_marker[lid] == old_tag) {
+        changed_cell_lids.add(lid);  // retirée
+      }
+    }
+    prev_lids.copy(cur_lids);
+  }
+
+  // Une maille ajoutée ou retirée peut faire passer une maille d'un autre
+  // environnement de pure à mixte (ou l'inverse) et donc changer son
+  // EnvVarIndex : ces environnements sont aussi à retraiter
+  IntegerUniqueArray is_changed_env(nb_env, 0);
+  for(Integer env_id : grp_changed_env_ids) {
+    is_changed_env[env_id] = 1;
+  }
+  CellToAllEnvCellConverter allenvcell_converter(m_mesh_material_mng);
+  ENUMERATE_CELL(icell, cell_family->view(changed_cell_lids)) {
+    AllEnvCell allevc = allenvcell_converter[*icell];
+    ENUMERATE_CELL_ENVCELL(ievc, allevc) {
+      is_changed_env[(*ievc).environmentId()] = 1;
+    }
+  }
+  IntegerUniqueArray changed_env_ids;
+  for(Integer env_id=0 ; env_id<nb_env ; ++env_id) {
+    if (is_changed_env[env_id]) {
+      changed_env_ids.add(env_id);
+    }
+  }
+
   m_mmvs->checkRecompute();
-  // TODO : Il faudrait pouvoir récupérer si ça a été recalculé et faire la suite
-  // uniquement dans ce cas-là
+  _updateEviPn();
+
+  // Listes par environnement : un seul parcours des mailles de chaque
+  // environnement modifié, réparties selon le statut de la maille
+  // (0 : private, >0 : shared, <0 : ghost)
+  ConstArrayView<Integer> cell_status = m_sync_cells->itemStatus();
+
+  Integer nb_changed = changed_env_ids.size();
+  UniqueArray<UniqueArray<EnvVarIndex>> all_evis(nb_changed);
+  UniqueArray<UniqueArray<EnvVarIndex>> owned_evis(nb_changed);
+  UniqueArray<UniqueArray<EnvVarIndex>> private_evis(nb_changed);
+  UniqueArray<UniqueArray<EnvVarIndex>> shared_evis(nb_changed);
+
+  for(Integer ich=0 ; ich<nb_changed ; ++ich) {
+    IMeshEnvironment* env = envs[changed_env_ids[ich]];
+    all_evis[ich].reserve(env->cells().size());
+
+    ENUMERATE_ENVCELL(ievc, env) {
+      EnvCell evc = *ievc;
+      const MatVarIndex& mvi = evc._varIndex();
+      EnvVarIndex evi(mvi.arrayIndex(), mvi.valueIndex());
+      Integer status = cell_status[evc.globalCell().localId()];
+
+      all_evis[ich].add(evi);
+      if (status >= 0) {
+        owned_evis[ich].add(evi);
+        if (status == 0) {
+          private_evis[ich].add(evi);
+        } else {
+          shared_evis[ich].add(evi);
+        }
+      }
+    }
+  }
+
+  _patchEviPenv(changed_env_ids, all_evis    , m_all_evi_penv);
+  _patchEviPenv(changed_env_ids, owned_evis  , m_owned_evi_penv);
+  _patchEviPenv(changed_env_ids, private_evis, m_private_evi_penv);
+  _patchEviPenv(changed_env_ids, shared_evis , m_shared_evi_penv);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Recalcule les listes de EnvIndex "owned" ("shared") et "ghost" par voisin */
+/* (taille proportionnelle au bord du sous-domaine)                          */
+/*---------------------------------------------------------------------------*/
+void SyncEnvIndexes::_updateEviPn() {
+
+  const EnvVarIndex* prev_owned_ptr = m_buf_owned_evi.data();
+  const EnvVarIndex* prev_ghost_ptr = m_buf_ghost_evi.data();
+  bool first_call = (m_nb_owned_evi_pn.size() != m_nb_nei);
 
   // "shared" ou "owned" : les EnvIndex(es) intérieurs au sous-domaine et qui doivent être envoyés
   // "ghost" : les EnvIndex(es) fantômes pour lesquels on va recevoir des informations
@@ -103,97 +235,182 @@ void SyncEnvIndexes::updateEnvIndexes() {
     mvi2evi(m_mmvs->ghostItems(inei) , ghost_evi_pn[inei]);
   }
 
-  // Puisque les adresses ont potentiellement changé : 
-  // "Conseils" mémoire
-  if (m_acc_mem_adv) {
-    m_acc_mem_adv->setReadMostly(m_buf_owned_evi       .view());
+  // Pour les synchros sur une partie des couches fantômes
+  if (!_sortEviPnByLayer()) {
+    if (m_sync_cells->nbGhostLayer()>1) {
+      m_mesh_material_mng->traceMng()->warning() << "SyncEnvIndexes : listes multi-env non triables par couche,"
+        << " les synchros multi-env porteront sur toutes les couches fantômes";
+    }
+    m_nb_owned_evi_pnd.clear();
+    m_nb_ghost_evi_pnd.clear();
+  }
+
+  // "Conseils" mémoire uniquement si les adresses ont changé
+  if (m_acc_mem_adv && first_call) {
     m_acc_mem_adv->setReadMostly(m_indexes_owned_evi_pn.view());
     m_acc_mem_adv->setReadMostly(m_nb_owned_evi_pn     .view());
-    m_acc_mem_adv->setReadMostly(m_buf_ghost_evi       .view());
     m_acc_mem_adv->setReadMostly(m_indexes_ghost_evi_pn.view());
     m_acc_mem_adv->setReadMostly(m_nb_ghost_evi_pn     .view());
   }
+  if (m_acc_mem_adv && (first_call || m_buf_owned_evi.data() != prev_owned_ptr)) {
+    m_acc_mem_adv->setReadMostly(m_buf_owned_evi.view());
+  }
+  if (m_acc_mem_adv && (first_call || m_buf_ghost_evi.data() != prev_ghost_ptr)) {
+    m_acc_mem_adv->setReadMostly(m_buf_ghost_evi.view());
+  }
+}
 
-  // Construction des EnvVarIndex(es) par environnement des groupes de mailles ...
-  // "all" (TODO : on pourrait passer directement par les EnvCell)
-  _eviListFromGroup(m_mesh_material_mng->mesh()->allCells(),
-      m_buf_all_evi_4env, 
-      m_indexes_all_evi_penv, m_nb_all_evi_penv);
+/*---------------------------------------------------------------------------*/
+/* Trie par couche fantôme croissante les listes par voisin                  */
+/*                                                                           */
+/* Arcane construit ses listes en parcourant les mailles de sharedItems(inei)*/
+/* (resp. ghostItems(inei)) et pour chacune ses environnements (et leurs     */
+/* matériaux) puis la maille globale MatVarIndex(0,lid) : chaque EnvVarIndex */
+/* prend la couche de sa maille. Si les tailles ne correspondent pas, on     */
+/* renonce (synchro de toutes les couches)                                   */
+/*---------------------------------------------------------------------------*/
+bool SyncEnvIndexes::_sortEviPnByLayer() {
 
-  // "owned"
-  _eviListFromGroup(m_mesh_material_mng->mesh()->ownCells(),
-      m_buf_owned_evi_4env, 
-      m_indexes_owned_evi_penv, m_nb_owned_evi_penv);
+  Integer nb_layer = m_sync_cells->nbGhostLayer();
+  if (nb_layer<=1) {
+    return false;
+  }
+
+  IItemFamily* cell_family = m_mesh_material_mng->mesh()->cellFamily();
+  IVariableSynchronizer* cell_sync = cell_family->allItemsSynchronizer();
+  CellToAllEnvCellConverter allenvcell_converter(m_mesh_material_mng);
+  bool has_mat = (m_mvs == MatVarSpace::MaterialAndEnvironment);
+
+  auto evi_layers = [&](Int32ConstArrayView cell_lids, ConstArrayView<Integer> cell_layers,
+      Integer nb_evi, IntegerUniqueArray& layers) -> bool
+  {
+    layers.clear();
+    layers.reserve(nb_evi);
+    Integer icell_lst=0;
+    ENUMERATE_CELL(icell, cell_family->view(cell_lids)) {
+      AllEnvCell allevc = allenvcell_converter[*icell];
+      Integer nb_evi_cell=1; // la maille globale
+      ENUMERATE_CELL_ENVCELL(ievc, allevc) {
+        nb_evi_cell += 1 + (has_mat ? (*ievc).nbMaterial() : 0);
+      }
+      for(Integer k=0 ; k<nb_evi_cell ; ++k) {
+        layers.add(cell_layers[icell_lst]);
+      }
+      icell_lst++;
+    }
+    return (layers.size()==nb_evi);
+  };
 
-  // "private"
-  _eviListFromGroup(m_sync_cells->privateItems(),
-      m_buf_private_evi_4env, 
-      m_indexes_private_evi_penv, m_nb_private_evi_penv);
+  MultiArray2View<EnvVarIndex> owned_evi_pn(m_buf_owned_evi.view(),
+      m_indexes_owned_evi_pn.constView(), m_nb_owned_evi_pn.constView());
+  MultiArray2View<EnvVarIndex> ghost_evi_pn(m_buf_ghost_evi.view(),
+      m_indexes_ghost_evi_pn.constView(), m_nb_ghost_evi_pn.constView());
 
-  // "shared"
-  _eviListFromGroup(m_sync_cells->sharedItems(),
-      m_buf_shared_evi_4env, 
-      m_indexes_shared_evi_penv, m_nb_shared_evi_penv);
+  // On vérifie d'abord que toutes les listes sont compatibles
+  UniqueArray<IntegerUniqueArray> owned_layers(m_nb_nei);
+  UniqueArray<IntegerUniqueArray> ghost_layers(m_nb_nei);
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    if (!evi_layers(cell_sync->sharedItems(inei), m_sync_cells->ownedLayerPn()[inei],
+          m_nb_owned_evi_pn[inei], owned_layers[inei]) ||
+        !evi_layers(cell_sync->ghostItems(inei), m_sync_cells->ghostLayerPn()[inei],
+          m_nb_ghost_evi_pn[inei], ghost_layers[inei])) {
+      return false;
+    }
+  }
+
+  m_nb_owned_evi_pnd.resize(nb_layer);
+  m_nb_ghost_evi_pnd.resize(nb_layer);
+  for(Integer depth=1 ; depth<=nb_layer ; ++depth) {
+    m_nb_owned_evi_pnd[depth-1].resize(m_nb_nei);
+    m_nb_ghost_evi_pnd[depth-1].resize(m_nb_nei);
+  }
+  IntegerUniqueArray nb_upto_layer(nb_layer);
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    sort_by_ghost_layer(owned_evi_pn[inei], owned_layers[inei].constView(), nb_upto_layer);
+    for(Integer depth=1 ; depth<=nb_layer ; ++depth) {
+      m_nb_owned_evi_pnd[depth-1][inei] = nb_upto_layer[depth-1];
+    }
+    sort_by_ghost_layer(ghost_evi_pn[inei], ghost_layers[inei].constView(), nb_upto_layer);
+    for(Integer depth=1 ; depth<=nb_layer ; ++depth) {
+      m_nb_ghost_evi_pnd[depth-1][inei] = nb_upto_layer[depth-1];
+    }
+  }
+  return true;
 }
 
 /*---------------------------------------------------------------------------*/
-/* Calcule les listes de EnvIndex(es) par environnement à partir d'un groupe de mailles */
+/* Remplace les listes des environnements changed_env_ids par new_evis_penv  */
+/*                                                                           */
+/* Si chaque nouvelle liste tient dans la capacité de son segment, elle est  */
+/* recopiée sur place, les autres environnements ne sont pas touchés.        */
+/* Sinon, tous les segments sont redisposés avec de la marge pour absorber   */
+/* les prochaines variations des interfaces.                                 */
 /*---------------------------------------------------------------------------*/
-void SyncEnvIndexes::_eviListFromGroup(CellGroup cell_group,
-    UniqueArray<EnvVarIndex>& buf_evi, 
-    IntegerUniqueArray&       indexes_evi_penv,
-    IntegerUniqueArray&       nb_evi_penv
-    ) {
+void SyncEnvIndexes::_patchEviPenv(ConstArrayView<Integer> changed_env_ids,
+    const UniqueArray<UniqueArray<EnvVarIndex>>& new_evis_penv,
+    EviPenvList& evi_penv) {
 
   Integer nb_env = m_mesh_material_mng->environments().size();
+  Integer nb_changed = changed_env_ids.size();
 
-  // Un premier parcours des mailles pour compter et allouer
-  nb_evi_penv.resize(nb_env);
-  for(Integer ienv=0 ; ienv<nb_env ; ++ienv) {
-    nb_evi_penv[ienv] = 0;
+  bool fit_in_place = (evi_penv.m_nb.size() == nb_env);
+  for(Integer ich=0 ; ich<nb_changed && fit_in_place ; ++ich) {
+    Integer env_id = changed_env_ids[ich];
+    fit_in_place = (new_evis_penv[ich].size() <= evi_penv.m_capacity[env_id]);
   }
 
-  ENUMERATE_ALLENVCELL(iallevc, m_mesh_material_mng, cell_group){
-    AllEnvCell allevc = *iallevc;
-    ENUMERATE_CELL_ENVCELL(ievc, allevc){
-      EnvCell evc = *ievc;
-      Integer env_id = evc.environmentId();
-      nb_evi_penv[env_id]++;
+  if (fit_in_place) {
+    for(Integer ich=0 ; ich<nb_changed ; ++ich) {
+      Integer env_id = changed_env_ids[ich];
+      ConstArrayView<EnvVarIndex> new_evis = new_evis_penv[ich].constView();
+      evi_penv.m_buf.subView(evi_penv.m_indexes[env_id], new_evis.size()).copy(new_evis);
+      evi_penv.m_nb[env_id] = new_evis.size();
     }
+    return;
   }
 
-  indexes_evi_penv.resize(nb_env);
-  Integer accu_nb_evi=0;
-  for(Integer ienv=0 ; ienv<nb_env ; ++ienv) {
-    indexes_evi_penv[ienv] = accu_nb_evi;
-    accu_nb_evi += nb_evi_penv[ienv];
+  // Nouvelles tailles, les environnements non modifiés gardent les leurs
+  IntegerUniqueArray new_nb(nb_env, 0);
+  for(Integer env_id=0 ; env_id<evi_penv.m_nb.size() && env_id<nb_env ; ++env_id) {
+    new_nb[env_id] = evi_penv.m_nb[env_id];
+  }
+  for(Integer ich=0 ; ich<nb_changed ; ++ich) {
+    new_nb[changed_env_ids[ich]] = new_evis_penv[ich].size();
   }
 
-  // Un deuxième parcours des mailles pour remplir les evi cette fois-ci
-  buf_evi.resize(accu_nb_evi);
-
-  // On construit des multi-vues sur des zones allouées en mémoire managées
-  MultiArray2View<EnvVarIndex> levis_penv(buf_evi.view(),
-      indexes_evi_penv.constView(), nb_evi_penv.constView());
-
-  IntegerUniqueArray cur_penv(nb_env, 0);
+  // Disposition avec marge (1/8 + 16) par environnement
+  IntegerUniqueArray new_capacity(nb_env);
+  IntegerUniqueArray new_indexes(nb_env);
+  Integer accu_capacity=0;
+  for(Integer env_id=0 ; env_id<nb_env ; ++env_id) {
+    new_capacity[env_id] = new_nb[env_id] + new_nb[env_id]/8 + 16;
+    new_indexes[env_id] = accu_capacity;
+    accu_capacity += new_capacity[env_id];
+  }
 
-  ENUMERATE_ALLENVCELL(iallevc, m_mesh_material_mng, cell_group){
-    AllEnvCell allevc = *iallevc;
-    ENUMERATE_CELL_ENVCELL(ievc, allevc){
-      EnvCell evc = *ievc;
-      Integer env_id = evc.environmentId();
-      const MatVarIndex& mvi = evc._varIndex();
-      Integer i = cur_penv[env_id];
-      levis_penv[env_id][i] = EnvVarIndex(mvi.arrayIndex(), mvi.valueIndex());
-      cur_penv[env_id]++;
+  UniqueArray<EnvVarIndex> new_buf(platform::getAcceleratorHostMemoryAllocator(), accu_capacity);
+  IntegerUniqueArray is_changed(nb_env, 0);
+  for(Integer ich=0 ; ich<nb_changed ; ++ich) {
+    Integer env_id = changed_env_ids[ich];
+    is_changed[env_id] = 1;
+    new_buf.subView(new_indexes[env_id], new_nb[env_id]).copy(new_evis_penv[ich].constView());
+  }
+  for(Integer env_id=0 ; env_id<evi_penv.m_nb.size() && env_id<nb_env ; ++env_id) {
+    if (!is_changed[env_id]) {
+      new_buf.subView(new_indexes[env_id], new_nb[env_id]).copy(
+          evi_penv.m_buf.subConstView(evi_penv.m_indexes[env_id], new_nb[env_id]));
     }
   }
 
+  evi_penv.m_buf.swap(new_buf);
+  evi_penv.m_indexes.copy(new_indexes);
+  evi_penv.m_nb.copy(new_nb);
+  evi_penv.m_capacity.swap(new_capacity);
+
+  // Les adresses ont changé : "conseils" mémoire
   if (m_acc_mem_adv) {
-    m_acc_mem_adv->setReadMostly(buf_evi          .view());
-    m_acc_mem_adv->setReadMostly(indexes_evi_penv .view());
-    m_acc_mem_adv->setReadMostly(nb_evi_penv      .view());
+    m_acc_mem_adv->setReadMostly(evi_penv.m_buf    .view());
+    m_acc_mem_adv->setReadMostly(evi_penv.m_indexes.view());
+    m_acc_mem_adv->setReadMostly(evi_penv.m_nb     .view());
   }
 }
-
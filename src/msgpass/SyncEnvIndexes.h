@@ -22,61 +22,91 @@ class SyncEnvIndexes {
     AccMemAdviser* acc_mem_adv);
   virtual ~SyncEnvIndexes() {}
 
-  //! Recalcule les listes de EnvIndex "owned" ("shared") et "ghost"
+  //! Met à jour les listes de EnvIndex, uniquement pour les environnements modifiés
   void updateEnvIndexes();
 
   MatVarSpace space() const { return m_mvs; }
 
-  auto nbOwnedEviPn() const {
-    return m_nb_owned_evi_pn.constView();
+  // Comme pour SyncItems, les listes par voisin sont triées par couche
+  // fantôme croissante, depth <= 0 : toutes les couches
+
+  ConstArrayView<Integer> nbOwnedEviPn(Integer depth=0) const {
+    return (_isAllLayers(depth) ? m_nb_owned_evi_pn.constView() :
+        m_nb_owned_evi_pnd[depth-1].constView());
   }
 
-  auto nbGhostEviPn() const {
-    return m_nb_ghost_evi_pn.constView();
+  ConstArrayView<Integer> nbGhostEviPn(Integer depth=0) const {
+    return (_isAllLayers(depth) ? m_nb_ghost_evi_pn.constView() :
+        m_nb_ghost_evi_pnd[depth-1].constView());
   }
 
   // Listes par voisin
 
-  auto ownedEviPn() const {
+  auto ownedEviPn(Integer depth=0) const {
     return ConstMultiArray2View<EnvVarIndex>(m_buf_owned_evi.constView(),
-        m_indexes_owned_evi_pn.constView(), m_nb_owned_evi_pn.constView());
+        m_indexes_owned_evi_pn.constView(), nbOwnedEviPn(depth));
   }
 
-  auto ghostEviPn() const {
+  auto ghostEviPn(Integer depth=0) const {
     return ConstMultiArray2View<EnvVarIndex>(m_buf_ghost_evi.constView(),
-        m_indexes_ghost_evi_pn.constView(), m_nb_ghost_evi_pn.constView());
+        m_indexes_ghost_evi_pn.constView(), nbGhostEviPn(depth));
   }
 
   // Listes par environnement
 
   auto allEviPenv() const {
-    return ConstMultiArray2View<EnvVarIndex>(m_buf_all_evi_4env.constView(),
-        m_indexes_all_evi_penv.constView(), m_nb_all_evi_penv.constView());
+    return m_all_evi_penv.constView();
   }
 
   auto ownEviPenv() const {
-    return ConstMultiArray2View<EnvVarIndex>(m_buf_owned_evi_4env.constView(),
-        m_indexes_owned_evi_penv.constView(), m_nb_owned_evi_penv.constView());
+    return m_owned_evi_penv.constView();
   }
 
   auto privateEviPenv() const {
-    return ConstMultiArray2View<EnvVarIndex>(m_buf_private_evi_4env.constView(),
-        m_indexes_private_evi_penv.constView(), m_nb_private_evi_penv.constView());
+    return m_private_evi_penv.constView();
   }
 
   auto sharedEviPenv() const {
-    return ConstMultiArray2View<EnvVarIndex>(m_buf_shared_evi_4env.constView(),
-        m_indexes_shared_evi_penv.constView(), m_nb_shared_evi_penv.constView());
+    return m_shared_evi_penv.constView();
   }
 
  protected:
 
-  //! Calcule les listes de EnvIndex(es) par environnement à partir d'un groupe de mailles
-  void _eviListFromGroup(CellGroup cell_group,
-      UniqueArray<EnvVarIndex>& buf_evi, 
-      IntegerUniqueArray&      indexes_evi_penv,
-      IntegerUniqueArray&      nb_evi_penv
-      );
+  /*!
+   * \brief Liste d'EnvVarIndex(es) par environnement
+   *
+   * Chaque environnement dispose d'un segment de m_buf de capacité
+   * m_capacity[env_id] >= m_nb[env_id], ce qui permet de réécrire sur place
+   * la liste d'un environnement modifié sans toucher aux autres
+   */
+  struct EviPenvList {
+    EviPenvList();
+
+    ConstMultiArray2View<EnvVarIndex> constView() const {
+      return ConstMultiArray2View<EnvVarIndex>(m_buf.constView(),
+          m_indexes.constView(), m_nb.constView());
+    }
+
+    UniqueArray<EnvVarIndex> m_buf;
+    IntegerUniqueArray       m_indexes;
+    IntegerUniqueArray       m_nb;
+    IntegerUniqueArray       m_capacity;
+  };
+
+  bool _isAllLayers(Integer depth) const {
+    return (depth<=0 || depth>=m_sync_cells->nbGhostLayer() || m_nb_owned_evi_pnd.empty());
+  }
+
+  //! Recalcule les listes "owned" et "ghost" par voisin
+  void _updateEviPn();
+
+  //! Trie par couche les listes par voisin, faux si les couches n'ont pu être déterminées
+  bool _sortEviPnByLayer();
+
+  //! Remplace les listes des environnements changed_env_ids par new_evis_penv
+  void _patchEviPenv(ConstArrayView<Integer> changed_env_ids,
+      const UniqueArray<UniqueArray<EnvVarIndex>>& new_evis_penv,
+      EviPenvList& evi_penv);
 
  protected:
 
@@ -102,26 +132,21 @@ class SyncEnvIndexes {
   IntegerUniqueArray       m_indexes_ghost_evi_pn;
   IntegerUniqueArray       m_nb_ghost_evi_pn;
 
+  // [depth-1] : nb d'EnvVarIndex(es) des couches 1..depth par voisin (vide si non triées)
+  UniqueArray<IntegerUniqueArray> m_nb_owned_evi_pnd;
+  UniqueArray<IntegerUniqueArray> m_nb_ghost_evi_pnd;
+
   // Listes des EnvVarIndex(es) par environnement des groupes de mailles ...
-  // "all"
-  UniqueArray<EnvVarIndex> m_buf_all_evi_4env    ;
-  IntegerUniqueArray       m_indexes_all_evi_penv;
-  IntegerUniqueArray       m_nb_all_evi_penv     ;
-
-  // "owned"
-  UniqueArray<EnvVarIndex> m_buf_owned_evi_4env    ;
-  IntegerUniqueArray       m_indexes_owned_evi_penv;
-  IntegerUniqueArray       m_nb_owned_evi_penv     ;
-
-  // "private"
-  UniqueArray<EnvVarIndex> m_buf_private_evi_4env    ;
-  IntegerUniqueArray       m_indexes_private_evi_penv;
-  IntegerUniqueArray       m_nb_private_evi_penv     ;
-
-  // "shared"
-  UniqueArray<EnvVarIndex> m_buf_shared_evi_4env    ;
-  IntegerUniqueArray       m_indexes_shared_evi_penv;
-  IntegerUniqueArray       m_nb_shared_evi_penv;
+  EviPenvList m_all_evi_penv;  //! "all"
+  EviPenvList m_owned_evi_penv;  //! "owned"
+  EviPenvList m_private_evi_penv;  //! "private"
+  EviPenvList m_shared_evi_penv;  //! "shared"
+
+  // Pour détecter les changements depuis la dernière maj
+  Int64UniqueArray m_env_timestamps;  //! Estampille du groupe de mailles de chaque environnement ...
+  UniqueArray<Int32UniqueArray> m_env_cell_lids;  //! ... et ses mailles
+  IntegerUniqueArray m_cell_marker;  //! Marqueur par maille pour les différences de listes
+  Integer m_marker_tag=0;
 };
 
 #endif
@@ -3,9 +3,13 @@
 #include <arcane/IVariableSynchronizer.h>
 #include <arcane/IItemFamily.h>
 #include <arcane/ItemGroup.h>
+#include <arcane/ItemGroupImpl.h>
 #include <arcane/MeshVariableScalarRef.h>
 #include <arcane/MeshVariableArrayRef.h>
 #include <arcane/VariableBuildInfo.h>
+#include <arcane/IParallelMng.h>
+
+#include <algorithm>
 
 // Retourne le eItemKind en fonction de ItemType
 template<typename ItemType>
@@ -94,12 +98,95 @@ const char* get_string_items<Node>() {
   return "Node";
 }
 
+/*---------------------------------------------------------------------------*/
+/* Couche fantôme de chaque maille : 0 pour les mailles propres, 1 pour les  */
+/* fantômes ayant un noeud commun avec une maille propre, 2 pour celles      */
+/* ayant un noeud commun avec la couche 1, etc.                              */
+/*---------------------------------------------------------------------------*/
+static IntegerUniqueArray compute_cell_ghost_layers(IMesh* mesh) {
+  IntegerUniqueArray cell_layer(mesh->cellFamily()->maxLocalId());
+  IntegerUniqueArray node_layer(mesh->nodeFamily()->maxLocalId());
+  cell_layer.fill(-1);
+  node_layer.fill(-1);
+
+  ENUMERATE_CELL(icell, mesh->ownCells()) {
+    cell_layer[icell.localId()] = 0;
+    ENUMERATE_NODE(inode, (*icell).nodes()) {
+      node_layer[inode.localId()] = 0;
+    }
+  }
+
+  Int32UniqueArray remaining_lids;
+  ENUMERATE_CELL(icell, mesh->allCells()) {
+    if (cell_layer[icell.localId()] < 0) {
+      remaining_lids.add(icell.localId());
+    }
+  }
+
+  // Parcours en largeur par couche, uniquement sur les mailles fantômes
+  Integer layer=0;
+  Int32UniqueArray next_remaining_lids;
+  Int32UniqueArray layer_lids;
+  while(!remaining_lids.empty()) {
+    layer++;
+    next_remaining_lids.clear();
+    layer_lids.clear();
+    ENUMERATE_CELL(icell, mesh->cellFamily()->view(remaining_lids)) {
+      bool touch_prev_layer=false;
+      ENUMERATE_NODE(inode, (*icell).nodes()) {
+        if (node_layer[inode.localId()] >= 0) {
+          touch_prev_layer=true;
+          break;
+        }
+      }
+      if (touch_prev_layer) {
+        layer_lids.add(icell.localId());
+      } else {
+        next_remaining_lids.add(icell.localId());
+      }
+    }
+    if (layer_lids.empty()) {
+      // Mailles non connectées aux précédentes : on les met dans cette couche
+      layer_lids.swap(next_remaining_lids);
+    }
+    ENUMERATE_CELL(icell, mesh->cellFamily()->view(layer_lids)) {
+      cell_layer[icell.localId()] = layer;
+      ENUMERATE_NODE(inode, (*icell).nodes()) {
+        if (node_layer[inode.localId()] < 0) {
+          node_layer[inode.localId()] = layer;
+        }
+      }
+    }
+    remaining_lids.swap(next_remaining_lids);
+  }
+  return cell_layer;
+}
+
+// Couche fantôme d'un item : plus petite couche de ses mailles (au moins 1)
+template<typename ItemType>
+Integer get_item_ghost_layer(ItemType item, ConstArrayView<Integer> cell_layer) {
+  Integer layer=-1;
+  ENUMERATE_CELL(icell, item.cells()) {
+    Integer l = cell_layer[icell.localId()];
+    if (layer<0 || l<layer) {
+      layer = l;
+    }
+  }
+  return std::max(layer, 1);
+}
+
+template<>
+Integer get_item_ghost_layer(Cell item, ConstArrayView<Integer> cell_layer) {
+  return std::max(cell_layer[item.localId()], 1);
+}
+
 /*---------------------------------------------------------------------------*/
 /* Encapsule la liste des items à envoyer/recevoir pour un type d'item donné */
 /*---------------------------------------------------------------------------*/
 template<typename ItemType>
 SyncItems<ItemType>::SyncItems(IMesh* mesh, Int32ConstArrayView neigh_ranks,
     AccMemAdviser* acc_mem_adv) :
+  m_acc_mem_adv           (acc_mem_adv),
   m_buf_owned_item_idx    (platform::getAcceleratorHostMemoryAllocator()),
   m_indexes_owned_item_pn (platform::getAcceleratorHostMemoryAllocator()),
   m_nb_owned_item_pn      (platform::getAcceleratorHostMemoryAllocator()),
@@ -109,6 +196,7 @@ SyncItems<ItemType>::SyncItems(IMesh* mesh, Int32ConstArrayView neigh_ranks,
 {
   eItemKind item_kind = get_item_kind<ItemType>();
   IItemFamily* item_family = mesh->itemFamily(item_kind);
+  m_item_family = item_family;
   IVariableSynchronizer* var_sync = item_family->allItemsSynchronizer();
   
   Integer nb_nei = neigh_ranks.size();
@@ -161,6 +249,60 @@ SyncItems<ItemType>::SyncItems(IMesh* mesh, Int32ConstArrayView neigh_ranks,
     lids2itemidx(var_sync->ghostItems(inei) , ghost_item_idx_pn[inei]);
   }
 
+  // Couche fantôme des items : calculée localement pour les fantômes, puis
+  // envoyée au propriétaire qui la récupère pour ses items "shared"
+  // (sharedItems(inei) ici et ghostItems(inei) chez le voisin sont dans le même ordre)
+  m_buf_owned_layer.resize(accu_nb_owned);
+  m_buf_ghost_layer.resize(accu_nb_ghost);
+  MultiArray2View<Integer> owned_layer_pn(m_buf_owned_layer.view(),
+      m_indexes_owned_item_pn.constView(), m_nb_owned_item_pn.constView());
+  MultiArray2View<Integer> ghost_layer_pn(m_buf_ghost_layer.view(),
+      m_indexes_ghost_item_pn.constView(), m_nb_ghost_item_pn.constView());
+  {
+    IntegerUniqueArray cell_layer = compute_cell_ghost_layers(mesh);
+    Integer max_layer=1;
+    for(Integer inei=0 ; inei<nb_nei ; ++inei) {
+      ItemVectorViewT<ItemType> ghost_items(item_family->view(var_sync->ghostItems(inei)));
+      ArrayView<Integer> layers = ghost_layer_pn[inei];
+      Integer i=0;
+      ENUMERATE_(ItemType, iitem, ghost_items) {
+        layers[i] = get_item_ghost_layer<ItemType>(*iitem, cell_layer);
+        max_layer = std::max(max_layer, layers[i]);
+        i++;
+      }
+    }
+
+    IParallelMng* pm = mesh->parallelMng();
+    UniqueArray<Parallel::Request> requests;
+    for(Integer inei=0 ; inei<nb_nei ; ++inei) {
+      requests.add(pm->recv(owned_layer_pn[inei], neigh_ranks[inei], /*blocking=*/false));
+      requests.add(pm->send(Int32ConstArrayView(ghost_layer_pn[inei]), neigh_ranks[inei], /*blocking=*/false));
+    }
+    pm->waitAllRequests(requests);
+
+    m_nb_ghost_layer = pm->reduce(Parallel::ReduceMax, max_layer);
+  }
+
+  // Tri stable des listes par voisin par couche croissante, et nb d'items
+  // par voisin des couches 1..depth
+  m_nb_owned_item_pnd.resize(m_nb_ghost_layer);
+  m_nb_ghost_item_pnd.resize(m_nb_ghost_layer);
+  for(Integer depth=1 ; depth<=m_nb_ghost_layer ; ++depth) {
+    m_nb_owned_item_pnd[depth-1] = IntegerUniqueArray(platform::getAcceleratorHostMemoryAllocator(), nb_nei);
+    m_nb_ghost_item_pnd[depth-1] = IntegerUniqueArray(platform::getAcceleratorHostMemoryAllocator(), nb_nei);
+  }
+  IntegerUniqueArray nb_upto_layer(m_nb_ghost_layer);
+  for(Integer inei=0 ; inei<nb_nei ; ++inei) {
+    sort_by_ghost_layer(owned_item_idx_pn[inei], owned_layer_pn[inei], nb_upto_layer);
+    for(Integer depth=1 ; depth<=m_nb_ghost_layer ; ++depth) {
+      m_nb_owned_item_pnd[depth-1][inei] = nb_upto_layer[depth-1];
+    }
+    sort_by_ghost_layer(ghost_item_idx_pn[inei], ghost_layer_pn[inei], nb_upto_layer);
+    for(Integer depth=1 ; depth<=m_nb_ghost_layer ; ++depth) {
+      m_nb_ghost_item_pnd[depth-1][inei] = nb_upto_layer[depth-1];
+    }
+  }
+
   // Les groupes d'items
   using ItemIdType = typename ItemType::LocalIdType;
   MeshVariableScalarRefT<ItemType,Integer> item_status(VariableBuildInfo(mesh, "TemporaryItemStatus"));
@@ -226,6 +368,15 @@ SyncItems<ItemType>::SyncItems(IMesh* mesh, Int32ConstArrayView neigh_ranks,
   m_ghost_items  = item_family->createGroup( String("Ghost")  +str_items, all_ghost_lids  , /*do_override=*/true);
   m_shared_ghost_items = item_family->createGroup( String("SharedGhost")  +str_items, all_shared_ghost_lids  , /*do_override=*/true);
 
+  // Pour découper les groupes quelconques
+  m_own_items = own_items;
+  m_all_items = all_items;
+  m_item_status.resize(item_family->maxLocalId());
+  m_item_status.fill(0);
+  ENUMERATE_(ItemType, iitem, all_items) {
+    m_item_status[iitem->localId()] = item_status[iitem];
+  }
+
   ARCANE_ASSERT(own_items.size()==(m_private_items.size()+m_shared_items.size()),
       ("own != private+shared"));
   ARCANE_ASSERT((all_items.size()-own_items.size())==m_ghost_items.size(),
@@ -250,6 +401,63 @@ SyncItems<ItemType>::SyncItems(IMesh* mesh, Int32ConstArrayView neigh_ranks,
   acc_mem_adv->setReadMostly(m_shared_ghost_items.view().localIds());
 }
 
+/*---------------------------------------------------------------------------*/
+/* Découpage de item_group en items private et items de bord (shared/ghost)  */
+/* Les groupes "own" et "all" réutilisent les groupes pré-construits, les    */
+/* autres sont intersectés avec les statuts des items. Le résultat est mis   */
+/* en cache et recalculé uniquement si le groupe a été modifié.              */
+/*---------------------------------------------------------------------------*/
+template<typename ItemType>
+const typename SyncItems<ItemType>::GroupSplit& SyncItems<ItemType>::
+_groupSplit(ItemGroupType item_group) {
+
+  GroupSplit& split = m_group_splits[item_group.name()];
+  Int64 timestamp = item_group.internal()->timestamp();
+  if (split.m_timestamp == timestamp) {
+    return split;
+  }
+  split.m_timestamp = timestamp;
+
+  if (item_group == m_own_items) {
+    split.m_private_items = m_private_items;
+    split.m_boundary_items = m_shared_items;
+    split.m_nb_ghost = 0;
+    return split;
+  } else if (item_group == m_all_items) {
+    split.m_private_items = m_private_items;
+    split.m_boundary_items = m_shared_ghost_items;
+    split.m_nb_ghost = m_ghost_items.size();
+    return split;
+  }
+
+  IntegerUniqueArray private_item_ids;
+  IntegerUniqueArray boundary_item_ids;
+  private_item_ids.reserve(item_group.size());
+  split.m_nb_ghost = 0;
+
+  ENUMERATE_(ItemType, iitem, item_group) {
+    Integer status = m_item_status[iitem->localId()];
+    if (status == 0) {
+      private_item_ids.add(iitem->localId());
+    } else {
+      boundary_item_ids.add(iitem->localId());
+      if (status < 0) {
+        split.m_nb_ghost++;
+      }
+    }
+  }
+
+  // Les groupes sont écrasés si le groupe d'origine a changé
+  String grp_name = item_group.name();
+  split.m_private_items = m_item_family->createGroup(String("Private")+grp_name, private_item_ids, /*do_override=*/true);
+  split.m_boundary_items = m_item_family->createGroup(String("Boundary")+grp_name, boundary_item_ids, /*do_override=*/true);
+
+  m_acc_mem_adv->setReadMostly(split.m_private_items.view().localIds());
+  m_acc_mem_adv->setReadMostly(split.m_boundary_items.view().localIds());
+
+  return split;
+}
+
 /*---------------------------------------------------------------------------*/
 /* INSTANCIATIONS STATIQUES                                                  */
 /*---------------------------------------------------------------------------*/
@@ -5,6 +5,9 @@
 #include <arcane/IMesh.h>
 #include <arcane/utils/MultiArray2.h>
 
+#include <algorithm>
+#include <map>
+
 using namespace Arcane;
 
 /*---------------------------------------------------------------------------*/
@@ -27,21 +30,44 @@ class SyncItems {
       AccMemAdviser* acc_mem_adv);
   virtual ~SyncItems() {}
 
-  auto nbOwnedItemIdxPn() const {
-    return m_nb_owned_item_pn.constView();
+  // Les listes par voisin sont triées par couche fantôme croissante (même
+  // ordre des deux côtés) : les items des couches 1..depth en sont un préfixe.
+  // depth <= 0 ou >= nbGhostLayer() : toutes les couches
+
+  //! Nb max de couches de mailles fantômes (identique sur tous les sous-domaines)
+  Integer nbGhostLayer() const {
+    return m_nb_ghost_layer;
   }
 
-  auto nbGhostItemIdxPn() const {
-    return m_nb_ghost_item_pn.constView();
+  ConstArrayView<Integer> nbOwnedItemIdxPn(Integer depth=0) const {
+    return (_isAllLayers(depth) ? m_nb_owned_item_pn.constView() : 
+        m_nb_owned_item_pnd[depth-1].constView());
   }
 
-  auto ownedItemIdxPn() const {
+  ConstArrayView<Integer> nbGhostItemIdxPn(Integer depth=0) const {
+    return (_isAllLayers(depth) ? m_nb_ghost_item_pn.constView() : 
+        m_nb_ghost_item_pnd[depth-1].constView());
+  }
+
+  auto ownedItemIdxPn(Integer depth=0) const {
     return ConstMultiArray2View<Integer>(m_buf_owned_item_idx.constView(),
-        m_indexes_owned_item_pn.constView(), m_nb_owned_item_pn.constView());
+        m_indexes_owned_item_pn.constView(), nbOwnedItemIdxPn(depth));
   }
 
-  auto ghostItemIdxPn() const {
+  auto ghostItemIdxPn(Integer depth=0) const {
     return ConstMultiArray2View<Integer>(m_buf_ghost_item_idx.constView(),
+        m_indexes_ghost_item_pn.constView(), nbGhostItemIdxPn(depth));
+  }
+
+  // Couche fantôme de chaque item de IVariableSynchronizer::sharedItems(inei)
+  // (resp. ghostItems(inei)) dans l'ordre d'Arcane et non celui de ownedItemIdxPn()
+  auto ownedLayerPn() const {
+    return ConstMultiArray2View<Integer>(m_buf_owned_layer.constView(),
+        m_indexes_owned_item_pn.constView(), m_nb_owned_item_pn.constView());
+  }
+
+  auto ghostLayerPn() const {
+    return ConstMultiArray2View<Integer>(m_buf_ghost_layer.constView(),
         m_indexes_ghost_item_pn.constView(), m_nb_ghost_item_pn.constView());
   }
 
@@ -70,7 +96,46 @@ class SyncItems {
     return (group_category==GC_own ? sharedItems() : sharedGhostItems());
   }
 
+  // Pour un groupe quelconque, items de item_group qui n'interviennent pas dans les comms
+  ItemGroupType privateItems(ItemGroupType item_group) {
+    return _groupSplit(item_group).m_private_items;
+  }
+
+  // Pour un groupe quelconque, items de item_group concernés par les comms (shared ou ghost)
+  ItemGroupType boundaryItems(ItemGroupType item_group) {
+    return _groupSplit(item_group).m_boundary_items;
+  }
+
+  // Statut de chaque item par localId : 0 private, >0 shared, <0 ghost
+  ConstArrayView<Integer> itemStatus() const {
+    return m_item_status.constView();
+  }
+
+  // Vrai si item_group contient des items fantômes
+  bool hasGhostItems(ItemGroupType item_group) {
+    return _groupSplit(item_group).m_nb_ghost>0;
+  }
+
  protected:
+  bool _isAllLayers(Integer depth) const {
+    return (depth<=0 || depth>=m_nb_ghost_layer);
+  }
+
+  // Découpage d'un groupe quelconque en items private et items de bord
+  struct GroupSplit {
+    ItemGroupType m_private_items;
+    ItemGroupType m_boundary_items;
+    Integer m_nb_ghost=0;
+    Int64 m_timestamp=-1;  //! Estampille du groupe lors du découpage
+  };
+
+  // Retourne le découpage de item_group (calculé une fois par groupe et par modification du groupe)
+  const GroupSplit& _groupSplit(ItemGroupType item_group);
+
+ protected:
+  IItemFamily* m_item_family=nullptr;
+  AccMemAdviser* m_acc_mem_adv=nullptr;
+
   // "shared" ou "owned" : les items intérieurs au sous-domaine et qui doivent être envoyés
   // "ghost" : les items fantômes pour lesquels on va recevoir des informations
   // _pn : _per_neigh, info par voisin
@@ -86,6 +151,13 @@ class SyncItems {
   IntegerUniqueArray m_indexes_ghost_item_pn;
   IntegerUniqueArray m_nb_ghost_item_pn;
 
+  // Couches fantômes
+  Integer m_nb_ghost_layer=1;
+  UniqueArray<IntegerUniqueArray> m_nb_owned_item_pnd;  //! [depth-1] : nb d'items des couches 1..depth par voisin
+  UniqueArray<IntegerUniqueArray> m_nb_ghost_item_pnd;
+  IntegerUniqueArray m_buf_owned_layer;  //! Couche de chaque item, ordre Arcane
+  IntegerUniqueArray m_buf_ghost_layer;
+
   // Les groupes d'items
   // own() = private + shared  , private \inter shared = 0
   // all() = own() + ghost
@@ -94,8 +166,45 @@ class SyncItems {
   ItemGroupType m_shared_items;
   ItemGroupType m_ghost_items;
   ItemGroupType m_shared_ghost_items;
+
+  ItemGroupType m_own_items;
+  ItemGroupType m_all_items;
+
+  // Statut de chaque item par localId : 0 private, >0 shared, <0 ghost
+  IntegerUniqueArray m_item_status;
+
+  // Découpages des groupes quelconques, par nom de groupe
+  std::map<String, GroupSplit> m_group_splits;
 };
 
+/*---------------------------------------------------------------------------*/
+/* Tri stable de values par couche fantôme croissante (layers[i] >= 1 est la */
+/* couche de values[i]) ; nb_upto_layer[d-1] = nb de valeurs des couches 1..d */
+/* Le même tri appliqué aux listes "owned" et "ghost" d'une paire de voisins  */
+/* conserve leur correspondance                                              */
+/*---------------------------------------------------------------------------*/
+template<typename T>
+void sort_by_ghost_layer(ArrayView<T> values, ConstArrayView<Integer> layers,
+    ArrayView<Integer> nb_upto_layer) {
+  Integer nb_layer = nb_upto_layer.size();
+  nb_upto_layer.fill(0);
+  for(Integer l : layers) {
+    nb_upto_layer[std::min(l, nb_layer)-1]++;
+  }
+  IntegerUniqueArray pos(nb_layer);
+  Integer accu=0;
+  for(Integer l=0 ; l<nb_layer ; ++l) {
+    pos[l] = accu;
+    accu += nb_upto_layer[l];
+    nb_upto_layer[l] = accu;
+  }
+  UniqueArray<T> sorted_values(values.size());
+  for(Integer i=0 ; i<values.size() ; ++i) {
+    sorted_values[pos[std::min(layers[i], nb_layer)-1]++] = values[i];
+  }
+  values.copy(sorted_values);
+}
+
 /* Retourne les groupes associés aux types d'items
  */
 template<typename ItemType>
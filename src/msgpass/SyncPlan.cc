@@ -0,0 +1,299 @@
+#include "msgpass/SyncPlan.h"
+
+#include <arcane/utils/NotSupportedException.h>
+#include <arcane/utils/FatalErrorException.h>
+
+#ifdef MSG_PASS_HAS_MPI
+#include <mpi.h>
+
+/*---------------------------------------------------------------------------*/
+/* Persistent MPI requests : [0,nb_nei[ receipts, [nb_nei,2*nb_nei[ sendings */
+/*---------------------------------------------------------------------------*/
+struct SyncPlan::PersistentRequests {
+  //! Tag for the messages of the plans (must differ from Arcane ones)
+  static constexpr int TAG_SYNC_PLAN = 4253;
+
+  Integer m_nb_nei=0;
+  UniqueArray<MPI_Request> m_requests;
+  UniqueArray<int> m_indices;  //! Output of MPI_Waitsome
+
+  PersistentRequests(Integer nb_nei) :
+    m_nb_nei (nb_nei)
+  {
+    m_requests.resize(2*m_nb_nei);
+    m_requests.fill(MPI_REQUEST_NULL);
+    m_indices.resize(2*m_nb_nei);
+  }
+
+  ~PersistentRequests() {
+    // Les requêtes ne peuvent plus être libérées après MPI_Finalize
+    int is_finalized=0;
+    MPI_Finalized(&is_finalized);
+    if (!is_finalized) {
+      for(auto& req : m_requests) {
+        if (req!=MPI_REQUEST_NULL) {
+          MPI_Request_free(&req);
+        }
+      }
+    }
+  }
+};
+#else
+struct SyncPlan::PersistentRequests {
+};
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncPlan                                                           */
+/* \brief Persistent communication plan for one signature of a list of       */
+/*   variables to synchronize                                                */
+/*---------------------------------------------------------------------------*/
+
+SyncPlan::SyncPlan(Int64 hash, Int64ConstArrayView signature) :
+  m_hash      (hash),
+  m_signature (signature)
+{
+}
+
+SyncPlan::~SyncPlan() {
+  _freePersistentRequests();
+}
+
+/*---------------------------------------------------------------------------*/
+/* True if the plan was built for this signature                             */
+/*---------------------------------------------------------------------------*/
+bool SyncPlan::matches(Int64 hash, Int64ConstArrayView signature) const {
+  if (hash!=m_hash || signature.size()!=m_signature.size()) {
+    return false;
+  }
+  for(Integer i=0 ; i<signature.size() ; ++i) {
+    if (signature[i]!=m_signature[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/* True if the buffer layouts are still valid for the sub-allocation sub_buf */
+/* (same arena allocation and same position, never for an overflow buffer)  */
+/*---------------------------------------------------------------------------*/
+bool SyncPlan::isLayoutValid(SyncBuffers::SubBuf* sub_buf) const {
+  return sub_buf->m_generation>=0 &&
+    m_buf_generation==sub_buf->m_generation &&
+    m_buf_offset==sub_buf->m_offset;
+}
+
+/*---------------------------------------------------------------------------*/
+/* (Re)compute the buffer layouts of vars inside the sub-allocation sub_buf  */
+/*---------------------------------------------------------------------------*/
+void SyncPlan::buildLayout(ConstArrayView<IMeshVarSync*> vars, Integer nb_nei,
+    SyncBuffers* sync_buffers, SyncBuffers::SubBuf* sub_buf) {
+
+  // Les requêtes persistantes portent sur les anciennes adresses
+  _freePersistentRequests();
+
+  // Adresses et tailles des buffers d'envoi et de réception
+  // sur l'HOTE ("0") et sur le DEVICE ("1")
+  for(Integer imem=0 ; imem<2 ; ++imem) {
+    m_buf_snd[imem] = sync_buffers->multiBufViewVars(sub_buf, vars, nb_nei, IMeshVarSync::IS_owned, imem);
+    m_buf_rcv[imem] = sync_buffers->multiBufViewVars(sub_buf, vars, nb_nei, IMeshVarSync::IS_ghost, imem);
+  }
+
+  m_buf_generation = sub_buf->m_generation;
+  m_buf_offset = sub_buf->m_offset;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Create (if needed) the persistent requests on the buffers of sync_data    */
+/* Return false if persistent requests can't be used                         */
+/*---------------------------------------------------------------------------*/
+bool SyncPlan::initPersistentRequests(
+    [[maybe_unused]] IParallelMng* pm,
+    [[maybe_unused]] Int32ConstArrayView neigh_ranks,
+    [[maybe_unused]] IAlgo1SyncData* sync_data) {
+#ifdef MSG_PASS_HAS_MPI
+  if (m_pers_req) {
+    return true;
+  }
+  // Seule une implémentation "pure MPI" fournit un communicateur
+  // dont les rangs sont ceux de pm
+  if (!pm->isParallel() || pm->isThreadImplementation() || pm->isHybridImplementation()) {
+    return false;
+  }
+  void* comm_ptr = pm->getMPICommunicator();
+  if (!comm_ptr) {
+    return false;
+  }
+  MPI_Comm comm = *(static_cast<MPI_Comm*>(comm_ptr));
+
+  Integer nb_nei = neigh_ranks.size();
+  m_pers_req = new PersistentRequests(nb_nei);
+  for(Integer inei=0 ; inei<nb_nei ; ++inei) {
+    Int32 rank_nei = neigh_ranks[inei]; // le rang du inei-ième voisin
+
+    auto byte_buf_rcv = sync_data->recvBuf(inei); // le buffer de réception pour inei
+    MPI_Recv_init(byte_buf_rcv.data(), byte_buf_rcv.size(), MPI_BYTE,
+        rank_nei, PersistentRequests::TAG_SYNC_PLAN, comm,
+        &(m_pers_req->m_requests[inei]));
+
+    auto byte_buf_snd = sync_data->sendBuf(inei); // le buffer d'envoi pour inei
+    MPI_Send_init(byte_buf_snd.data(), byte_buf_snd.size(), MPI_BYTE,
+        rank_nei, PersistentRequests::TAG_SYNC_PLAN, comm,
+        &(m_pers_req->m_requests[nb_nei+inei]));
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Start all the persistent receipts                                         */
+/*---------------------------------------------------------------------------*/
+void SyncPlan::startRecvs() {
+#ifdef MSG_PASS_HAS_MPI
+  ARCANE_ASSERT(m_pers_req, ("Persistent requests not initialized"));
+  MPI_Startall(m_pers_req->m_nb_nei, m_pers_req->m_requests.data());
+#else
+  throw NotSupportedException(A_FUNCINFO, "Persistent requests need MPI");
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Start the persistent sending for the neighbour inei                       */
+/*---------------------------------------------------------------------------*/
+void SyncPlan::startSend([[maybe_unused]] Integer inei) {
+#ifdef MSG_PASS_HAS_MPI
+  ARCANE_ASSERT(m_pers_req, ("Persistent requests not initialized"));
+  MPI_Start(&(m_pers_req->m_requests[m_pers_req->m_nb_nei+inei]));
+#else
+  throw NotSupportedException(A_FUNCINFO, "Persistent requests need MPI");
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for some requests, fill done_indexes and return the number of them   */
+/* An index in [0,nb_nei[ is a receipt, in [nb_nei,2*nb_nei[ a sending       */
+/*---------------------------------------------------------------------------*/
+Integer SyncPlan::waitSome([[maybe_unused]] ArrayView<Integer> done_indexes) {
+#ifdef MSG_PASS_HAS_MPI
+  ARCANE_ASSERT(m_pers_req, ("Persistent requests not initialized"));
+  int nb_done=0;
+  MPI_Waitsome(m_pers_req->m_requests.size(), m_pers_req->m_requests.data(),
+      &nb_done, m_pers_req->m_indices.data(), MPI_STATUSES_IGNORE);
+  if (nb_done==MPI_UNDEFINED) {
+    return 0; // plus aucune requête active
+  }
+  for(int i=0 ; i<nb_done ; ++i) {
+    done_indexes[i] = m_pers_req->m_indices[i];
+  }
+  return nb_done;
+#else
+  throw NotSupportedException(A_FUNCINFO, "Persistent requests need MPI");
+  return 0;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Wait for all the sendings                                                 */
+/*---------------------------------------------------------------------------*/
+void SyncPlan::waitSends() {
+#ifdef MSG_PASS_HAS_MPI
+  ARCANE_ASSERT(m_pers_req, ("Persistent requests not initialized"));
+  Integer nb_nei = m_pers_req->m_nb_nei;
+  MPI_Waitall(nb_nei, m_pers_req->m_requests.data()+nb_nei, MPI_STATUSES_IGNORE);
+#else
+  throw NotSupportedException(A_FUNCINFO, "Persistent requests need MPI");
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/* Free the persistent requests                                              */
+/*---------------------------------------------------------------------------*/
+void SyncPlan::_freePersistentRequests() {
+  delete m_pers_req;
+  m_pers_req=nullptr;
+}
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncPlanMng                                                        */
+/* \brief Cache of SyncPlan, one plan per signature                          */
+/*---------------------------------------------------------------------------*/
+
+SyncPlanMng::SyncPlanMng(Integer nb_nei, Integer max_nb_plan) :
+  m_nb_nei      (nb_nei),
+  m_max_nb_plan (max_nb_plan)
+{
+}
+
+SyncPlanMng::~SyncPlanMng() {
+  clear();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Return the plan matching vars for the kind of algorithm                   */
+/*---------------------------------------------------------------------------*/
+SyncPlan* SyncPlanMng::plan(ConstArrayView<IMeshVarSync*> vars,
+    SyncPlan::ePlanKind kind) {
+
+  // La signature contient tout ce dont dépendent les buffers :
+  // [kind, nb_var, {alignOf, sizeOf, {owned_sz, ghost_sz}*nb_nei}*nb_var]
+  Integer nb_var = vars.size();
+  m_cur_signature.resize(2+nb_var*(2+2*m_nb_nei));
+
+  Integer k=0;
+  m_cur_signature[k++] = kind;
+  m_cur_signature[k++] = nb_var;
+  for(auto var : vars) {
+    auto size_infos = var->sizeInfos();
+    m_cur_signature[k++] = size_infos.alignOf;
+    m_cur_signature[k++] = size_infos.sizeOf;
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      m_cur_signature[k++] = var->sizeInBytes(IMeshVarSync::IS_owned, inei);
+      m_cur_signature[k++] = var->sizeInBytes(IMeshVarSync::IS_ghost, inei);
+    }
+  }
+
+  // Hachage FNV-1a pour écarter rapidement les plans qui ne correspondent pas
+  UInt64 uhash = 14695981039346656037ULL;
+  for(Int64 v : m_cur_signature) {
+    uhash ^= static_cast<UInt64>(v);
+    uhash *= 1099511628211ULL;
+  }
+  Int64 hash = static_cast<Int64>(uhash);
+
+  // Le dernier plan utilisé est en fin de liste
+  Integer nb_plan = m_plans.size();
+  for(Integer iplan=nb_plan-1 ; iplan>=0 ; --iplan) {
+    SyncPlan* p = m_plans[iplan];
+    if (p->matches(hash, m_cur_signature)) {
+      for(Integer j=iplan ; j<nb_plan-1 ; ++j) {
+        m_plans[j] = m_plans[j+1];
+      }
+      m_plans[nb_plan-1] = p;
+      p->incrReplay();
+      return p;
+    }
+  }
+
+  // Nouveau plan, on supprime le moins récemment utilisé si trop de plans
+  if (nb_plan>=m_max_nb_plan) {
+    delete m_plans[0];
+    m_plans.remove(0);
+  }
+  SyncPlan* p = new SyncPlan(hash, m_cur_signature);
+  m_plans.add(p);
+  return p;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Remove all the plans                                                      */
+/*---------------------------------------------------------------------------*/
+void SyncPlanMng::clear() {
+  for(auto p : m_plans) {
+    delete p;
+  }
+  m_plans.clear();
+}
+
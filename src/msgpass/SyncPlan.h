@@ -0,0 +1,115 @@
+#ifndef MSG_PASS_SYNC_PLAN_H
+#define MSG_PASS_SYNC_PLAN_H
+
+#include "msgpass/IAlgo1SyncData.h"
+#include "msgpass/SyncBuffers.h"
+
+#include <arcane/IParallelMng.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncPlan                                                           */
+/* \brief Persistent communication plan for one signature of a list of       */
+/*   variables to synchronize                                                */
+/*                                                                           */
+/* The signature gathers everything the buffer layouts depend on (sizes and  */
+/* alignments per variable and per neighbour). As long as the signature and  */
+/* the SyncBuffers sub-allocation are unchanged, the layouts and the persistent  */
+/* communication requests are replayed without any setup.                    */
+/*---------------------------------------------------------------------------*/
+class SyncPlan {
+ public:
+  //! Kind of algorithm using the plan (the comm buffers are not the same)
+  enum ePlanKind {
+    PK_algo1_dh = 0,  //! Algo1SyncDataDH : comms on Host buffers
+    PK_algo1_d        //! Algo1SyncDataD : comms on Device buffers
+  };
+
+ public:
+  SyncPlan(Int64 hash, Int64ConstArrayView signature);
+  virtual ~SyncPlan();
+
+  //! True if the plan was built for this signature
+  bool matches(Int64 hash, Int64ConstArrayView signature) const;
+
+  //! True if the buffer layouts are still valid for the sub-allocation sub_buf
+  bool isLayoutValid(SyncBuffers::SubBuf* sub_buf) const;
+
+  //! (Re)compute the buffer layouts of vars inside the sub-allocation sub_buf of sync_buffers
+  void buildLayout(ConstArrayView<IMeshVarSync*> vars, Integer nb_nei,
+      SyncBuffers* sync_buffers, SyncBuffers::SubBuf* sub_buf);
+
+  //! Buffers to send on memory imem (0=host, 1=device)
+  const MultiBufView2& bufSnd(Integer imem) const { return m_buf_snd[imem]; }
+
+  //! Buffers to receive on memory imem (0=host, 1=device)
+  const MultiBufView2& bufRcv(Integer imem) const { return m_buf_rcv[imem]; }
+
+  //! Number of times the plan has been used
+  Int64 nbReplay() const { return m_nb_replay; }
+  void incrReplay() { m_nb_replay++; }
+
+  /* Persistent requests (only with MPI) */
+
+  //! Create (if needed) the persistent requests on the buffers of sync_data, false if not possible
+  bool initPersistentRequests(IParallelMng* pm, Int32ConstArrayView neigh_ranks,
+      IAlgo1SyncData* sync_data);
+
+  //! Start all the persistent receipts
+  void startRecvs();
+
+  //! Start the persistent sending for the neighbour inei
+  void startSend(Integer inei);
+
+  //! Wait for some requests (receipts or sendings), fill done_indexes and return the number of them
+  Integer waitSome(ArrayView<Integer> done_indexes);
+
+  //! Wait for all the sendings
+  void waitSends();
+
+ protected:
+  //! Free the persistent requests (the buffers have moved)
+  void _freePersistentRequests();
+
+ protected:
+  struct PersistentRequests;  // defined where MPI is known
+
+  Int64 m_hash=0;
+  UniqueArray<Int64> m_signature;
+
+  Int64 m_buf_generation=-1;  //! SyncBuffers allocation for which the layouts were built
+  Int64 m_buf_offset=-1;  //! Position in the SyncBuffers arena of the layouts
+  Int64 m_nb_replay=0;
+
+  MultiBufView2 m_buf_snd[2];  //! Buffers to send on Host (0) and Device (1)
+  MultiBufView2 m_buf_rcv[2];  //! Buffers to recv on Host (0) and Device (1)
+
+  PersistentRequests* m_pers_req=nullptr;
+};
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncPlanMng                                                        */
+/* \brief Cache of SyncPlan, one plan per signature                          */
+/*---------------------------------------------------------------------------*/
+class SyncPlanMng {
+ public:
+  SyncPlanMng(Integer nb_nei, Integer max_nb_plan=32);
+  virtual ~SyncPlanMng();
+
+  //! Return the plan matching vars for the kind of algorithm (created if needed)
+  SyncPlan* plan(ConstArrayView<IMeshVarSync*> vars, SyncPlan::ePlanKind kind);
+
+  //! Number of plans currently cached
+  Integer nbPlan() const { return m_plans.size(); }
+
+  //! Remove all the plans
+  void clear();
+
+ protected:
+  Integer m_nb_nei=0;
+  Integer m_max_nb_plan=0;
+  UniqueArray<SyncPlan*> m_plans;  //! Last used plan at the end
+  UniqueArray<Int64> m_cur_signature;  //! To avoid allocations when computing a signature
+};
+
+#endif
+
@@ -0,0 +1,257 @@
+#include "msgpass/SyncStats.h"
+
+#include <arcane/utils/PlatformUtils.h>
+#include <arcane/utils/FatalErrorException.h>
+
+#include <fstream>
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncStats                                                          */
+/* \brief Counters and timings of the synchronizations, per call, per        */
+/*   neighbour and per variable                                              */
+/*---------------------------------------------------------------------------*/
+
+SyncStats::SyncStats(Int32ConstArrayView neigh_ranks, Int32 my_rank,
+    Integer max_nb_call_rec) :
+  m_neigh_ranks     (neigh_ranks),
+  m_my_rank         (my_rank),
+  m_max_nb_call_rec (max_nb_call_rec)
+{
+  m_nb_nei = m_neigh_ranks.size();
+  m_all_neigh.resize(m_nb_nei);
+  m_cur_neigh.resize(m_nb_nei);
+}
+
+SyncStats::~SyncStats() {
+}
+
+/*---------------------------------------------------------------------------*/
+/* Begin the record of a synchronization of vars                             */
+/*---------------------------------------------------------------------------*/
+void SyncStats::beginCall(ConstArrayView<IMeshVarSync*> vars, eVarSyncVersion vs_version) {
+  m_in_call = true;
+  m_call_beg = platform::getRealTime();
+
+  m_cur_call = CallStats();
+  m_cur_call.m_id = m_nb_call;
+  m_cur_call.m_vs_version = vs_version;
+  m_cur_call.m_nb_var = vars.size();
+  m_cur_neigh.fill(NeighStats());
+
+  m_cur_vars.resize(vars.size());
+  for(Integer ivar=0 ; ivar<vars.size() ; ++ivar) {
+    VarStats& var_stats = m_vars[vars[ivar]->name()];
+    if (var_stats.m_bytes_packed_pn.size()==0) {
+      var_stats.m_bytes_packed_pn.resize(m_nb_nei);
+      var_stats.m_bytes_packed_pn.fill(0);
+    }
+    var_stats.m_nb_call++;
+    m_cur_vars[ivar] = &var_stats;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* End the record of the current synchronization                             */
+/*---------------------------------------------------------------------------*/
+void SyncStats::endCall() {
+  if (!m_in_call) {
+    return;
+  }
+  m_in_call = false;
+  m_cur_call.m_total_time = platform::getRealTime()-m_call_beg;
+
+  m_all_call.m_total_time += m_cur_call.m_total_time;
+  m_all_call.m_wait_time += m_cur_call.m_wait_time;
+  m_all_call.m_drain_time += m_cur_call.m_drain_time;
+  m_all_call.m_nb_wait_iter += m_cur_call.m_nb_wait_iter;
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    NeighStats& all = m_all_neigh[inei];
+    const NeighStats& cur = m_cur_neigh[inei];
+    all.m_bytes_packed += cur.m_bytes_packed;
+    all.m_bytes_sent += cur.m_bytes_sent;
+    all.m_bytes_recv += cur.m_bytes_recv;
+    all.m_pack_time += cur.m_pack_time;
+    all.m_unpack_time += cur.m_unpack_time;
+  }
+
+  // Au-delà de m_max_nb_call_rec appels, seuls les totaux sont conservés
+  if (m_calls.size()<m_max_nb_call_rec) {
+    m_calls.add(m_cur_call);
+    m_calls_neigh.addRange(m_cur_neigh);
+  }
+  m_nb_call++;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Packing                                                                   */
+/*---------------------------------------------------------------------------*/
+void SyncStats::beginPack() {
+  m_pack_beg = platform::getRealTime();
+}
+
+void SyncStats::endPack(Integer inei) {
+  if (m_in_call) {
+    m_cur_neigh[inei].m_pack_time += platform::getRealTime()-m_pack_beg;
+  }
+}
+
+void SyncStats::addPacked(Integer inei, Integer ivar, Int64 nb_bytes) {
+  if (m_in_call) {
+    m_cur_neigh[inei].m_bytes_packed += nb_bytes;
+    m_cur_vars[ivar]->m_bytes_packed_pn[inei] += nb_bytes;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Communications                                                            */
+/*---------------------------------------------------------------------------*/
+void SyncStats::addSent(Integer inei, Int64 nb_bytes) {
+  if (m_in_call) {
+    m_cur_neigh[inei].m_bytes_sent += nb_bytes;
+  }
+}
+
+void SyncStats::addRecv(Integer inei, Int64 nb_bytes) {
+  if (m_in_call) {
+    m_cur_neigh[inei].m_bytes_recv += nb_bytes;
+  }
+}
+
+void SyncStats::addWaitTime(Real t, Integer nb_iter) {
+  if (m_in_call) {
+    m_cur_call.m_wait_time += t;
+    m_cur_call.m_nb_wait_iter += nb_iter;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Unpacking                                                                 */
+/*---------------------------------------------------------------------------*/
+void SyncStats::addUnpackTime(Integer inei, Real t) {
+  if (m_in_call) {
+    m_cur_neigh[inei].m_unpack_time += t;
+  }
+}
+
+void SyncStats::addDrainTime(Real t) {
+  if (m_in_call) {
+    m_cur_call.m_drain_time += t;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Write the trace into files                                                */
+/*---------------------------------------------------------------------------*/
+void SyncStats::dump(eSyncStatsFormat fmt, const String& prefix) const {
+  if (fmt == SSF_json) {
+    _dumpJson(String::format("{0}_{1}.json", prefix, m_my_rank));
+  } else if (fmt == SSF_csv) {
+    _dumpCsv(String::format("{0}_calls_{1}.csv", prefix, m_my_rank),
+        String::format("{0}_vars_{1}.csv", prefix, m_my_rank));
+  }
+}
+
+void SyncStats::_dumpJson(const String& filename) const {
+  std::ofstream ofs(filename.localstr());
+  if (!ofs) {
+    throw FatalErrorException(A_FUNCINFO, String("Impossible d'ouvrir ")+filename);
+  }
+  ofs << "{\n";
+  ofs << "  \"rank\": " << m_my_rank << ",\n";
+  ofs << "  \"nb_call\": " << m_nb_call << ",\n";
+  ofs << "  \"neighbours\": [";
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    const NeighStats& ns = m_all_neigh[inei];
+    ofs << (inei ? ",\n" : "\n") << "    {\"rank\": " << m_neigh_ranks[inei]
+      << ", \"bytes_packed\": " << ns.m_bytes_packed
+      << ", \"bytes_sent\": " << ns.m_bytes_sent
+      << ", \"bytes_recv\": " << ns.m_bytes_recv
+      << ", \"pack_time\": " << ns.m_pack_time
+      << ", \"unpack_time\": " << ns.m_unpack_time << "}";
+  }
+  ofs << "\n  ],\n";
+  ofs << "  \"variables\": [";
+  bool is_first = true;
+  for(const auto& [name, vs] : m_vars) {
+    ofs << (is_first ? "\n" : ",\n") << "    {\"name\": \"" << name
+      << "\", \"nb_call\": " << vs.m_nb_call << ", \"bytes_packed\": [";
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      ofs << (inei ? ", " : "") << vs.m_bytes_packed_pn[inei];
+    }
+    ofs << "]}";
+    is_first = false;
+  }
+  ofs << "\n  ],\n";
+  ofs << "  \"calls\": [";
+  for(Integer icall=0 ; icall<m_calls.size() ; ++icall) {
+    const CallStats& cs = m_calls[icall];
+    ofs << (icall ? ",\n" : "\n") << "    {\"id\": " << cs.m_id
+      << ", \"version\": " << cs.m_vs_version
+      << ", \"nb_var\": " << cs.m_nb_var
+      << ", \"total_time\": " << cs.m_total_time
+      << ", \"wait_time\": " << cs.m_wait_time
+      << ", \"drain_time\": " << cs.m_drain_time
+      << ", \"nb_wait_iter\": " << cs.m_nb_wait_iter
+      << ", \"neighbours\": [";
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      const NeighStats& ns = m_calls_neigh[icall*m_nb_nei+inei];
+      ofs << (inei ? ", " : "") << "[" << ns.m_bytes_packed << ", " << ns.m_bytes_sent
+        << ", " << ns.m_bytes_recv << ", " << ns.m_pack_time << ", " << ns.m_unpack_time << "]";
+    }
+    ofs << "]}";
+  }
+  ofs << "\n  ],\n";
+  ofs << "  \"call_neighbour_fields\": [\"bytes_packed\", \"bytes_sent\", \"bytes_recv\", \"pack_time\", \"unpack_time\"]\n";
+  ofs << "}\n";
+}
+
+void SyncStats::_dumpCsv(const String& calls_filename, const String& vars_filename) const {
+  std::ofstream ofs(calls_filename.localstr());
+  if (!ofs) {
+    throw FatalErrorException(A_FUNCINFO, String("Impossible d'ouvrir ")+calls_filename);
+  }
+  // Une ligne par appel et par voisin
+  ofs << "call;version;nb_var;total_time;wait_time;drain_time;nb_wait_iter;"
+    << "neigh_rank;bytes_packed;bytes_sent;bytes_recv;pack_time;unpack_time\n";
+  for(Integer icall=0 ; icall<m_calls.size() ; ++icall) {
+    const CallStats& cs = m_calls[icall];
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      const NeighStats& ns = m_calls_neigh[icall*m_nb_nei+inei];
+      ofs << cs.m_id << ";" << cs.m_vs_version << ";" << cs.m_nb_var << ";"
+        << cs.m_total_time << ";" << cs.m_wait_time << ";" << cs.m_drain_time << ";"
+        << cs.m_nb_wait_iter << ";" << m_neigh_ranks[inei] << ";"
+        << ns.m_bytes_packed << ";" << ns.m_bytes_sent << ";" << ns.m_bytes_recv << ";"
+        << ns.m_pack_time << ";" << ns.m_unpack_time << "\n";
+    }
+  }
+
+  std::ofstream ofs_vars(vars_filename.localstr());
+  if (!ofs_vars) {
+    throw FatalErrorException(A_FUNCINFO, String("Impossible d'ouvrir ")+vars_filename);
+  }
+  // Une ligne par variable et par voisin
+  ofs_vars << "name;nb_call;neigh_rank;bytes_packed\n";
+  for(const auto& [name, vs] : m_vars) {
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      ofs_vars << name << ";" << vs.m_nb_call << ";" << m_neigh_ranks[inei] << ";"
+        << vs.m_bytes_packed_pn[inei] << "\n";
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Short summary per neighbour                                               */
+/*---------------------------------------------------------------------------*/
+void SyncStats::print(ITraceMng* tm) const {
+  tm->info() << "Synchros : " << m_nb_call << " appels, temps total=" << m_all_call.m_total_time
+    << " s, attente comms=" << m_all_call.m_wait_time
+    << " s (" << m_all_call.m_nb_wait_iter << " iterations), attente unpack="
+    << m_all_call.m_drain_time << " s";
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    const NeighStats& ns = m_all_neigh[inei];
+    tm->info() << "  voisin " << m_neigh_ranks[inei]
+      << " : envoyes=" << ns.m_bytes_sent << " o, recus<=" << ns.m_bytes_recv
+      << " o, pack=" << ns.m_pack_time << " s, unpack=" << ns.m_unpack_time << " s";
+  }
+}
+
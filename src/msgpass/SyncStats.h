@@ -0,0 +1,115 @@
+#ifndef MSG_PASS_SYNC_STATS_H
+#define MSG_PASS_SYNC_STATS_H
+
+#include "msgpass/MeshVariableSynchronizerList.h"
+#include "msgpass/VarSyncMngOptions.h"
+
+#include <arcane/utils/ITraceMng.h>
+
+#include <map>
+
+/*---------------------------------------------------------------------------*/
+/* \class SyncStats                                                          */
+/* \brief Counters and timings of the synchronizations, per call, per        */
+/*   neighbour and per variable                                              */
+/*                                                                           */
+/* Times are host wall-clock times (s) : the pack time of a neighbour goes   */
+/* from the beginning of the packing to the moment its buffer is ready to be */
+/* sent, the unpack time is the host time spent to launch the unpacking of a */
+/* neighbour, the drain time is the time spent waiting for all the unpacks.  */
+/*---------------------------------------------------------------------------*/
+class SyncStats {
+ public:
+  SyncStats(Int32ConstArrayView neigh_ranks, Int32 my_rank,
+      Integer max_nb_call_rec=100000);
+  virtual ~SyncStats();
+
+  /* Collection */
+
+  //! Begin the record of a synchronization of vars
+  void beginCall(ConstArrayView<IMeshVarSync*> vars, eVarSyncVersion vs_version);
+
+  //! End the record of the current synchronization
+  void endCall();
+
+  //! Begin of the packing for all neighbours
+  void beginPack();
+
+  //! The buffer of the neighbour inei is ready to be sent
+  void endPack(Integer inei);
+
+  //! nb_bytes of the variable ivar have been packed for the neighbour inei
+  void addPacked(Integer inei, Integer ivar, Int64 nb_bytes);
+
+  //! nb_bytes sent to / received from the neighbour inei
+  void addSent(Integer inei, Int64 nb_bytes);
+  void addRecv(Integer inei, Int64 nb_bytes);
+
+  //! Host time spent to unpack the message of the neighbour inei
+  void addUnpackTime(Integer inei, Real t);
+
+  //! Time spent waiting for the end of all the unpacks
+  void addDrainTime(Real t);
+
+  //! Time spent waiting for comm requests and number of wait iterations
+  void addWaitTime(Real t, Integer nb_iter=0);
+
+  /* Output */
+
+  //! Write the trace into <prefix>_<rank>.json or <prefix>_{calls,vars}_<rank>.csv
+  void dump(eSyncStatsFormat fmt, const String& prefix) const;
+
+  //! Short summary per neighbour
+  void print(ITraceMng* tm) const;
+
+ protected:
+  void _dumpJson(const String& filename) const;
+  void _dumpCsv(const String& calls_filename, const String& vars_filename) const;
+
+ protected:
+  struct NeighStats {
+    Int64 m_bytes_packed=0;
+    Int64 m_bytes_sent=0;
+    Int64 m_bytes_recv=0;
+    Real m_pack_time=0;
+    Real m_unpack_time=0;
+  };
+  struct CallStats {
+    Int64 m_id=0;
+    Integer m_vs_version=0;
+    Integer m_nb_var=0;
+    Real m_total_time=0;
+    Real m_wait_time=0;
+    Real m_drain_time=0;
+    Integer m_nb_wait_iter=0;
+  };
+  struct VarStats {
+    Int64 m_nb_call=0;
+    UniqueArray<Int64> m_bytes_packed_pn;  //! Bytes packed per neighbour
+  };
+
+  UniqueArray<Int32> m_neigh_ranks;
+  Int32 m_my_rank=0;
+  Integer m_nb_nei=0;
+  Integer m_max_nb_call_rec=0;  //! Beyond, calls are only accumulated into totals
+
+  Int64 m_nb_call=0;
+  UniqueArray<CallStats> m_calls;  //! Recorded calls
+  UniqueArray<NeighStats> m_calls_neigh;  //! nb_nei records per recorded call
+  std::map<String, VarStats> m_vars;
+
+  // Totaux sur tous les appels
+  CallStats m_all_call;
+  UniqueArray<NeighStats> m_all_neigh;
+
+  // Appel en cours
+  bool m_in_call=false;
+  Real m_call_beg=0;
+  Real m_pack_beg=0;
+  CallStats m_cur_call;
+  UniqueArray<NeighStats> m_cur_neigh;
+  UniqueArray<VarStats*> m_cur_vars;  //! VarStats of the variables of the current call
+};
+
+#endif
+
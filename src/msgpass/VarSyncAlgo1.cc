@@ -2,6 +2,7 @@
 
 #include <arcane/IParallelMng.h>
 #include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/PlatformUtils.h>
 #include <arccore/base/FatalErrorException.h>
 
 /*---------------------------------------------------------------------------*/
@@ -14,15 +15,38 @@ VarSyncAlgo1::VarSyncAlgo1(IParallelMng* pm, Int32ConstArrayView neigh_ranks) :
   m_neigh_ranks (neigh_ranks)
 {
   m_nb_nei = m_neigh_ranks.size();
+
+  m_done_indexes.resize(2*m_nb_nei);
+
+  m_pm_transport = new PmMsgPassTransport(m_pm, 2*m_nb_nei);
+  m_transport = m_pm_transport;
 }
 
 VarSyncAlgo1::~VarSyncAlgo1() {
+  delete m_sim_transport;
+  delete m_pm_transport;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Emulate a network with latency (s) and bandwidth (bytes/s, <=0 infinite)  */
+/*---------------------------------------------------------------------------*/
+void VarSyncAlgo1::setSimulatedNetwork(Real latency, Real bandwidth) {
+  delete m_sim_transport;
+  m_sim_transport = new SimMsgPassTransport(m_pm_transport, latency, bandwidth);
+  m_transport = m_sim_transport;
+}
+
+/*---------------------------------------------------------------------------*/
+/* True if the exchanges go through a simulated network                      */
+/*---------------------------------------------------------------------------*/
+bool VarSyncAlgo1::isSimulatedNetwork() const {
+  return m_sim_transport!=nullptr;
 }
 
 /*---------------------------------------------------------------------------*/
 /* Synchronize variables encapsulated into sync_data                         */
 /*---------------------------------------------------------------------------*/
-void VarSyncAlgo1::synchronize(IAlgo1SyncData* sync_data)
+void VarSyncAlgo1::synchronize(IAlgo1SyncData* sync_data, SyncPlan* plan)
 {
   if (m_nb_nei==0 || sync_data->isEmpty()) {
     sync_data->finalizeWoComm();
@@ -32,9 +56,19 @@ void VarSyncAlgo1::synchronize(IAlgo1SyncData* sync_data)
   // Step before the first communications
   sync_data->initComm();
 
+  // Si possible, on rejoue les requêtes persistantes du plan
+  // (pas avec un réseau simulé car elles ne passent pas par m_transport)
+  if (plan && !isSimulatedNetwork() && 
+      plan->initPersistentRequests(m_pm, m_neigh_ranks, sync_data)) {
+    _synchronizeWithPlan(sync_data, plan);
+    return;
+  }
+
   // L'échange proprement dit des valeurs de var
-  UniqueArray<Parallel::Request> requests(2*m_nb_nei);
-  IntegerUniqueArray msg_types(2*m_nb_nei); // nature des messages 
+  // Indices des requêtes dans [0,m_nb_nei[ : réceptions, dans [m_nb_nei,2*m_nb_nei[ : envois
+  if (m_transport->nbPending()!=0) {
+    throw FatalErrorException(A_FUNCINFO, "Des requetes d'un echange precedent sont encore en cours");
+  }
 
   // On amorce les réceptions
   for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
@@ -42,8 +76,10 @@ void VarSyncAlgo1::synchronize(IAlgo1SyncData* sync_data)
 
     // On amorce la réception sur l'HOTE
     auto byte_buf_rcv = sync_data->recvBuf(inei); // le buffer de réception pour inei
-    requests[inei] = m_pm->recv(byte_buf_rcv, rank_nei, /*blocking=*/false);
-    msg_types[inei] = inei+1; // >0 pour la réception
+    m_transport->postRecv(inei, byte_buf_rcv, rank_nei);
+    if (m_stats) {
+      m_stats->addRecv(inei, byte_buf_rcv.size());
+    }
   }
 
   sync_data->initSendings();
@@ -56,104 +92,115 @@ void VarSyncAlgo1::synchronize(IAlgo1SyncData* sync_data)
 
     // On amorce l'envoi
     auto byte_buf_snd = sync_data->sendBuf(inei); // le buffer d'envoi pour inei
-    requests[m_nb_nei+inei] = m_pm->send(byte_buf_snd, rank_nei, /*blocking=*/false);
-    msg_types[m_nb_nei+inei] = -inei-1; // <0 pour l'envoi
+    m_transport->postSend(m_nb_nei+inei, byte_buf_snd, rank_nei);
+    if (m_stats) {
+      m_stats->addSent(inei, byte_buf_snd.size());
+    }
   }
 
   sync_data->finalizeSendings();
 
   // Maitenant que toutes les requêtes de comms sont amorcées, il faut les terminer
-  if (2*m_nb_nei!=requests.size()) {
-    throw FatalErrorException(A_FUNCINFO, "Le nb de requetes n'est pas egal à 2 fois le nb de voisins");
-  }
-
-  UniqueArray<Parallel::Request> requests2(2*m_nb_nei);
-  IntegerUniqueArray msg_types2(2*m_nb_nei); 
-  UniqueArray<bool> is_done_req(2*m_nb_nei);
-
-  // On utilise des vues pour éviter de réallouer en permanence des tableaux
-  ArrayView<Parallel::Request> pending_requests(requests.view());
-  ArrayView<Integer> pending_types(msg_types.view());
-
-  ArrayView<Parallel::Request> upd_pending_requests(requests2.view());
-  ArrayView<Integer> upd_pending_types(msg_types2.view());
-
-  ArrayView<Parallel::Request> tmp_pending_requests;
-  ArrayView<Integer> tmp_pending_types;
-
-  Integer nb_iter_wait_some = 0;
   Integer nb_pending_rcv = m_nb_nei;
-
   while(nb_pending_rcv>0) {
 
-    Integer nb_pending_req = pending_requests.size();
-
-    // On dimenensionne is_done_requests au nb de requêtes d'avant waitSomeRequests
-    // et on initialise à false
-    ArrayView<bool> is_done_requests(is_done_req.subView(0, nb_pending_req));
-    for(Integer ireq=0 ; ireq<nb_pending_req ; ++ireq) {
-      is_done_requests[ireq]=false;
-    }
-
     // Attente de quelques requetes
-    IntegerUniqueArray done_indexes = m_pm->waitSomeRequests(pending_requests);
+    Real wait_beg = platform::getRealTime();
+    Integer nb_done = m_transport->waitSome(m_done_indexes);
+    if (m_stats) {
+      m_stats->addWaitTime(platform::getRealTime()-wait_beg, 1);
+    }
+    if (nb_done==0) {
+      throw FatalErrorException(A_FUNCINFO, "Plus de requete en cours alors que des receptions sont attendues");
+    }
 
-    for(Integer idone_req : done_indexes) {
-      if (pending_types[idone_req] > 0) { // >0 signifie que c'est une requête de reception
+    for(Integer i=0 ; i<nb_done ; ++i) {
+      Integer ireq = m_done_indexes[i];
+      if (ireq<m_nb_nei) { // requête de reception
 
         nb_pending_rcv--; // on a une requete de reception en moins
 
-        // On récupère l'indice du voisin
-        Integer inei = pending_types[idone_req]-1;
-        if (!(inei>=0 && inei<m_nb_nei)) {
-          throw FatalErrorException(A_FUNCINFO, "Mauvais indice de voisin");
-        }
-
-        // Maintenant qu'on a reçu le buffer pour le inei-ième voisin, 
+        // Maintenant qu'on a reçu le buffer pour le ireq-ième voisin, 
         // on post-traite les données reçues
-        sync_data->unpackAfterRecv(inei);
-      }
-      is_done_requests[idone_req] = true;
-    }
-    // Il faut créer le nouveau tableau de requêtes pending dans upd_*
-    Integer upd_nb_pending_req=0;
-    for(Integer ireq=0 ; ireq<nb_pending_req ; ++ireq) {
-      if (!is_done_requests[ireq]) {
-        upd_pending_requests[upd_nb_pending_req]=pending_requests[ireq];
-        upd_pending_types   [upd_nb_pending_req]=pending_types[ireq];
-        upd_nb_pending_req++;
+        sync_data->unpackAfterRecv(ireq);
       }
     }
-
-    // On échange les vues pour qu'à l'itération suivante 
-    // pending_requests pointe vers upd_pending_types
-    tmp_pending_requests = upd_pending_requests.subView(0, upd_nb_pending_req);
-    upd_pending_requests = pending_requests;
-    pending_requests = tmp_pending_requests;
-
-    tmp_pending_types = upd_pending_types.subView(0, upd_nb_pending_req);
-    upd_pending_types = pending_types;
-    pending_types = tmp_pending_types;
-
-    nb_iter_wait_some++;
   }
 
   // Ici, toutes les requetes de receptions sont forcement terminées 
   // (condition de la boucle while précédente)
   // Mais il peut rester encore des requetes d'envoi en cours
-  if (pending_requests.size()) {
+  if (m_transport->nbPending()) {
     // Normalement, il ne reste que des requêtes d'envois
-    if (!(pending_requests.size()<=m_nb_nei)) {
+    if (!(m_transport->nbPending()<=m_nb_nei)) {
       throw FatalErrorException(A_FUNCINFO,
           "Il ne peut pas rester un nb de requetes d'envoi supérieur au nb de voisins");
     }
-    for(Integer msg_type : pending_types) {
-      if (!(msg_type<0)) {
-        throw FatalErrorException(A_FUNCINFO, 
-            "Un message d'envoi doit avoir un type négatif ce qui n'est pas le cas");
+    Real wait_beg = platform::getRealTime();
+    m_transport->waitAll();
+    if (m_stats) {
+      m_stats->addWaitTime(platform::getRealTime()-wait_beg);
+    }
+  }
+
+  sync_data->finalizeReceipts();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Exchange with the persistent requests of plan                             */
+/* The buffers (and so the requests) are the ones of the previous calls,     */
+/* only start/wait remain on the hot path                                    */
+/*---------------------------------------------------------------------------*/
+void VarSyncAlgo1::_synchronizeWithPlan(IAlgo1SyncData* sync_data, SyncPlan* plan)
+{
+  // On amorce toutes les réceptions
+  plan->startRecvs();
+  if (m_stats) {
+    for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+      m_stats->addRecv(inei, sync_data->recvBuf(inei).size());
+    }
+  }
+
+  sync_data->initSendings();
+
+  // On amorce les envois dès qu'un buffer est prêt
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    sync_data->finalizePackBeforeSend(inei);
+    plan->startSend(inei);
+    if (m_stats) {
+      m_stats->addSent(inei, sync_data->sendBuf(inei).size());
+    }
+  }
+
+  sync_data->finalizeSendings();
+
+  // Indices dans [0,m_nb_nei[ : réceptions, dans [m_nb_nei,2*m_nb_nei[ : envois
+  Integer nb_pending_rcv = m_nb_nei;
+  while(nb_pending_rcv>0) {
+    Real wait_beg = platform::getRealTime();
+    Integer nb_done = plan->waitSome(m_done_indexes);
+    if (m_stats) {
+      m_stats->addWaitTime(platform::getRealTime()-wait_beg, 1);
+    }
+    if (nb_done==0) {
+      throw FatalErrorException(A_FUNCINFO, "Plus de requete active alors que des receptions sont attendues");
+    }
+    for(Integer i=0 ; i<nb_done ; ++i) {
+      Integer ireq = m_done_indexes[i];
+      if (ireq<m_nb_nei) {
+        nb_pending_rcv--;
+        // Maintenant qu'on a reçu le buffer pour le ireq-ième voisin,
+        // on post-traite les données reçues
+        sync_data->unpackAfterRecv(ireq);
       }
     }
-    m_pm->waitAllRequests(pending_requests);
+  }
+
+  // Il peut rester des envois en cours
+  Real wait_beg = platform::getRealTime();
+  plan->waitSends();
+  if (m_stats) {
+    m_stats->addWaitTime(platform::getRealTime()-wait_beg);
   }
 
   sync_data->finalizeReceipts();
@@ -2,6 +2,10 @@
 #define MSG_PASS_VAR_SYNC_ALGO1_H
 
 #include "msgpass/IAlgo1SyncData.h"
+#include "msgpass/SyncPlan.h"
+#include "msgpass/SyncStats.h"
+#include "msgpass/PmMsgPassTransport.h"
+#include "msgpass/SimMsgPassTransport.h"
 
 #include <arcane/IParallelMng.h>
 
@@ -15,11 +19,32 @@ class VarSyncAlgo1 {
   virtual ~VarSyncAlgo1();
 
   //! Synchronize variables encapsulated into sync_data
-  void synchronize(IAlgo1SyncData* sync_data);
+  //! If plan is not null, its persistent requests are replayed when possible
+  void synchronize(IAlgo1SyncData* sync_data, SyncPlan* plan=nullptr);
+
+  //! If not null, the sizes and wait times are recorded into stats
+  void setSyncStats(SyncStats* stats) { m_stats = stats; }
+
+  //! Emulate a network with latency (s) and bandwidth (bytes/s, <=0 infinite)
+  void setSimulatedNetwork(Real latency, Real bandwidth);
+
+  //! True if the exchanges go through a simulated network
+  bool isSimulatedNetwork() const;
+ protected:
+  //! Exchange with the persistent requests of plan
+  void _synchronizeWithPlan(IAlgo1SyncData* sync_data, SyncPlan* plan);
  protected:
   IParallelMng* m_pm=nullptr;  //! To perform send/recv
   Int32ConstArrayView m_neigh_ranks;  //! List of neighbour ranks
   Integer m_nb_nei;  //! Number of neighbours (m_neigh_ranks.size())
+  SyncStats* m_stats=nullptr;  //! Statistics (not owned)
+
+  PmMsgPassTransport* m_pm_transport=nullptr;  //! Exchanges by m_pm
+  SimMsgPassTransport* m_sim_transport=nullptr;  //! Simulated network on top of m_pm_transport
+  IMsgPassTransport* m_transport=nullptr;  //! Transport used (one of the above)
+
+  // Allocated once to avoid allocations at each synchronization
+  IntegerUniqueArray m_done_indexes;  //! Indexes of completed requests
 };
 
 #endif
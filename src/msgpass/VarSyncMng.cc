@@ -5,6 +5,9 @@
 #include <arcane/IItemFamily.h>
 #include <arcane/IParallelMng.h>
 #include <arcane/utils/NotSupportedException.h>
+#include <arcane/utils/Real3x3.h>
+
+#include <algorithm>
 
 // Définie ailleurs
 bool is_comm_device_aware();
@@ -59,6 +62,14 @@ VarSyncMng::VarSyncMng(IMesh* mesh, ax::Runner& runner, AccMemAdviser* acc_mem_a
     new Algo1SyncDataDH::PersistentInfo(m_nb_nei, m_runner, m_sync_buffers);
   m_a1_d_pi = 
     new Algo1SyncDataD::PersistentInfo(m_is_device_aware, m_nb_nei, m_runner, m_sync_buffers);
+  m_sync_plan_mng = new SyncPlanMng(m_nb_nei);
+
+  // Pour synchro par collective de voisinage (construction collective du communicateur de graphe)
+  m_vsync_neighcoll = new VarSyncNeighColl(m_pm, m_neigh_ranks);
+
+  // Pour VS_autotune, seules les versions disponibles partout sont candidates
+  m_vsync_tuner = new VarSyncTuner(m_pm, m_mesh->traceMng(),
+      m_is_device_aware, m_vsync_neighcoll->isAvailable());
 }
 
 VarSyncMng::~VarSyncMng() {
@@ -78,6 +89,15 @@ VarSyncMng::~VarSyncMng() {
   delete m_vsync_algo1;
   delete m_a1_dh_pi;
   delete m_a1_d_pi;
+  delete m_sync_plan_mng;
+  delete m_vsync_neighcoll;
+  delete m_vsync_neigh_threads;
+  delete m_sync_stats;
+  delete m_vsync_tuner;
+  delete m_host_worker;
+
+  delete m_batch_vars;
+  delete m_batch_buf_addr_mng;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -107,6 +127,16 @@ void VarSyncMng::initSyncMultiEnv(IMeshMaterialMng* mesh_material_mng) {
   if (!m_buf_addr_mng) {
     m_buf_addr_mng = new BufAddrMng(m_runner, m_mesh_material_mng);
   }
+
+  // Le lot de synchros différées a ses propres adresses multi-mat
+  if (!m_batch_buf_addr_mng) {
+    m_batch_buf_addr_mng = new BufAddrMng(m_runner, m_mesh_material_mng);
+    if (m_batch_vars && m_batch_vars->varsList().size()==0) {
+      // le lot a été créé sans BufAddrMng, il sera recréé avec
+      delete m_batch_vars;
+      m_batch_vars = nullptr;
+    }
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -198,23 +228,22 @@ SyncItems<Node>* VarSyncMng::getSyncItems() {
 
 /*---------------------------------------------------------------------------*/
 /* Effectue une première allocation des buffers pour les communications      */
-/* Ceci est une pré-allocation pour miniser le nb de réallocations           */
+/* L'arène grandit ensuite par classes de taille jusqu'à la plus forte       */
+/* demande, il suffit donc de la dimensionner pour la synchro d'une variable */
+/* du plus gros type supporté (Real3x3) sur le type d'item le plus échangé   */
 /*---------------------------------------------------------------------------*/
 void VarSyncMng::_preAllocBuffers() {
-  auto sync_items = getSyncItems<Cell>();
-  
-  auto nb_owned_item_idx_pn = sync_items->nbOwnedItemIdxPn();
-  auto nb_ghost_item_idx_pn = sync_items->nbGhostItemIdxPn();
-
-  // Alloue pour un buffer de 24 Real3 par maille
-  Integer degree = 24;
-
-  m_sync_buffers->resetBuf();
-  // On prévoit une taille max du buffer qui va contenir tous les messages
-  m_sync_buffers->addEstimatedMaxSz<Real3>(nb_owned_item_idx_pn, degree);
-  m_sync_buffers->addEstimatedMaxSz<Real3>(nb_ghost_item_idx_pn, degree);
-  // Le buffer de tous les messages est réalloué si pas assez de place
-  m_sync_buffers->allocIfNeeded();
+  Int64 buf_estim_sz = 0;
+  auto add_estim = [&buf_estim_sz](auto sync_items) {
+    buf_estim_sz = std::max(buf_estim_sz,
+        SyncBuffers::estimatedMaxBufSz<Real3x3>(sync_items->nbOwnedItemIdxPn(), /*degree=*/1) +
+        SyncBuffers::estimatedMaxBufSz<Real3x3>(sync_items->nbGhostItemIdxPn(), /*degree=*/1));
+  };
+  add_estim(getSyncItems<Cell>());
+  add_estim(getSyncItems<Face>());
+  add_estim(getSyncItems<Node>());
+
+  m_sync_buffers->reserve(buf_estim_sz);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -227,10 +256,144 @@ void VarSyncMng::multiMatSynchronize(MeshVariableSynchronizerList& vars,
 }
 
 /*---------------------------------------------------------------------------*/
-/* Maj des mailles fantômes d'une liste de variables (pour l'instant globales) */
+/* Ajoute les variables de vars au lot de synchronisations différées         */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::enqueueSynchronize(MeshVariableSynchronizerList& vars)
+{
+  if (!m_batch_vars) {
+    m_batch_vars = new MeshVariableSynchronizerList(this, m_batch_buf_addr_mng);
+  }
+  // Les variables sont copiées, vars peut être détruite avant le flush
+  m_batch_vars->append(vars);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Nb de variables en attente de synchronisation                             */
+/*---------------------------------------------------------------------------*/
+Integer VarSyncMng::nbPendingSync() const
+{
+  return (m_batch_vars ? m_batch_vars->varsList().size() : 0);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Synchronise en un seul échange toutes les variables en attente            */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::flush(Ref<RunQueue> ref_queue, eVarSyncVersion vs_version)
+{
+  if (nbPendingSync()==0) {
+    return;
+  }
+  _synchronize(*m_batch_vars, ref_queue, vs_version);
+  m_batch_vars->clear();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Affiche les taux de compression des buffers de comms                      */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::printBufCompressionStats(ITraceMng* tm) const {
+  if (m_a1_dh_pi) {
+    m_a1_dh_pi->bufCompressionStats().print(tm);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Emule un réseau de latence et de débit donnés                             */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::setSimulatedNetwork(Real latency, Real bandwidth) {
+  m_vsync_algo1->setSimulatedNetwork(latency, bandwidth);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Nb d'appels chronométrés par version candidate pour VS_autotune           */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::setAutoTuneNbTrials(Integer nb_trials) {
+  m_vsync_tuner->setNbTrials(nb_trials);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Réduit l'arène des buffers de comms après nb_calls synchros dont la       */
+/* demande reste dans une classe de taille inférieure (0 : jamais)           */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::setSyncBufShrinkPolicy(Integer nb_calls) {
+  m_sync_buffers->setShrinkPolicy(nb_calls);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Echanges point à point des versions algo1 par nb_thread threads de        */
+/* progression, chacun packant/envoyant/recevant/dépackant ses voisins       */
+/* Collectif : MPI_THREAD_MULTIPLE est le même sur tous les rangs            */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::setNeighProgressThreads(Integer nb_thread) {
+  delete m_vsync_neigh_threads;
+  m_vsync_neigh_threads = nullptr;
+  if (nb_thread<=0) {
+    return;
+  }
+  m_vsync_neigh_threads = new VarSyncNeighThreads(m_pm, m_neigh_ranks, m_neigh_queues, nb_thread);
+  if (!m_vsync_neigh_threads->isAvailable()) {
+    m_mesh->traceMng()->warning() << "Threads de progression par voisin indisponibles"
+      << " (MPI_THREAD_MULTIPLE et IParallelMng MPI requis), échanges sur le thread appelant";
+    delete m_vsync_neigh_threads;
+    m_vsync_neigh_threads = nullptr;
+    return;
+  }
+  m_vsync_neigh_threads->setSyncStats(m_sync_stats);
+}
+
+/*---------------------------------------------------------------------------*/
+/* Active la collecte des statistiques par appel, voisin et variable         */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::enableSyncStats(eSyncStatsFormat fmt, const String& prefix) {
+  m_sync_stats_fmt = fmt;
+  m_sync_stats_prefix = prefix;
+  if (fmt == SSF_none || m_sync_stats) {
+    return;
+  }
+  m_sync_stats = new SyncStats(m_neigh_ranks, m_pm->commRank());
+  m_vsync_algo1->setSyncStats(m_sync_stats);
+  m_a1_dh_pi->setSyncStats(m_sync_stats);
+  m_a1_d_pi->setSyncStats(m_sync_stats);
+  if (m_vsync_neigh_threads) {
+    m_vsync_neigh_threads->setSyncStats(m_sync_stats);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Ecrit la trace des statistiques et en affiche un résumé                   */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::dumpSyncStats(ITraceMng* tm) const {
+  if (m_sync_stats) {
+    m_sync_stats->print(tm);
+    m_sync_stats->dump(m_sync_stats_fmt, m_sync_stats_prefix);
+    tm->info() << "Arène des buffers de comms : capacité=" << m_sync_buffers->capacity()
+      << " octets, high-water mark=" << m_sync_buffers->highWaterMark()
+      << " octets, nb réallocations=" << m_sync_buffers->allocGeneration()
+      << ", nb débordements=" << m_sync_buffers->nbOverflow();
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Maj des mailles fantômes d'une liste de variables                         */
+/* S'il y a des synchros différées en attente, elles partent avec vars       */
 /*---------------------------------------------------------------------------*/
 void VarSyncMng::synchronize(MeshVariableSynchronizerList& vars, 
     Ref<RunQueue> ref_queue, eVarSyncVersion vs_version)
+{
+  if (nbPendingSync()>0 && &vars!=m_batch_vars) {
+    // Les valeurs des variables en attente sont à jour, on regroupe tout
+    // dans un seul échange par voisin
+    m_batch_vars->append(vars);
+    flush(ref_queue, vs_version);
+  } else {
+    _synchronize(vars, ref_queue, vs_version);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Maj immédiate des mailles fantômes d'une liste de variables               */
+/*---------------------------------------------------------------------------*/
+void VarSyncMng::_synchronize(MeshVariableSynchronizerList& vars, 
+    Ref<RunQueue> ref_queue, eVarSyncVersion vs_version)
 {
   PROF_ACC_BEGIN(__FUNCTION__);
 
@@ -238,6 +401,15 @@ void VarSyncMng::synchronize(MeshVariableSynchronizerList& vars,
     vs_version = defaultVarSyncVersion();
   }
 
+  if (vs_version == VS_autotune) {
+    // La version est choisie après chronométrage des versions candidates
+    VarSyncTuner::Trial trial = m_vsync_tuner->beginTrial(vars.varsList(), VarSyncTuner::OK_sync);
+    _synchronize(vars, ref_queue, trial.m_version);
+    m_vsync_tuner->endTrial(trial);
+    PROF_ACC_END;
+    return;
+  }
+
   if (vs_version == VS_bulksync_std)
   {
     // On va construire autant de liste de variables qu'il y a de types d'items
@@ -270,24 +442,69 @@ void VarSyncMng::synchronize(MeshVariableSynchronizerList& vars,
   }
   else
   {
-    IAlgo1SyncData* sync_data=nullptr;
-    if (vs_version==VS_bulksync_evqueue || vs_version==VS_overlap_evqueue) 
+    // Le plan (buffers + requêtes persistantes) est retrouvé à partir de
+    // la signature de la liste de variables, rien n'est alloué ici
+    auto lvars = vars.varsList();
+    // Les messages compressés ont une taille variable : pas de requêtes
+    // persistantes ni de MPI_Neighbor_alltoallv dont les tailles sont figées
+    bool has_cmp = vars.hasBufCompression();
+    if (m_sync_stats) {
+      m_sync_stats->beginCall(lvars, vs_version);
+    }
+    if (vs_version==VS_bulksync_evqueue || vs_version==VS_overlap_evqueue ||
+        vs_version==VS_overlap_host) 
     {
-      sync_data = new Algo1SyncDataDH(vars, ref_queue, *m_a1_dh_pi);
+      SyncPlan* plan = m_sync_plan_mng->plan(lvars, SyncPlan::PK_algo1_dh);
+      Algo1SyncDataDH sync_data(vars, ref_queue, *m_a1_dh_pi, plan);
+      if (_useNeighProgressThreads(has_cmp)) {
+        m_vsync_neigh_threads->synchronize(&sync_data);
+      } else {
+        m_vsync_algo1->synchronize(&sync_data, (has_cmp ? nullptr : plan));
+      }
     } 
     else if (vs_version==VS_bulksync_evqueue_d || vs_version==VS_overlap_evqueue_d) 
     {
-      sync_data = new Algo1SyncDataD(vars, ref_queue, *m_a1_d_pi);
+      SyncPlan* plan = m_sync_plan_mng->plan(lvars, SyncPlan::PK_algo1_d);
+      Algo1SyncDataD sync_data(vars, ref_queue, *m_a1_d_pi, plan);
+      if (_useNeighProgressThreads(has_cmp)) {
+        m_vsync_neigh_threads->synchronize(&sync_data);
+      } else {
+        m_vsync_algo1->synchronize(&sync_data, plan);
+      }
+    } 
+    else if (vs_version==VS_bulksync_neighcoll || vs_version==VS_overlap_neighcoll) 
+    {
+      SyncPlan* plan = m_sync_plan_mng->plan(lvars, SyncPlan::PK_algo1_dh);
+      Algo1SyncDataDH sync_data(vars, ref_queue, *m_a1_dh_pi, plan);
+      if (m_vsync_neighcoll->isAvailable() && !has_cmp &&
+          !m_vsync_algo1->isSimulatedNetwork()) {
+        m_vsync_neighcoll->synchronize(&sync_data);
+      } else {
+        // Sans MPI (séquentiel, threads), échanges point à point par IParallelMng
+        m_vsync_algo1->synchronize(&sync_data, (has_cmp ? nullptr : plan));
+      }
     } 
     else 
     {
       throw NotSupportedException(A_FUNCINFO, 
 	  String::format("Invalid eVarSyncVersion for this method ={0}",(int)vs_version));
     }
-    m_vsync_algo1->synchronize(sync_data);
-    delete sync_data;
+    if (m_sync_stats) {
+      m_sync_stats->endCall();
+    }
   }
   
   PROF_ACC_END;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Thread de calcul des items intérieurs pour VS_overlap_host                */
+/* Les comms restent sur le thread appelant (MPI_THREAD_FUNNELED suffit)     */
+/*---------------------------------------------------------------------------*/
+HostWorkerThread* VarSyncMng::_hostWorker() {
+  if (!m_host_worker) {
+    m_host_worker = new HostWorkerThread();
+  }
+  return m_host_worker;
+}
+
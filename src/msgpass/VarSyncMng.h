@@ -15,8 +15,14 @@
 #include "msgpass/VarSyncMngOptions.h"
 #include "msgpass/MeshVariableSynchronizerList.h"
 #include "msgpass/VarSyncAlgo1.h"
+#include "msgpass/VarSyncNeighColl.h"
+#include "msgpass/VarSyncNeighThreads.h"
 #include "msgpass/Algo1SyncDataDH.h"
 #include "msgpass/Algo1SyncDataD.h"
+#include "msgpass/SyncPlan.h"
+#include "msgpass/SyncStats.h"
+#include "msgpass/VarSyncTuner.h"
+#include "msgpass/HostWorkerThread.h"
 
 using namespace Arcane;
 using namespace Arcane::Materials;
@@ -58,12 +64,54 @@ class VarSyncMng {
   SyncItems<ItemType>* getSyncItems();
 
   // Synchronise les éléments fantômes sur une liste de variables
+  // (les synchros différées en attente partent dans le même échange)
   void synchronize(MeshVariableSynchronizerList& vars, 
     Ref<RunQueue> ref_queue, eVarSyncVersion vs_version=VS_auto);
 
+  /* Synchronisations différées */
+
+  //! Ajoute les variables de vars au lot de synchronisations différées
+  // Les valeurs "owned" des variables doivent être à jour
+  void enqueueSynchronize(MeshVariableSynchronizerList& vars);
+
+  //! Nb de variables en attente de synchronisation
+  Integer nbPendingSync() const;
+
+  //! Synchronise en un seul échange toutes les variables en attente
+  // A appeler avant toute lecture des items fantômes de ces variables
+  void flush(Ref<RunQueue> ref_queue, eVarSyncVersion vs_version=VS_auto);
+
+  //! Affiche les taux de compression des buffers de comms (si compression utilisée)
+  void printBufCompressionStats(ITraceMng* tm) const;
+
+  //! Emule un réseau de latence latency (s) et de débit bandwidth (octets/s, <=0 infini)
+  // Concerne les versions *_evqueue* et *_neighcoll (échanges point à point alors)
+  void setSimulatedNetwork(Real latency, Real bandwidth);
+
+  //! Nb d'appels chronométrés par version candidate pour VS_autotune
+  void setAutoTuneNbTrials(Integer nb_trials);
+
+  //! Réduit l'arène des buffers de comms après nb_calls synchros sous la marque (0 : jamais)
+  void setSyncBufShrinkPolicy(Integer nb_calls);
+
+  //! Echanges point à point par nb_thread threads de progression (un groupe de voisins par thread)
+  // Collectif, nécessite MPI_THREAD_MULTIPLE (sinon sans effet), nb_thread<=0 : désactivé
+  void setNeighProgressThreads(Integer nb_thread);
+
+  /* Statistiques de synchronisation */
+
+  //! Active la collecte des statistiques par appel, voisin et variable
+  // La trace sera écrite dans des fichiers préfixés par prefix
+  void enableSyncStats(eSyncStatsFormat fmt, const String& prefix);
+
+  //! Ecrit la trace des statistiques (si activées) et en affiche un résumé
+  void dumpSyncStats(ITraceMng* tm) const;
+
   // Equivalent à un "var.synchronize()" (implem dépend de vs_version) + plus barrière sur ref_queue
+  // ghost_depth : nb de couches fantômes à synchroniser (<=0 : toutes)
   template<typename MeshVariableRefT>
-  void globalSynchronize(Ref<RunQueue> ref_queue, MeshVariableRefT var, eVarSyncVersion vs_version = VS_auto);
+  void globalSynchronize(Ref<RunQueue> ref_queue, MeshVariableRefT var, eVarSyncVersion vs_version = VS_auto,
+      Integer ghost_depth = 0);
 
   //! Equivalent à un var.synchronize() où var est une variable multi-mat
   template<typename DataType>
@@ -169,6 +217,19 @@ class VarSyncMng {
   // Pré-allocation des buffers de communication pour miniser le nb de réallocations
   void _preAllocBuffers();
 
+  // Synchronise immédiatement les éléments fantômes de vars
+  void _synchronize(MeshVariableSynchronizerList& vars, 
+    Ref<RunQueue> ref_queue, eVarSyncVersion vs_version);
+
+  // Thread de calcul des items intérieurs pour VS_overlap_host (créé au 1er appel)
+  HostWorkerThread* _hostWorker();
+
+  // Vrai si les échanges algo1 passent par les threads de progression par voisin
+  bool _useNeighProgressThreads(bool has_cmp) const {
+    // Compression : buffers de travail communs, réseau simulé : échanges par m_transport
+    return m_vsync_neigh_threads && !has_cmp && !m_vsync_algo1->isSimulatedNetwork();
+  }
+
  protected:
 
   IMesh* m_mesh=nullptr;
@@ -212,6 +273,26 @@ class VarSyncMng {
   VarSyncAlgo1* m_vsync_algo1=nullptr;
   Algo1SyncDataDH::PersistentInfo* m_a1_dh_pi=nullptr;
   Algo1SyncDataD::PersistentInfo* m_a1_d_pi=nullptr;
+  SyncPlanMng* m_sync_plan_mng=nullptr;  //! Plans de comms persistants par signature de liste de variables
+
+  // Pour synchro par collective de voisinage
+  VarSyncNeighColl* m_vsync_neighcoll=nullptr;
+  VarSyncNeighThreads* m_vsync_neigh_threads=nullptr;  //! Non nul si les threads de progression sont actifs
+
+  // Pour le choix de version à l'exécution (VS_autotune)
+  VarSyncTuner* m_vsync_tuner=nullptr;
+
+  // Pour le recouvrement par thread CPU (VS_overlap_host)
+  HostWorkerThread* m_host_worker=nullptr;
+
+  // Pour les statistiques de synchronisation
+  SyncStats* m_sync_stats=nullptr;
+  eSyncStatsFormat m_sync_stats_fmt=SSF_none;
+  String m_sync_stats_prefix;
+
+  // Pour les synchros différées
+  BufAddrMng* m_batch_buf_addr_mng=nullptr;  //! Adresses multi-mat propres au lot
+  MeshVariableSynchronizerList* m_batch_vars=nullptr;  //! Variables en attente de synchronisation
 };
 
 // Implementation template de computeAndSync
@@ -11,7 +11,27 @@ enum eVarSyncVersion {
   VS_bulksync_evqueue_d, // Idem que VS_bulksync_evqueue mais comms avec adresses DEVICE (GPU-aware)
   VS_overlap_evqueue, // Recouvrement items shared+packing/unpacking GPU+comms (en utilisant des events) par calculs itemss private
   VS_overlap_evqueue_d, // Idem que VS_overlap_evqueue mais comms avec adresses DEVICE (GPU-aware)
-  VS_overlap_iqueue // Recouvrement : traitements shared et private concurrents et asynchrones + iGlobalSynchronizeQueue
+  VS_overlap_iqueue, // Recouvrement : traitements shared et private concurrents et asynchrones + iGlobalSynchronizeQueue
+  VS_bulksync_neighcoll, // Idem que VS_bulksync_evqueue mais comms en un seul MPI_Neighbor_alltoallv
+  VS_overlap_neighcoll, // Idem que VS_overlap_evqueue mais comms en un seul MPI_Neighbor_alltoallv
+  VS_autotune, // Version la plus rapide choisie à l'exécution après chronométrage des premiers appels
+  VS_overlap_host // Recouvrement sur CPU : items private calculés par un thread dédié pendant que le thread appelant fait comms + items shared
+};
+
+/*! \brief Définit la compression sans perte des buffers de comms d'une variable
+ */
+enum eBufCompression {
+  BC_none = 0, // Pas de compression
+  BC_rle, // Run-length encoding des octets
+  BC_xor_shuffle_rle // XOR avec la valeur précédente, regroupement des octets de même rang puis RLE
+};
+
+/*! \brief Format de la trace des statistiques de synchronisation
+ */
+enum eSyncStatsFormat {
+  SSF_none = 0, // Pas de statistiques collectées
+  SSF_csv, // Un fichier CSV pour les appels et un pour les variables, par rang
+  SSF_json // Un fichier JSON par rang
 };
 
 #endif
@@ -0,0 +1,159 @@
+#include "msgpass/VarSyncNeighColl.h"
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/NotSupportedException.h>
+#include <arcane/utils/FatalErrorException.h>
+
+#include <limits>
+
+#ifdef MSG_PASS_HAS_MPI
+#include <mpi.h>
+
+/*---------------------------------------------------------------------------*/
+/* Distributed graph communicator and the counts/displacements arrays        */
+/*---------------------------------------------------------------------------*/
+struct VarSyncNeighColl::GraphComm {
+  MPI_Comm m_comm=MPI_COMM_NULL;
+
+  // Allocated once to avoid allocations at each synchronization
+  UniqueArray<int> m_snd_counts;
+  UniqueArray<int> m_snd_displs;
+  UniqueArray<int> m_rcv_counts;
+  UniqueArray<int> m_rcv_displs;
+
+  ~GraphComm() {
+    int is_finalized=0;
+    MPI_Finalized(&is_finalized);
+    if (!is_finalized && m_comm!=MPI_COMM_NULL) {
+      MPI_Comm_free(&m_comm);
+    }
+  }
+};
+#else
+struct VarSyncNeighColl::GraphComm {
+};
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncNeighColl                                                   */
+/* \brief Algorithm to synchronize mesh variables with one neighborhood      */
+/*   collective (MPI_Neighbor_alltoallv)                                     */
+/*---------------------------------------------------------------------------*/
+
+VarSyncNeighColl::VarSyncNeighColl(IParallelMng* pm, Int32ConstArrayView neigh_ranks) :
+  m_pm          (pm),
+  m_neigh_ranks (neigh_ranks)
+{
+  m_nb_nei = m_neigh_ranks.size();
+
+#ifdef MSG_PASS_HAS_MPI
+  // Seule une implémentation "pure MPI" fournit un communicateur
+  // dont les rangs sont ceux de m_pm
+  if (!m_pm->isParallel() || m_pm->isThreadImplementation() || m_pm->isHybridImplementation()) {
+    return;
+  }
+  void* comm_ptr = m_pm->getMPICommunicator();
+  if (!comm_ptr) {
+    return;
+  }
+  MPI_Comm comm = *(static_cast<MPI_Comm*>(comm_ptr));
+
+  m_graph_comm = new GraphComm();
+
+  // Les voisins en émission et en réception sont les mêmes (synchronisations symétriques).
+  // Pas de réordonnancement : le inei-ième voisin du graphe est m_neigh_ranks[inei]
+  UniqueArray<int> ranks(m_nb_nei);
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    ranks[inei] = m_neigh_ranks[inei];
+  }
+  MPI_Dist_graph_create_adjacent(comm,
+      m_nb_nei, ranks.data(), MPI_UNWEIGHTED,
+      m_nb_nei, ranks.data(), MPI_UNWEIGHTED,
+      MPI_INFO_NULL, /*reorder=*/0, &(m_graph_comm->m_comm));
+
+  m_graph_comm->m_snd_counts.resize(m_nb_nei);
+  m_graph_comm->m_snd_displs.resize(m_nb_nei);
+  m_graph_comm->m_rcv_counts.resize(m_nb_nei);
+  m_graph_comm->m_rcv_displs.resize(m_nb_nei);
+#endif
+}
+
+VarSyncNeighColl::~VarSyncNeighColl() {
+  delete m_graph_comm;
+}
+
+/*---------------------------------------------------------------------------*/
+/* True if the neighborhood collective can be used                           */
+/*---------------------------------------------------------------------------*/
+bool VarSyncNeighColl::isAvailable() const {
+  return m_graph_comm!=nullptr;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Synchronize variables encapsulated into sync_data                         */
+/* Unlike VarSyncAlgo1, all the ranks must call it, even without neighbour   */
+/*---------------------------------------------------------------------------*/
+void VarSyncNeighColl::synchronize([[maybe_unused]] IAlgo1SyncData* sync_data)
+{
+#ifdef MSG_PASS_HAS_MPI
+  if (!m_graph_comm) {
+    throw NotSupportedException(A_FUNCINFO, "No distributed graph communicator");
+  }
+
+  // La liste des variables est la même sur tous les rangs
+  if (sync_data->isEmpty()) {
+    sync_data->finalizeWoComm();
+    return;
+  }
+
+  // Step before the first communications
+  sync_data->initComm();
+
+  // Packing de tous les buffers d'envoi
+  sync_data->initSendings();
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    sync_data->finalizePackBeforeSend(inei);
+  }
+  sync_data->finalizeSendings();
+
+  // Les buffers des voisins sont contigus (aux trous d'alignement près),
+  // on les repère par rapport au buffer du premier voisin
+  Byte* snd_base = nullptr;
+  Byte* rcv_base = nullptr;
+  if (m_nb_nei>0) {
+    snd_base = sync_data->sendBuf(0).data();
+    rcv_base = sync_data->recvBuf(0).data();
+  }
+  auto& gc = *m_graph_comm;
+  constexpr Int64 max_int = std::numeric_limits<int>::max();
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    auto byte_buf_snd = sync_data->sendBuf(inei);
+    auto byte_buf_rcv = sync_data->recvBuf(inei);
+    Int64 snd_displ = byte_buf_snd.data()-snd_base;
+    Int64 rcv_displ = byte_buf_rcv.data()-rcv_base;
+    if (snd_displ<0 || rcv_displ<0 || 
+        snd_displ+byte_buf_snd.size()>max_int || rcv_displ+byte_buf_rcv.size()>max_int) {
+      throw NotSupportedException(A_FUNCINFO, 
+          "Buffers non representables par des deplacements int pour MPI_Neighbor_alltoallv");
+    }
+    gc.m_snd_counts[inei] = byte_buf_snd.size();
+    gc.m_snd_displs[inei] = static_cast<int>(snd_displ);
+    gc.m_rcv_counts[inei] = byte_buf_rcv.size();
+    gc.m_rcv_displs[inei] = static_cast<int>(rcv_displ);
+  }
+
+  // Un seul échange pour tous les voisins, la bibliothèque MPI ordonnance les transferts
+  MPI_Neighbor_alltoallv(
+      snd_base, gc.m_snd_counts.data(), gc.m_snd_displs.data(), MPI_BYTE,
+      rcv_base, gc.m_rcv_counts.data(), gc.m_rcv_displs.data(), MPI_BYTE,
+      gc.m_comm);
+
+  for(Integer inei=0 ; inei<m_nb_nei ; ++inei) {
+    sync_data->unpackAfterRecv(inei);
+  }
+
+  sync_data->finalizeReceipts();
+#else
+  throw NotSupportedException(A_FUNCINFO, "MPI_Neighbor_alltoallv needs MPI");
+#endif
+}
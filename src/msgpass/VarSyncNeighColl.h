@@ -0,0 +1,39 @@
+#ifndef MSG_PASS_VAR_SYNC_NEIGH_COLL_H
+#define MSG_PASS_VAR_SYNC_NEIGH_COLL_H
+
+#include "msgpass/IAlgo1SyncData.h"
+
+#include <arcane/IParallelMng.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncNeighColl                                                   */
+/* \brief Algorithm to synchronize mesh variables with one neighborhood      */
+/*   collective (MPI_Neighbor_alltoallv) on a distributed graph communicator */
+/*                                                                           */
+/* The graph communicator is built once from the neighbour ranks.            */
+/* Without MPI (or with a Thread/hybrid IParallelMng), isAvailable() returns */
+/* false and VarSyncAlgo1 must be used instead.                              */
+/*---------------------------------------------------------------------------*/
+class VarSyncNeighColl {
+ public:
+  //! Collective on all the ranks of pm
+  VarSyncNeighColl(IParallelMng* pm, Int32ConstArrayView neigh_ranks);
+  virtual ~VarSyncNeighColl();
+
+  //! True if the neighborhood collective can be used
+  bool isAvailable() const;
+
+  //! Synchronize variables encapsulated into sync_data (collective on all the ranks)
+  void synchronize(IAlgo1SyncData* sync_data);
+
+ protected:
+  struct GraphComm;  // defined where MPI is known
+
+  IParallelMng* m_pm=nullptr;
+  Int32ConstArrayView m_neigh_ranks;  //! List of neighbour ranks
+  Integer m_nb_nei;  //! Number of neighbours (m_neigh_ranks.size())
+
+  GraphComm* m_graph_comm=nullptr;  //! nullptr if not available
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "msgpass/VarSyncNeighThreads.h"
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/PlatformUtils.h>
+#include <arcane/utils/NotSupportedException.h>
+#include <arccore/base/FatalErrorException.h>
+
+#include <algorithm>
+
+// Définie dans MsgPassInit.cc
+bool is_mpi_thread_multiple();
+
+#ifdef MSG_PASS_HAS_MPI
+#include <mpi.h>
+
+/*---------------------------------------------------------------------------*/
+/* Communicator dedicated to the progress threads and their requests         */
+/*---------------------------------------------------------------------------*/
+struct VarSyncNeighThreads::ThreadComm {
+  static constexpr int TAG_NEIGH_THREADS = 0;  //! Seuls ces échanges passent par m_comm
+
+  MPI_Comm m_comm=MPI_COMM_NULL;
+
+  // Par thread : [0,nb[ réceptions, [nb,2*nb[ envois (nb voisins du thread)
+  // Alloués une fois pour éviter des allocations à chaque synchronisation
+  UniqueArray<UniqueArray<MPI_Request>> m_requests;
+
+  ~ThreadComm() {
+    int is_finalized=0;
+    MPI_Finalized(&is_finalized);
+    if (!is_finalized && m_comm!=MPI_COMM_NULL) {
+      MPI_Comm_free(&m_comm);
+    }
+  }
+};
+#else
+struct VarSyncNeighThreads::ThreadComm {
+};
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncNeighThreads                                                */
+/* \brief Algorithm to synchronize mesh variables with one host progress     */
+/*   thread per group of neighbours                                          */
+/*---------------------------------------------------------------------------*/
+
+VarSyncNeighThreads::VarSyncNeighThreads(IParallelMng* pm, Int32ConstArrayView neigh_ranks,
+    MultiAsyncRunQueue* neigh_queues, [[maybe_unused]] Integer nb_thread) :
+  m_pm           (pm),
+  m_neigh_ranks  (neigh_ranks),
+  m_neigh_queues (neigh_queues)
+{
+  m_nb_nei = m_neigh_ranks.size();
+
+#ifdef MSG_PASS_HAS_MPI
+  // Seule une implémentation "pure MPI" fournit un communicateur
+  // dont les rangs sont ceux de m_pm
+  if (!m_pm->isParallel() || m_pm->isThreadImplementation() || m_pm->isHybridImplementation()) {
+    return;
+  }
+  void* comm_ptr = m_pm->getMPICommunicator();
+  if (!comm_ptr) {
+    return;
+  }
+  // Le niveau est le même sur tous les rangs, MPI_Comm_dup est donc appelé par tous ou aucun
+  if (!is_mpi_thread_multiple()) {
+    return;
+  }
+  MPI_Comm comm = *(static_cast<MPI_Comm*>(comm_ptr));
+
+  m_thread_comm = new ThreadComm();
+  // Communicateur dédié : pas de mélange avec les messages d'Arcane
+  MPI_Comm_dup(comm, &(m_thread_comm->m_comm));
+
+  // Le voisin inei est traité par le thread inei%nb_thread sur la queue inei
+  nb_thread = std::max(1, std::min(nb_thread, m_nb_nei));
+  m_thread_comm->m_requests.resize(nb_thread);
+  for(Integer ithread=0 ; ithread<nb_thread ; ++ithread) {
+    Integer nb = (m_nb_nei-ithread+nb_thread-1)/nb_thread;  // nb de voisins du thread
+    m_thread_comm->m_requests[ithread].resize(2*nb);
+    m_thread_comm->m_requests[ithread].fill(MPI_REQUEST_NULL);
+    m_threads.add(new HostWorkerThread());
+  }
+  m_wait_times.resize(nb_thread);
+  m_nb_waits.resize(nb_thread);
+#endif
+}
+
+VarSyncNeighThreads::~VarSyncNeighThreads() {
+  for(auto th : m_threads) {
+    delete th;
+  }
+  delete m_thread_comm;
+}
+
+/*---------------------------------------------------------------------------*/
+/* True if the progress threads can be used                                  */
+/*---------------------------------------------------------------------------*/
+bool VarSyncNeighThreads::isAvailable() const {
+  return m_thread_comm!=nullptr && !m_threads.empty();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Synchronize variables encapsulated into sync_data                         */
+/* The calling thread only initializes and finalizes, the exchanges are made */
+/* by the progress threads                                                   */
+/*---------------------------------------------------------------------------*/
+void VarSyncNeighThreads::synchronize(IAlgo1SyncData* sync_data)
+{
+  if (!isAvailable()) {
+    throw NotSupportedException(A_FUNCINFO, "No progress thread (MPI_THREAD_MULTIPLE needed)");
+  }
+
+  if (m_nb_nei==0 || sync_data->isEmpty()) {
+    sync_data->finalizeWoComm();
+    return;
+  }
+
+  // Step before the first communications
+  sync_data->initComm();
+  if (m_stats) {
+    m_stats->beginPack();
+  }
+
+  Integer nb_thread = nbThread();
+  for(Integer ithread=0 ; ithread<nb_thread ; ++ithread) {
+    m_threads[ithread]->post([this, ithread, sync_data]() {
+      _progressNeighs(ithread, sync_data);
+    });
+  }
+
+  // On attend tous les threads avant de propager une éventuelle exception
+  std::exception_ptr exception;
+  for(Integer ithread=0 ; ithread<nb_thread ; ++ithread) {
+    try {
+      m_threads[ithread]->wait();
+    } catch(...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+
+  if (m_stats) {
+    // Les threads attendent en même temps : on retient le plus long
+    Real max_wait = 0;
+    Integer nb_wait = 0;
+    for(Integer ithread=0 ; ithread<nb_thread ; ++ithread) {
+      max_wait = std::max(max_wait, m_wait_times[ithread]);
+      nb_wait += m_nb_waits[ithread];
+    }
+    m_stats->addWaitTime(max_wait, nb_wait);
+  }
+
+  sync_data->finalizeReceipts();
+}
+
+/*---------------------------------------------------------------------------*/
+/* Exchanges of the neighbours inei = ithread + k*nbThread()                 */
+/* Executed by the progress thread ithread                                   */
+/*---------------------------------------------------------------------------*/
+void VarSyncNeighThreads::_progressNeighs([[maybe_unused]] Integer ithread,
+    [[maybe_unused]] IAlgo1SyncData* sync_data)
+{
+#ifdef MSG_PASS_HAS_MPI
+  Integer nb_thread = nbThread();
+  MPI_Comm comm = m_thread_comm->m_comm;
+  auto& requests = m_thread_comm->m_requests[ithread];
+  int nb = requests.size()/2;  // nb de voisins du thread
+  m_wait_times[ithread] = 0;
+  m_nb_waits[ithread] = 0;
+
+  // On amorce les réceptions
+  for(int k=0 ; k<nb ; ++k) {
+    Integer inei = ithread+k*nb_thread;
+    auto byte_buf_rcv = sync_data->recvBuf(inei); // le buffer de réception pour inei
+    MPI_Irecv(byte_buf_rcv.data(), byte_buf_rcv.size(), MPI_BYTE,
+        m_neigh_ranks[inei], ThreadComm::TAG_NEIGH_THREADS, comm, &(requests[k]));
+    if (m_stats) {
+      m_stats->addRecv(inei, byte_buf_rcv.size());
+    }
+  }
+
+  // Packing sur la queue du voisin puis envoi, voisin par voisin
+  for(int k=0 ; k<nb ; ++k) {
+    Integer inei = ithread+k*nb_thread;
+    sync_data->packNeigh(inei, m_neigh_queues->queue(inei));
+
+    auto byte_buf_snd = sync_data->sendBuf(inei); // le buffer d'envoi pour inei
+    MPI_Isend(byte_buf_snd.data(), byte_buf_snd.size(), MPI_BYTE,
+        m_neigh_ranks[inei], ThreadComm::TAG_NEIGH_THREADS, comm, &(requests[nb+k]));
+    if (m_stats) {
+      m_stats->addSent(inei, byte_buf_snd.size());
+    }
+  }
+
+  // Unpacking dès qu'un message de l'un des voisins du thread est arrivé
+  for(int nb_pending_rcv=nb ; nb_pending_rcv>0 ; --nb_pending_rcv) {
+    int k = MPI_UNDEFINED;
+    Real wait_beg = platform::getRealTime();
+    MPI_Waitany(nb, requests.data(), &k, MPI_STATUS_IGNORE);
+    m_wait_times[ithread] += platform::getRealTime()-wait_beg;
+    m_nb_waits[ithread]++;
+    if (k==MPI_UNDEFINED) {
+      throw FatalErrorException(A_FUNCINFO, "Plus de requete active alors que des receptions sont attendues");
+    }
+    Integer inei = ithread+k*nb_thread;
+    sync_data->unpackNeigh(inei, m_neigh_queues->queue(inei));
+  }
+
+  // Il peut rester des envois en cours
+  Real wait_beg = platform::getRealTime();
+  MPI_Waitall(nb, requests.data()+nb, MPI_STATUSES_IGNORE);
+  m_wait_times[ithread] += platform::getRealTime()-wait_beg;
+#endif
+}
+
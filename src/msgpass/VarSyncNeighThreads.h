@@ -0,0 +1,62 @@
+#ifndef MSG_PASS_VAR_SYNC_NEIGH_THREADS_H
+#define MSG_PASS_VAR_SYNC_NEIGH_THREADS_H
+
+#include "accenv/AcceleratorUtils.h"
+#include "msgpass/IAlgo1SyncData.h"
+#include "msgpass/HostWorkerThread.h"
+#include "msgpass/SyncStats.h"
+
+#include <arcane/IParallelMng.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncNeighThreads                                                */
+/* \brief Algorithm to synchronize mesh variables with one host progress     */
+/*   thread per group of neighbours                                          */
+/*                                                                           */
+/* Each thread packs, sends, waits for and unpacks the messages of its       */
+/* neighbours on their own queues (neigh_queues), independently of the       */
+/* other threads : a slow neighbour does not delay the unpacking of the      */
+/* fast ones. Needs MPI initialized with MPI_THREAD_MULTIPLE and a "pure     */
+/* MPI" IParallelMng, otherwise isAvailable() returns false and VarSyncAlgo1 */
+/* must be used instead.                                                     */
+/*---------------------------------------------------------------------------*/
+class VarSyncNeighThreads {
+ public:
+  //! Collective on all the ranks of pm (the communicator is duplicated)
+  VarSyncNeighThreads(IParallelMng* pm, Int32ConstArrayView neigh_ranks,
+      MultiAsyncRunQueue* neigh_queues, Integer nb_thread);
+  virtual ~VarSyncNeighThreads();
+
+  //! True if the progress threads can be used
+  bool isAvailable() const;
+
+  //! Number of progress threads (neighbour inei is handled by the thread inei%nbThread())
+  Integer nbThread() const { return m_threads.size(); }
+
+  //! If not null, the sizes and wait times are recorded into stats
+  void setSyncStats(SyncStats* stats) { m_stats = stats; }
+
+  //! Synchronize variables encapsulated into sync_data
+  void synchronize(IAlgo1SyncData* sync_data);
+
+ protected:
+  //! Exchanges of the neighbours of the thread ithread (executed by this thread)
+  void _progressNeighs(Integer ithread, IAlgo1SyncData* sync_data);
+
+ protected:
+  struct ThreadComm;  // defined where MPI is known
+
+  IParallelMng* m_pm=nullptr;
+  Int32ConstArrayView m_neigh_ranks;  //! List of neighbour ranks
+  Integer m_nb_nei;  //! Number of neighbours (m_neigh_ranks.size())
+  MultiAsyncRunQueue* m_neigh_queues=nullptr;  //! One queue per neighbour (not owned)
+  SyncStats* m_stats=nullptr;  //! Statistics (not owned)
+
+  ThreadComm* m_thread_comm=nullptr;  //! nullptr if not available
+  UniqueArray<HostWorkerThread*> m_threads;  //! Progress threads
+  UniqueArray<Real> m_wait_times;  //! Wait time of each thread during the last synchronization
+  UniqueArray<Integer> m_nb_waits;  //! Number of waits of each thread during the last synchronization
+};
+
+#endif
+
@@ -0,0 +1,159 @@
+#include "msgpass/VarSyncTuner.h"
+
+#include <arcane/utils/PlatformUtils.h>
+#include <arcane/utils/FatalErrorException.h>
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncTuner                                                       */
+/* \brief Run-time selection of the fastest eVarSyncVersion (VS_autotune)    */
+/*---------------------------------------------------------------------------*/
+
+VarSyncTuner::VarSyncTuner(IParallelMng* pm, ITraceMng* tm,
+    bool is_device_aware, bool has_neighcoll) :
+  m_pm              (pm),
+  m_tm              (tm),
+  m_is_device_aware (is_device_aware),
+  m_has_neighcoll   (has_neighcoll)
+{
+}
+
+VarSyncTuner::~VarSyncTuner() {
+}
+
+/*---------------------------------------------------------------------------*/
+/* Number of timed calls per candidate (after the warm-up round)             */
+/*---------------------------------------------------------------------------*/
+void VarSyncTuner::setNbTrials(Integer nb_trials) {
+  if (nb_trials<1) {
+    throw FatalErrorException(A_FUNCINFO, "Il faut au moins un essai par version");
+  }
+  m_nb_trials = nb_trials;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Choose the version to use for the synchronization of vars by op_kind      */
+/*---------------------------------------------------------------------------*/
+VarSyncTuner::Trial VarSyncTuner::beginTrial(ConstArrayView<IMeshVarSync*> vars,
+    eOpKind op_kind) {
+
+  // Hachage FNV-1a des noms des variables : identique sur tous les rangs
+  UInt64 uhash = 14695981039346656037ULL;
+  auto hash_val = [&uhash](UInt64 v) {
+    uhash ^= v;
+    uhash *= 1099511628211ULL;
+  };
+  hash_val(op_kind);
+  for(auto var : vars) {
+    String name = var->name();
+    for(const char* c = name.localstr() ; *c ; ++c) {
+      hash_val(static_cast<unsigned char>(*c));
+    }
+    hash_val(0);  // séparateur entre deux noms
+  }
+
+  Trial trial;
+  trial.m_key = static_cast<Int64>(uhash);
+
+  auto iter = m_entries.find(trial.m_key);
+  if (iter==m_entries.end()) {
+    Entry entry;
+    _fillCandidates(op_kind, entry.m_cands);
+    entry.m_sum_times.resize(entry.m_cands.size());
+    entry.m_sum_times.fill(0.);
+    for(auto var : vars) {
+      entry.m_desc = entry.m_desc + " " + var->name();
+    }
+    iter = m_entries.emplace(trial.m_key, entry).first;
+  }
+  Entry& entry = iter->second;
+
+  if (entry.m_best != VS_auto) {
+    // Choix déjà fait, pas de chronométrage
+    trial.m_version = entry.m_best;
+    return trial;
+  }
+
+  // Candidates à tour de rôle, le premier tour n'est pas chronométré
+  Integer nb_cand = entry.m_cands.size();
+  Integer icand = entry.m_nb_call % nb_cand;
+  Integer iround = entry.m_nb_call / nb_cand;
+  trial.m_version = entry.m_cands[icand];
+  trial.m_icand = (iround>0 ? icand : -1);
+  entry.m_nb_call++;
+
+  trial.m_beg = platform::getRealTime();
+  return trial;
+}
+
+/*---------------------------------------------------------------------------*/
+/* End of the call begun by beginTrial                                       */
+/*---------------------------------------------------------------------------*/
+void VarSyncTuner::endTrial(const Trial& trial) {
+  auto iter = m_entries.find(trial.m_key);
+  if (iter==m_entries.end() || iter->second.m_best != VS_auto) {
+    return;
+  }
+  Entry& entry = iter->second;
+  if (trial.m_icand>=0) {
+    entry.m_sum_times[trial.m_icand] += platform::getRealTime()-trial.m_beg;
+  }
+  if (entry.m_nb_call == entry.m_cands.size()*(m_nb_trials+1)) {
+    _decide(entry);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Candidates for op_kind                                                    */
+/*---------------------------------------------------------------------------*/
+void VarSyncTuner::_fillCandidates(eOpKind op_kind,
+    UniqueArray<eVarSyncVersion>& cands) const {
+  // VS_overlap_iqueue n'est pas implémentée, elle n'est pas candidate
+  cands.add(VS_bulksync_std);
+  cands.add(VS_bulksync_evqueue);
+  if (m_is_device_aware) {
+    cands.add(VS_bulksync_evqueue_d);
+  }
+  if (m_has_neighcoll) {
+    cands.add(VS_bulksync_neighcoll);
+  }
+  if (op_kind != OK_sync) {
+    // Recouvrement calculs/comms possible
+    cands.add(VS_overlap_evqueue);
+    if (m_is_device_aware) {
+      cands.add(VS_overlap_evqueue_d);
+    }
+    if (m_has_neighcoll) {
+      cands.add(VS_overlap_neighcoll);
+    }
+    // Recouvrement par un thread CPU, disponible partout
+    cands.add(VS_overlap_host);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/* Choose the best candidate of entry (collective)                           */
+/*---------------------------------------------------------------------------*/
+void VarSyncTuner::_decide(Entry& entry) {
+  Integer nb_cand = entry.m_cands.size();
+  UniqueArray<Real> max_times(nb_cand);
+  for(Integer icand=0 ; icand<nb_cand ; ++icand) {
+    max_times[icand] = entry.m_sum_times[icand]/m_nb_trials;
+  }
+  // Le temps d'une version est celui du rang le plus lent
+  m_pm->reduce(Parallel::ReduceMax, max_times.view());
+
+  Integer ibest = 0;
+  for(Integer icand=1 ; icand<nb_cand ; ++icand) {
+    if (max_times[icand]<max_times[ibest]) {
+      ibest = icand;
+    }
+  }
+  entry.m_best = entry.m_cands[ibest];
+
+  m_tm->info() << "VarSyncTuner :" << entry.m_desc << " => eVarSyncVersion=" << (int)entry.m_best
+    << " (" << max_times[ibest] << " s, max sur les rangs)";
+  for(Integer icand=0 ; icand<nb_cand ; ++icand) {
+    m_tm->debug() << "  eVarSyncVersion=" << (int)entry.m_cands[icand] << " : " << max_times[icand] << " s";
+  }
+}
+
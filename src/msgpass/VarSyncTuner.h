@@ -0,0 +1,82 @@
+#ifndef MSG_PASS_VAR_SYNC_TUNER_H
+#define MSG_PASS_VAR_SYNC_TUNER_H
+
+#include "msgpass/MeshVariableSynchronizerList.h"
+#include "msgpass/VarSyncMngOptions.h"
+
+#include <arcane/IParallelMng.h>
+#include <arcane/utils/ITraceMng.h>
+
+#include <map>
+
+/*---------------------------------------------------------------------------*/
+/* \class VarSyncTuner                                                       */
+/* \brief Run-time selection of the fastest eVarSyncVersion (VS_autotune)    */
+/*                                                                           */
+/* For a given list of variables and a given kind of operation, the first    */
+/* calls use the candidate versions in turn (round-robin). The first round   */
+/* is a warm-up and is not timed, then each candidate is timed nb_trials     */
+/* times. The mean times are max-reduced over all ranks and the version with */
+/* the lowest max time is used for all the next calls.                       */
+/* The key only depends on the variable names so that all ranks take the    */
+/* decision (collective) at the same call.                                   */
+/*---------------------------------------------------------------------------*/
+class VarSyncTuner {
+ public:
+  //! Kind of operation to tune (the candidates are not the same)
+  enum eOpKind {
+    OK_sync = 0,  //! synchronize : bulk-synchronous versions only
+    OK_compute_and_sync,  //! computeAndSync[OnEvents]
+    OK_sync_and_compute,  //! syncAndCompute[OnEvents]
+    OK_enumerate_env_and_sync  //! enumerateEnvAndSync[OnEvents]
+  };
+
+  //! One timed (or not) call
+  struct Trial {
+    Int64 m_key=0;
+    Integer m_icand=-1;  //! Index of the timed candidate, <0 if not timed
+    eVarSyncVersion m_version=VS_auto;  //! Version to use for this call
+    Real m_beg=0;
+  };
+
+ public:
+  VarSyncTuner(IParallelMng* pm, ITraceMng* tm,
+      bool is_device_aware, bool has_neighcoll);
+  virtual ~VarSyncTuner();
+
+  //! Number of timed calls per candidate (after the warm-up round)
+  void setNbTrials(Integer nb_trials);
+
+  //! Choose the version to use for the synchronization of vars by op_kind
+  Trial beginTrial(ConstArrayView<IMeshVarSync*> vars, eOpKind op_kind);
+
+  //! End of the call begun by beginTrial (collective when the choice is taken)
+  void endTrial(const Trial& trial);
+
+ protected:
+  struct Entry {
+    String m_desc;  //! For the listings
+    UniqueArray<eVarSyncVersion> m_cands;
+    UniqueArray<Real> m_sum_times;
+    Integer m_nb_call=0;
+    eVarSyncVersion m_best=VS_auto;  //! VS_auto until the choice is taken
+  };
+
+  //! Candidates for op_kind
+  void _fillCandidates(eOpKind op_kind, UniqueArray<eVarSyncVersion>& cands) const;
+
+  //! Choose the best candidate of entry (collective)
+  void _decide(Entry& entry);
+
+ protected:
+  IParallelMng* m_pm=nullptr;
+  ITraceMng* m_tm=nullptr;
+  bool m_is_device_aware=false;
+  bool m_has_neighcoll=false;
+  Integer m_nb_trials=5;
+
+  std::map<Int64, Entry> m_entries;
+};
+
+#endif
+